@@ -12,8 +12,13 @@ declare -rx VERBOSE=1
 
 declare -r HAL_DISABLE_TESTS="OFF"
 
+# The tests assert on the retain and release counts, which are only
+# kept when the performance counters are compiled in.
+declare -r HAL_PERFORMANCE_COUNTER_ENABLE="ON"
+
 cmd+="cmake"
 cmd+=" -DHAL_DISABLE_TESTS=${HAL_DISABLE_TESTS}"
+cmd+=" -DHAL_PERFORMANCE_COUNTER_ENABLE=${HAL_PERFORMANCE_COUNTER_ENABLE}"
 
 declare -r CMAKE_HOST_WIN32=$(cmake -P cmake/IsWin32.cmake 2>&1 | tr -d '\r\n')
 
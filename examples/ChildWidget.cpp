@@ -33,8 +33,10 @@ void ChildWidget::JSExportInitialize() {
   JSExport<ChildWidget>::SetClassVersion(1);
   JSExport<ChildWidget>::SetParent(JSExport<Widget>::Class());
   JSExport<ChildWidget>::AddValueProperty("name", std::mem_fn(&ChildWidget::js_get_name));
-  JSExport<ChildWidget>::AddValueProperty("my_name", std::mem_fn(&ChildWidget::js_get_my_name));
+  JSExport<ChildWidget>::AddValueProperty("my_name", HAL_EXPORT_METHOD(&ChildWidget::js_get_my_name), HAL_EXPORT_METHOD(&ChildWidget::js_set_my_name));
   JSExport<ChildWidget>::AddConstantProperty("pi"  , std::mem_fn(&ChildWidget::js_get_pi));
+  JSExport<ChildWidget>::AddValueProperty("scale_factor", HAL_EXPORT_METHOD(&ChildWidget::js_get_scale_factor), HAL_EXPORT_METHOD(&ChildWidget::js_set_scale_factor));
+  JSExport<ChildWidget>::AddFunctionProperty("scale", HAL_EXPORT_METHOD(&ChildWidget::js_scale));
 }
 
 JSValue ChildWidget::js_get_name() const HAL_NOEXCEPT {
@@ -43,10 +45,32 @@ JSValue ChildWidget::js_get_name() const HAL_NOEXCEPT {
 }
 
 JSValue ChildWidget::js_get_my_name() const HAL_NOEXCEPT {
-  return get_context().CreateString("child widget");
+  return get_context().CreateString(my_name__);
+}
+
+bool ChildWidget::js_set_my_name(const JSLocal& value) HAL_NOEXCEPT {
+  bool result = false;
+  if (value.IsString()) {
+    my_name__ = static_cast<std::string>(value);
+    result = true;
+  }
+  return result;
 }
 
 JSValue ChildWidget::js_get_pi() HAL_NOEXCEPT {
   count_for_child_pi__++;
   return get_context().CreateString("hello pi");
 }
+
+double ChildWidget::js_get_scale_factor() const HAL_NOEXCEPT {
+  return scale_factor__;
+}
+
+void ChildWidget::js_set_scale_factor(double scale_factor) HAL_NOEXCEPT {
+  scale_factor__ = scale_factor;
+}
+
+double ChildWidget::js_scale(double value, int32_t steps, const std::string& unit) const HAL_NOEXCEPT {
+  const double result = value * scale_factor__ * steps;
+  return unit == "%" ? result / 100 : result;
+}
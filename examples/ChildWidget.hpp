@@ -35,13 +35,20 @@ public:
   
   JSValue js_get_name() const HAL_NOEXCEPT;
   JSValue js_get_my_name() const HAL_NOEXCEPT;
+  bool    js_set_my_name(const JSLocal& value) HAL_NOEXCEPT;
   JSValue js_get_pi() HAL_NOEXCEPT;
   
+  double js_get_scale_factor() const HAL_NOEXCEPT;
+  void   js_set_scale_factor(double scale_factor) HAL_NOEXCEPT;
+  double js_scale(double value, int32_t steps, const std::string& unit) const HAL_NOEXCEPT;
+  
   std::uint32_t get_count_for_child_pi() {
     return count_for_child_pi__;
   }
 private:
   std::uint32_t count_for_child_pi__ { 0 };
+  std::string   my_name__ { "child widget" };
+  double        scale_factor__ { 1 };
 };
 
 inline
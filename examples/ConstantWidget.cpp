@@ -0,0 +1,38 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "ConstantWidget.hpp"
+
+std::uint32_t ConstantWidget::count_for_constants__ = 0;
+
+ConstantWidget::ConstantWidget(const JSContext& js_context) HAL_NOEXCEPT
+: JSExportObject(js_context) {
+  HAL_LOG_DEBUG("ConstantWidget:: ctor ", this);
+}
+
+ConstantWidget::~ConstantWidget() HAL_NOEXCEPT {
+  HAL_LOG_DEBUG("ConstantWidget:: dtor ", this);
+}
+
+void ConstantWidget::JSExportInitialize() {
+  JSExport<ConstantWidget>::SetClassVersion(1);
+  JSExport<ConstantWidget>::SetParent(JSExport<JSExportObject>::Class());
+  JSExport<ConstantWidget>::SetConstantsInPrototype(true);
+  JSExport<ConstantWidget>::AddConstantProperty("ANSWER", std::mem_fn(&ConstantWidget::js_get_ANSWER));
+  JSExport<ConstantWidget>::AddConstantProperty("NAME"  , std::mem_fn(&ConstantWidget::js_get_NAME), false);
+}
+
+JSValue ConstantWidget::js_get_ANSWER() HAL_NOEXCEPT {
+  count_for_constants__++;
+  return get_context().CreateNumber(42);
+}
+
+JSValue ConstantWidget::js_get_NAME() HAL_NOEXCEPT {
+  count_for_constants__++;
+  return get_context().CreateString("constant widget");
+}
@@ -0,0 +1,65 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_EXAMPLES_CONSTANTWIDGET_HPP_
+#define _HAL_EXAMPLES_CONSTANTWIDGET_HPP_
+
+#include "HAL/HAL.hpp"
+#include <cstdint>
+
+using namespace HAL;
+
+/*!
+ @class
+ 
+ @discussion This is an example of a JavaScript object whose constant
+ properties are installed on its prototype.
+ */
+class ConstantWidget : public JSExportObject, public JSExport<ConstantWidget> {
+  
+public:
+  
+  /*!
+   @method
+   
+   @abstract This is the constructor used by JSContext::CreateObject
+   to create a ConstantWidget instance and add it to a JavaScript
+   execution context.
+   
+   @param js_context The JavaScriptCore execution context that your
+   JavaScript object will execute in.
+   */
+  ConstantWidget(const JSContext& js_context) HAL_NOEXCEPT;
+  
+  virtual ~ConstantWidget() HAL_NOEXCEPT;
+  
+  /*!
+   @method
+   
+   @abstract Define how your JavaScript objects appear to
+   JavaScriptCore.
+   
+   @discussion HAL will call this function exactly once
+   just before your first JavaScript object is created.
+   */
+  static void JSExportInitialize();
+  
+  JSValue js_get_ANSWER() HAL_NOEXCEPT;
+  JSValue js_get_NAME()   HAL_NOEXCEPT;
+  
+  // The number of times any constant was read from native code.
+  static std::uint32_t get_count_for_constants() {
+    return count_for_constants__;
+  }
+  
+private:
+  
+  static std::uint32_t count_for_constants__;
+};
+
+#endif // _HAL_EXAMPLES_CONSTANTWIDGET_HPP_
@@ -219,12 +219,13 @@ void Widget::JSExportInitialize() {
   JSExport<Widget>::AddFunctionProperty("testMemberNullProperty", std::mem_fn(&Widget::js_testMemberNullProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberUndefinedProperty", std::mem_fn(&Widget::js_testMemberUndefinedProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberBooleanProperty", std::mem_fn(&Widget::js_testMemberBooleanProperty));
-  JSExport<Widget>::AddFunctionProperty("testMemberNumberProperty", std::mem_fn(&Widget::js_testMemberNumberProperty));
+  JSExport<Widget>::AddFunctionProperty("testMemberNumberProperty", HAL_EXPORT_METHOD(&Widget::js_testMemberNumberProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberStringProperty", std::mem_fn(&Widget::js_testMemberStringProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberDateProperty", std::mem_fn(&Widget::js_testMemberDateProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberErrorProperty", std::mem_fn(&Widget::js_testMemberErrorProperty));
   JSExport<Widget>::AddFunctionProperty("testMemberRegExpProperty", std::mem_fn(&Widget::js_testMemberRegExpProperty));
   JSExport<Widget>::AddFunctionProperty("testCallAsFunction", std::mem_fn(&Widget::js_testCallAsFunction));
+  JSExport<Widget>::AddFunctionProperty("testArguments", HAL_EXPORT_METHOD(&Widget::js_testArguments));
   JSExport<Widget>::AddFunctionProperty("testException", std::mem_fn(&Widget::js_testException));
   JSExport<Widget>::AddFunctionProperty("testNestedException", std::mem_fn(&Widget::js_testNestedException));
 }
@@ -344,10 +345,16 @@ JSValue Widget::js_testCallAsFunction(const std::vector<JSValue>& arguments, JSO
   return this_object.get_context().CreateString(testCallAsFunction(this_object));
 }
 
-JSValue Widget::js_sayHello(const std::vector<JSValue>& arguments, JSObject& this_object) {
+JSValue Widget::js_sayHello(const JSArguments& arguments, JSObject& this_object) {
   return this_object.get_context().CreateString(sayHello());
 }
 
+JSValue Widget::js_testArguments(const JSArguments& arguments, JSObject& this_object) {
+  std::ostringstream os;
+  os << arguments.size() << ":" << arguments.GetString(0, "none") << ":" << arguments.GetInt32(1, 42) << ":" << std::boolalpha << arguments.GetBoolean(2, true);
+  return this_object.get_context().CreateString(os.str());
+}
+
 JSValue Widget::js_testException(const std::vector<JSValue>& arguments, JSObject& this_object) {
   const auto js_context = this_object.get_context();
   return js_context.JSEvaluateScript("}@!]}", js_context.get_global_object(), "app.js", 123);
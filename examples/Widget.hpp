@@ -92,7 +92,7 @@ public:
   JSValue js_get_value() const                HAL_NOEXCEPT;
   bool    js_set_value(const JSValue& value) HAL_NOEXCEPT;
   
-  JSValue js_sayHello(const std::vector<JSValue>& arguments, JSObject& this_object);
+  JSValue js_sayHello(const JSArguments& arguments, JSObject& this_object);
   JSValue js_sayHelloWithCallback(const std::vector<JSValue>& arguments, JSObject& this_object);
   JSValue js_helloLambda(const std::vector<JSValue>& arguments, JSObject& this_object);
   
@@ -104,6 +104,7 @@ public:
   JSValue js_testMemberNumberProperty(const std::vector<JSValue>& arguments, JSObject& this_object);
   JSValue js_testMemberStringProperty(const std::vector<JSValue>& arguments, JSObject& this_object);
   JSValue js_testCallAsFunction(const std::vector<JSValue>& arguments, JSObject& this_object);
+  JSValue js_testArguments(const JSArguments& arguments, JSObject& this_object);
   JSValue js_testMemberDateProperty(const std::vector<JSValue>& arguments, JSObject& this_object);
   JSValue js_testMemberErrorProperty(const std::vector<JSValue>& arguments, JSObject& this_object);
   JSValue js_testMemberRegExpProperty(const std::vector<JSValue>& arguments, JSObject& this_object);
@@ -17,12 +17,19 @@
 #include "HAL/JSClass.hpp"
 
 #include "HAL/JSString.hpp"
+#include "HAL/JSPropertyKey.hpp"
+#include "HAL/JSStringBuilder.hpp"
 
 #include "HAL/JSValue.hpp"
+#include "HAL/JSExpected.hpp"
 #include "HAL/JSUndefined.hpp"
 #include "HAL/JSNull.hpp"
 #include "HAL/JSBoolean.hpp"
 #include "HAL/JSNumber.hpp"
+#include "HAL/JSLocal.hpp"
+#include "HAL/JSArguments.hpp"
+#include "HAL/JSConverter.hpp"
+#include "HAL/JSHandleScope.hpp"
 
 #include "HAL/JSObject.hpp"
 #include "HAL/JSArray.hpp"
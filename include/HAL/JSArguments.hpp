@@ -0,0 +1,226 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSARGUMENTS_HPP_
+#define _HAL_JSARGUMENTS_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/JSLocal.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HAL {
+
+  /*!
+   @class
+
+   @discussion A JSArguments is a non-owning, indexable view over the
+   arguments that JavaScriptCore passes to a function callback.
+
+   Creating, copying and indexing a JSArguments never allocates and
+   never calls JSValueProtect. Each argument is handed out as a
+   JSLocal, so like a JSLocal a JSArguments is only valid until the
+   callback it was given to returns. Use ToVector when you need the
+   arguments as persistent JSValues.
+
+   The typed accessors (GetBoolean, GetNumber, etc.) are bounds
+   checked: they return the given default value when the argument is
+   missing or undefined, which matches how JavaScript treats default
+   parameter values.
+   */
+  class HAL_EXPORT JSArguments final {
+
+  public:
+
+    /*!
+     @method
+
+     @abstract Return the number of arguments.
+
+     @result The number of arguments.
+     */
+    std::size_t size() const HAL_NOEXCEPT {
+      return argument_count__;
+    }
+
+    /*!
+     @method
+
+     @abstract Determine whether there are no arguments.
+
+     @result true if there are no arguments.
+     */
+    bool empty() const HAL_NOEXCEPT {
+      return argument_count__ == 0;
+    }
+
+    /*!
+     @method
+
+     @abstract Return the argument at the given index without bounds
+     checking.
+
+     @param index The index of the argument, which must be less than
+     size().
+
+     @result The argument at the given index.
+     */
+    JSLocal operator[](std::size_t index) const HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Return the argument at the given index.
+
+     @param index The index of the argument.
+
+     @result The argument at the given index.
+
+     @throws std::invalid_argument if index is not less than size().
+     */
+    JSLocal at(std::size_t index) const;
+
+    /*!
+     @method
+
+     @abstract Determine whether the argument at the given index was
+     provided, i.e. it exists and is not undefined.
+
+     @param index The index of the argument.
+
+     @result true if the argument at the given index was provided.
+     */
+    bool Has(std::size_t index) const HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Convert the argument at the given index to a boolean.
+
+     @param index The index of the argument.
+
+     @param default_value The value to return if the argument was not
+     provided.
+
+     @result The boolean result of conversion, or default_value.
+     */
+    bool GetBoolean(std::size_t index, bool default_value = false) const HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Convert the argument at the given index to a double.
+
+     @param index The index of the argument.
+
+     @param default_value The value to return if the argument was not
+     provided.
+
+     @result The double result of conversion, or default_value.
+     */
+    double GetNumber(std::size_t index, double default_value = 0) const;
+
+    /*!
+     @method
+
+     @abstract Convert the argument at the given index to an int32_t
+     according to the rules specified by the JavaScript language.
+
+     @param index The index of the argument.
+
+     @param default_value The value to return if the argument was not
+     provided.
+
+     @result The int32_t result of conversion, or default_value.
+     */
+    int32_t GetInt32(std::size_t index, int32_t default_value = 0) const;
+
+    /*!
+     @method
+
+     @abstract Convert the argument at the given index to an uint32_t
+     according to the rules specified by the JavaScript language.
+
+     @param index The index of the argument.
+
+     @param default_value The value to return if the argument was not
+     provided.
+
+     @result The uint32_t result of conversion, or default_value.
+     */
+    uint32_t GetUInt32(std::size_t index, uint32_t default_value = 0) const;
+
+    /*!
+     @method
+
+     @abstract Convert the argument at the given index to a
+     std::string.
+
+     @param index The index of the argument.
+
+     @param default_value The value to return if the argument was not
+     provided.
+
+     @result The std::string result of conversion, or default_value.
+     */
+    std::string GetString(std::size_t index, const std::string& default_value = "") const;
+
+    /*!
+     @method
+
+     @abstract Copy the arguments into a std::vector of JSValues, each
+     of which keeps its JavaScript value alive for as long as it
+     exists.
+
+     @discussion This allocates and protects every argument. It is how
+     callbacks taking a std::vector<JSValue> are adapted to a
+     JSArguments.
+
+     @result The arguments as a std::vector of JSValues.
+     */
+    std::vector<JSValue> ToVector() const;
+
+    /*!
+     @method
+
+     @abstract Return the execution context of the arguments.
+
+     @result The execution context of the arguments.
+     */
+    JSContext get_context() const HAL_NOEXCEPT;
+
+    // For interoperability with the JavaScriptCore C API.
+    JSArguments(JSContextRef js_context_ref, std::size_t argument_count, const JSValueRef arguments_array[]) HAL_NOEXCEPT;
+
+    JSArguments()                              = delete;
+    ~JSArguments()                             = default;
+    JSArguments(const JSArguments&)            = default;
+    JSArguments& operator=(const JSArguments&) = default;
+
+  private:
+
+    // Prevent heap based objects.
+    static void * operator new(std::size_t);     // #1: To prevent allocation of scalar objects
+    static void * operator new [] (std::size_t); // #2: To prevent allocation of array of objects
+
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    JSContextRef      js_context_ref__  { nullptr };
+    std::size_t       argument_count__  { 0 };
+    const JSValueRef* arguments_array__ { nullptr };
+#pragma warning(pop)
+  };
+
+} // namespace HAL {
+
+#endif // _HAL_JSARGUMENTS_HPP_
@@ -119,7 +119,7 @@ private:
 
 template<typename T>
 std::vector<std::shared_ptr<T>> JSArray::GetPrivateItems() const HAL_NOEXCEPT {
-	const uint32_t length = static_cast<uint32_t>(GetProperty("length"));
+	const uint32_t length = GetLength();
 	std::vector<std::shared_ptr<T>> items(length);
 	for (uint32_t i = 0; i < length; i++) {
 		const JSValue js_item_prop = GetProperty(i);
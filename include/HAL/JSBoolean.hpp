@@ -35,7 +35,7 @@ class HAL_EXPORT JSBoolean final : public JSValue HAL_PERFORMANCE_COUNTER2(JSBoo
     @result The JSBoolean with the new value of the given boolean.
   */
 	JSBoolean& operator=(bool boolean) {
-		JSValue::operator=(JSBoolean(get_context(), boolean));
+		JSValue::operator=(get_context().CreateBoolean(boolean));
 		return *this;
 	}
 
@@ -47,6 +47,11 @@ class HAL_EXPORT JSBoolean final : public JSValue HAL_PERFORMANCE_COUNTER2(JSBoo
 	JSBoolean(const JSContext& js_context, bool boolean)
 			: JSValue(js_context, JSValueMakeBoolean(static_cast<JSContextRef>(js_context), boolean)) {
 	}
+	
+	// Refer to one of the JSContext's cached boolean values.
+	JSBoolean(const JSContext& js_context, JSValueRef cached_js_value_ref) HAL_NOEXCEPT
+			: JSValue(js_context, cached_js_value_ref, Type::Boolean) {
+	}
 };
 
 } // namespace HAL {
@@ -11,6 +11,7 @@
 
 #include "HAL/detail/JSBase.hpp"
 #include "HAL/JSContextGroup.hpp"
+#include "HAL/detail/JSContextLifetime.hpp"
 
 #include <vector>
 #include <unordered_map>
@@ -31,6 +32,9 @@ namespace HAL {
   class JSRegExp;
   class JSFunction;
   class JSExportObject;
+  class JSArguments;
+  template<typename T>
+  class JSExpected;
   
   namespace detail {
     template<typename T>
@@ -43,6 +47,10 @@ namespace HAL {
 
   typedef std::function<JSValue(const std::vector<JSValue>, JSObject&)> JSFunctionCallback;
   
+  // The cheaper form of JSFunctionCallback, which receives the
+  // function's arguments without copying or protecting them.
+  typedef std::function<JSValue(const JSArguments&, JSObject&)> JSFunctionArgumentsCallback;
+  
   /*!
    @class
    
@@ -53,6 +61,9 @@ namespace HAL {
    JSContexts are created by the JSContextGroup::CreateContext member
    function.
    
+   All JSContexts for the same global context share a single retain of
+   it, so copying a JSContext never calls into JavaScriptCore.
+   
    Scripts may execute concurrently with scripts executing in other
    contexts, and contexts within the same context group may share and
    exchange their JavaScript objects with one another.
@@ -83,7 +94,7 @@ namespace HAL {
      @result The context group of this JavaScript execution context.
      */
     JSContextGroup get_context_group() const HAL_NOEXCEPT {
-      return js_context_group__;
+      return JSContextGroup(get_context_group_ref());
     }
     
     /*!
@@ -321,8 +332,11 @@ namespace HAL {
      @abstract Create a JavaScript function with a given callback
      as its implementation by C++11 lambda/std::function.
 
-     @param callback A C++11 function to invoke when the function is called
-     k
+     @param callback A C++11 function to invoke when the function is
+     called. The function object owns a copy of the callback, which
+     may capture this JSContext; see JSFunction for how long it
+     lives.
+     
      @param function_name An optional JSString containing the
      function's name. This will be used when converting the function
      to a string. An empty string creates an anonymous function.
@@ -332,6 +346,38 @@ namespace HAL {
      */
     JSFunction CreateFunction(JSFunctionCallback& callback) const;
     JSFunction CreateFunction(const JSString& function_name, JSFunctionCallback& callback) const;
+    JSFunction CreateFunction(const JSFunctionArgumentsCallback& callback) const;
+    JSFunction CreateFunction(const JSString& function_name, const JSFunctionArgumentsCallback& callback) const;
+
+    /*!
+     @method
+
+     @abstract Create a JavaScript function with a native function of
+     any signature supported by JSConverter as its implementation, e.g.
+
+     double Scale(double factor, int32_t steps, const std::string& unit);
+
+     Each argument is converted straight from JavaScript, and the
+     result back to JavaScript. A missing argument, or an argument of
+     the wrong JavaScript type, throws a JavaScript exception instead of
+     calling the native function. Prefix a lambda that captures nothing
+     with + to pass it as a function pointer.
+
+     This member function is defined in JSFunction.hpp.
+
+     @param function_name An optional JSString containing the
+     function's name. An empty string creates an anonymous function.
+
+     @param function The native function to invoke when the function
+     is called.
+
+     @result A JSObject that is a function. The object's prototype
+     will be the default function prototype.
+     */
+    template<typename R, typename... Args>
+    JSFunction CreateFunction(R (*function)(Args...)) const;
+    template<typename R, typename... Args>
+    JSFunction CreateFunction(const JSString& function_name, R (*function)(Args...)) const;
 
     /*!
      @method
@@ -377,6 +423,21 @@ namespace HAL {
     JSValue JSEvaluateScript(const JSString& script,                       const JSString& source_url, int starting_line_number = 1) const;
     JSValue JSEvaluateScript(const JSString& script, JSObject this_object, const JSString& source_url, int starting_line_number = 1) const;
     
+    /*!
+     @method
+     
+     @abstract Evaluate a string of JavaScript code without throwing a
+     C++ exception. The arguments are the same as for
+     JSEvaluateScript.
+     
+     @result The JSValue that results from evaluating script, or the
+     JavaScript exception that the evaluated script threw.
+     */
+    JSExpected<JSValue> TryJSEvaluateScript(const JSString& script                                                                                ) const;
+    JSExpected<JSValue> TryJSEvaluateScript(const JSString& script, JSObject this_object                                                          ) const;
+    JSExpected<JSValue> TryJSEvaluateScript(const JSString& script,                       const JSString& source_url, int starting_line_number = 1) const;
+    JSExpected<JSValue> TryJSEvaluateScript(const JSString& script, JSObject this_object, const JSString& source_url, int starting_line_number = 1) const;
+    
     /*!
      @method
      
@@ -437,6 +498,9 @@ namespace HAL {
 #endif
     
     JSContext() = delete;
+    
+    // A moved-from JSContext no longer refers to a global context. It
+    // may be copied, assigned to, assigned from or destroyed.
     ~JSContext()                    HAL_NOEXCEPT;
     JSContext(const JSContext&)     HAL_NOEXCEPT;
     JSContext(JSContext&&)          HAL_NOEXCEPT;
@@ -445,7 +509,7 @@ namespace HAL {
 
     // For interoperability with the JavaScriptCore C API.
     explicit operator JSContextRef() const HAL_NOEXCEPT {
-      return js_global_context_ref__;
+      return get_global_context_ref();
     }
     
     explicit JSContext(JSContextRef js_context_ref) HAL_NOEXCEPT;
@@ -461,6 +525,35 @@ namespace HAL {
     
     JSContext(const JSContextGroup& js_context_group, const JSClass& global_object_class) HAL_NOEXCEPT;
     
+    // JSValue and JSObject compare context groups without retaining
+    // them, and JSObject and JSFunction use the context's cached
+    // intrinsics.
+    friend class JSValue;
+    friend class JSObject;
+    friend class JSFunction;
+    
+    JSContextGroupRef get_context_group_ref() const HAL_NOEXCEPT {
+      return js_context_lifetime__ ? js_context_lifetime__ -> get_context_group_ref() : nullptr;
+    }
+    
+    JSGlobalContextRef get_global_context_ref() const HAL_NOEXCEPT {
+      return js_context_lifetime__ ? js_context_lifetime__ -> get_global_context_ref() : nullptr;
+    }
+    
+    // JSExportClass keeps its per-context constants cache in the
+    // JSContextLifetime.
+    template<typename T>
+    friend class detail::JSExportClass;
+    
+    detail::JSContextLifetime* get_context_lifetime() const HAL_NOEXCEPT {
+      return js_context_lifetime__;
+    }
+    
+    // Evaluate a script with the given this object, or with the global
+    // object if this_object_ref is nullptr.
+    JSValue JSEvaluateScript(const JSString& script, JSObjectRef this_object_ref, const JSString& source_url, int starting_line_number) const;
+    JSExpected<JSValue> TryJSEvaluateScript(const JSString& script, JSObjectRef this_object_ref, const JSString& source_url, int starting_line_number) const;
+    
     HAL_EXPORT friend bool operator==(const JSValue& lhs, const JSValue& rhs) HAL_NOEXCEPT;
     HAL_EXPORT friend std::vector<JSValue> detail::to_vector(const JSContext&, size_t, const JSValueRef[]);
    
@@ -474,14 +567,16 @@ namespace HAL {
     // need to be exported from a DLL.
 #pragma warning(push)
 #pragma warning(disable: 4251)
-    JSContextGroup     js_context_group__;
-    JSGlobalContextRef js_global_context_ref__ { nullptr };
+    // A JSContext is only a pointer to the JSContextLifetime shared by
+    // every JSContext for the same global context, which is what keeps
+    // the global context alive. This keeps JSValues and JSObjects,
+    // which each hold a JSContext, small and cheap to copy.
+    detail::JSContextLifetime* js_context_lifetime__ { nullptr };
 #pragma warning(pop)
     
 #undef  HAL_JSCONTEXT_LOCK_GUARD
 #ifdef  HAL_THREAD_SAFE
-    std::recursive_mutex mutex__;
-#define HAL_JSCONTEXT_LOCK_GUARD std::lock_guard<std::recursive_mutex> lock(mutex__)
+#define HAL_JSCONTEXT_LOCK_GUARD std::lock_guard<std::recursive_mutex> lock(js_context_lifetime__ -> get_mutex())
 #else
 #define HAL_JSCONTEXT_LOCK_GUARD
 #endif  // HAL_THREAD_SAFE
@@ -495,7 +590,8 @@ namespace HAL {
   // Return true if the two JSContexts are equal.
   inline
   bool operator==(const JSContext& lhs, const JSContext& rhs) {
-    return (lhs.js_global_context_ref__ == rhs.js_global_context_ref__);
+    // There is only one JSContextLifetime per global context.
+    return (lhs.js_context_lifetime__ == rhs.js_context_lifetime__);
   }
   
   // Return true if the two JSContextGroups are not equal.
@@ -103,7 +103,7 @@ namespace HAL {
 #pragma warning(push)
 #pragma warning(disable: 4251)
     bool managed__ { false };
-    JSContextGroupRef js_context_group_ref__;
+    JSContextGroupRef js_context_group_ref__ { nullptr };
 #pragma warning(pop)
     
 #undef HAL_JSCONTEXTGROUP_LOCK_GUARD
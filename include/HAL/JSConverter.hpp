@@ -0,0 +1,251 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSCONVERTER_HPP_
+#define _HAL_JSCONVERTER_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/JSContext.hpp"
+#include "HAL/JSValue.hpp"
+#include "HAL/JSLocal.hpp"
+#include "HAL/JSString.hpp"
+#include "HAL/JSObject.hpp"
+#include "HAL/JSBoolean.hpp"
+#include "HAL/JSNumber.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace HAL {
+
+  /*!
+   @class
+
+   @discussion A JSConverter<T> converts between a JavaScript value and
+   the C++ type T. HAL uses it to call native functions with typed
+   signatures, such as
+
+   double Widget::scale(double factor, int32_t steps, const std::string& unit);
+
+   converting each argument from JavaScript and the result back to
+   JavaScript at compile time.
+
+   Every JSConverter provides:
+
+   GetTypeName  : The name of the expected JavaScript type, used in
+                  error messages (e.g. "a number").
+   IsConvertible: Whether a JavaScript value has the expected type.
+                  HAL reports a type error instead of converting a
+                  value that doesn't.
+   FromJS       : Convert a JavaScript value to a T.
+   ToJS         : Convert a T to a JavaScript value.
+
+   HAL provides JSConverters for JSValue, JSLocal, JSObject, JSString,
+   std::string, bool, double, float, int32_t and uint32_t. Specialize
+   JSConverter to support other types.
+   */
+  template<typename T>
+  struct JSConverter;
+
+  template<>
+  struct JSConverter<JSValue> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a value";
+    }
+
+    static bool IsConvertible(const JSLocal&) HAL_NOEXCEPT {
+      return true;
+    }
+
+    static JSValue FromJS(const JSLocal& js_value) {
+      return js_value.ToPersistent();
+    }
+
+    static JSValue ToJS(const JSContext&, const JSValue& value) HAL_NOEXCEPT {
+      return value;
+    }
+  };
+
+  // A JSLocal argument is only valid until the native function
+  // returns.
+  template<>
+  struct JSConverter<JSLocal> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a value";
+    }
+
+    static bool IsConvertible(const JSLocal&) HAL_NOEXCEPT {
+      return true;
+    }
+
+    static JSLocal FromJS(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value;
+    }
+
+    static JSValue ToJS(const JSContext&, const JSLocal& value) {
+      return value.ToPersistent();
+    }
+  };
+
+  template<>
+  struct JSConverter<JSObject> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "an object";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsObject();
+    }
+
+    static JSObject FromJS(const JSLocal& js_value) {
+      return static_cast<JSObject>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext&, const JSObject& value) {
+      return value;
+    }
+  };
+
+  template<>
+  struct JSConverter<JSString> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a string";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsString();
+    }
+
+    static JSString FromJS(const JSLocal& js_value) {
+      return static_cast<JSString>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, const JSString& value) HAL_NOEXCEPT {
+      return js_context.CreateString(value);
+    }
+  };
+
+  template<>
+  struct JSConverter<std::string> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a string";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsString();
+    }
+
+    static std::string FromJS(const JSLocal& js_value) {
+      return static_cast<std::string>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, const std::string& value) HAL_NOEXCEPT {
+      return js_context.CreateString(value);
+    }
+  };
+
+  template<>
+  struct JSConverter<bool> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a boolean";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsBoolean();
+    }
+
+    static bool FromJS(const JSLocal& js_value) HAL_NOEXCEPT {
+      return static_cast<bool>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, bool value) HAL_NOEXCEPT {
+      return js_context.CreateBoolean(value);
+    }
+  };
+
+  template<>
+  struct JSConverter<double> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a number";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsNumber();
+    }
+
+    static double FromJS(const JSLocal& js_value) {
+      return static_cast<double>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, double value) HAL_NOEXCEPT {
+      return js_context.CreateNumber(value);
+    }
+  };
+
+  template<>
+  struct JSConverter<float> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a number";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsNumber();
+    }
+
+    static float FromJS(const JSLocal& js_value) {
+      return static_cast<float>(static_cast<double>(js_value));
+    }
+
+    static JSValue ToJS(const JSContext& js_context, float value) HAL_NOEXCEPT {
+      return js_context.CreateNumber(static_cast<double>(value));
+    }
+  };
+
+  // Integers are converted according to the rules specified by the
+  // JavaScript language, e.g. 2.5 becomes 2.
+  template<>
+  struct JSConverter<int32_t> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a number";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsNumber();
+    }
+
+    static int32_t FromJS(const JSLocal& js_value) {
+      return static_cast<int32_t>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, int32_t value) HAL_NOEXCEPT {
+      return js_context.CreateNumber(value);
+    }
+  };
+
+  template<>
+  struct JSConverter<uint32_t> final {
+    static const char* GetTypeName() HAL_NOEXCEPT {
+      return "a number";
+    }
+
+    static bool IsConvertible(const JSLocal& js_value) HAL_NOEXCEPT {
+      return js_value.IsNumber();
+    }
+
+    static uint32_t FromJS(const JSLocal& js_value) {
+      return static_cast<uint32_t>(js_value);
+    }
+
+    static JSValue ToJS(const JSContext& js_context, uint32_t value) HAL_NOEXCEPT {
+      return js_context.CreateNumber(value);
+    }
+  };
+
+} // namespace HAL {
+
+#endif // _HAL_JSCONVERTER_HPP_
@@ -0,0 +1,329 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSEXPECTED_HPP_
+#define _HAL_JSEXPECTED_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/JSValue.hpp"
+
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace HAL {
+
+  /*!
+   @class
+
+   @discussion A JSException is a JavaScript exception that was caught
+   instead of being thrown as a C++ exception. It holds the raw
+   exception value and nothing else: unlike throwing, catching a
+   JSException never looks up the exception's message, name, file
+   name, etc.
+   */
+  class HAL_EXPORT JSException final {
+
+  public:
+
+    explicit JSException(JSValue js_value) HAL_NOEXCEPT
+    : js_value__(std::move(js_value)) {
+    }
+
+    /*!
+     @method
+
+     @abstract Return the value that was thrown, which is usually but
+     not necessarily an Error object.
+
+     @result The value that was thrown.
+     */
+    const JSValue& get_value() const HAL_NOEXCEPT {
+      return js_value__;
+    }
+
+    /*!
+     @method
+
+     @abstract Throw this JavaScript exception as a C++ exception, the
+     same way the throwing HAL APIs do.
+
+     @throws std::runtime_error always.
+     */
+    void Throw() const;
+
+  private:
+
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    JSValue js_value__;
+#pragma warning(pop)
+  };
+
+  /*!
+   @class
+
+   @discussion A JSExpected<T> is the result of one of HAL's Try*
+   member functions: either a T, or the JSException thrown by
+   JavaScript while trying to compute it. It is a minimal C++11
+   counterpart of std::expected<T, JSException>.
+
+   auto result = js_context.TryJSEvaluateScript("JSON.parse(input)");
+   if (result) {
+     Use(*result);
+   } else {
+     Log(to_string(result.error().get_value()));
+   }
+   */
+  template<typename T>
+  class JSExpected final {
+
+  public:
+
+    JSExpected(T value) HAL_NOEXCEPT
+    : has_value__(true) {
+      // Use the global placement new since HAL's value classes hide
+      // operator new.
+      ::new (&storage__) T(std::move(value));
+    }
+
+    JSExpected(JSException exception) HAL_NOEXCEPT
+    : has_value__(false) {
+      ::new (&storage__) JSException(std::move(exception));
+    }
+
+    JSExpected(const JSExpected& rhs) HAL_NOEXCEPT
+    : has_value__(rhs.has_value__) {
+      if (has_value__) {
+        ::new (&storage__) T(*rhs.get_value_pointer());
+      } else {
+        ::new (&storage__) JSException(*rhs.get_exception_pointer());
+      }
+    }
+
+    JSExpected(JSExpected&& rhs) HAL_NOEXCEPT
+    : has_value__(rhs.has_value__) {
+      if (has_value__) {
+        ::new (&storage__) T(std::move(*rhs.get_value_pointer()));
+      } else {
+        ::new (&storage__) JSException(std::move(*rhs.get_exception_pointer()));
+      }
+    }
+
+    JSExpected& operator=(JSExpected rhs) HAL_NOEXCEPT {
+      Destroy();
+      has_value__ = rhs.has_value__;
+      if (has_value__) {
+        ::new (&storage__) T(std::move(*rhs.get_value_pointer()));
+      } else {
+        ::new (&storage__) JSException(std::move(*rhs.get_exception_pointer()));
+      }
+      return *this;
+    }
+
+    ~JSExpected() HAL_NOEXCEPT {
+      Destroy();
+    }
+
+    bool has_value() const HAL_NOEXCEPT {
+      return has_value__;
+    }
+
+    explicit operator bool() const HAL_NOEXCEPT {
+      return has_value__;
+    }
+
+    /*!
+     @method
+
+     @abstract Return the value.
+
+     @result The value.
+
+     @throws std::runtime_error if there is no value, by throwing the
+     JSException instead.
+     */
+    const T& value() const {
+      if (!has_value__) {
+        get_exception_pointer() -> Throw();
+      }
+      return *get_value_pointer();
+    }
+
+    T& value() {
+      if (!has_value__) {
+        get_exception_pointer() -> Throw();
+      }
+      return *get_value_pointer();
+    }
+
+    /*!
+     @method
+
+     @abstract Return the value if there is one, otherwise the given
+     default value.
+     */
+    T value_or(T default_value) const {
+      return has_value__ ? *get_value_pointer() : std::move(default_value);
+    }
+
+    /*!
+     @method
+
+     @abstract Return the JavaScript exception. There must not be a
+     value.
+     */
+    const JSException& error() const HAL_NOEXCEPT {
+      // precondition
+      assert(!has_value__);
+      return *get_exception_pointer();
+    }
+
+    const T& operator*() const HAL_NOEXCEPT {
+      // precondition
+      assert(has_value__);
+      return *get_value_pointer();
+    }
+
+    T& operator*() HAL_NOEXCEPT {
+      // precondition
+      assert(has_value__);
+      return *get_value_pointer();
+    }
+
+    const T* operator->() const HAL_NOEXCEPT {
+      // precondition
+      assert(has_value__);
+      return get_value_pointer();
+    }
+
+    T* operator->() HAL_NOEXCEPT {
+      // precondition
+      assert(has_value__);
+      return get_value_pointer();
+    }
+
+  private:
+
+    void Destroy() HAL_NOEXCEPT {
+      if (has_value__) {
+        get_value_pointer() -> ~T();
+      } else {
+        get_exception_pointer() -> ~JSException();
+      }
+    }
+
+    T* get_value_pointer() HAL_NOEXCEPT {
+      return reinterpret_cast<T*>(&storage__);
+    }
+
+    const T* get_value_pointer() const HAL_NOEXCEPT {
+      return reinterpret_cast<const T*>(&storage__);
+    }
+
+    JSException* get_exception_pointer() HAL_NOEXCEPT {
+      return reinterpret_cast<JSException*>(&storage__);
+    }
+
+    const JSException* get_exception_pointer() const HAL_NOEXCEPT {
+      return reinterpret_cast<const JSException*>(&storage__);
+    }
+
+    bool has_value__;
+    typename std::aligned_storage<(sizeof(T) > sizeof(JSException) ? sizeof(T) : sizeof(JSException)),
+                                  (std::alignment_of<T>::value > std::alignment_of<JSException>::value ? std::alignment_of<T>::value : std::alignment_of<JSException>::value)>::type storage__;
+  };
+
+  /*!
+   @class
+
+   @discussion A JSExpected<void> is the result of a Try* member
+   function that has no value: either success, or the JSException
+   thrown by JavaScript.
+   */
+  template<>
+  class JSExpected<void> final {
+
+  public:
+
+    JSExpected() HAL_NOEXCEPT
+    : has_value__(true) {
+    }
+
+    JSExpected(JSException exception) HAL_NOEXCEPT
+    : has_value__(false) {
+      ::new (&storage__) JSException(std::move(exception));
+    }
+
+    JSExpected(const JSExpected& rhs) HAL_NOEXCEPT
+    : has_value__(rhs.has_value__) {
+      if (!has_value__) {
+        ::new (&storage__) JSException(*rhs.get_exception_pointer());
+      }
+    }
+
+    JSExpected& operator=(JSExpected rhs) HAL_NOEXCEPT {
+      Destroy();
+      has_value__ = rhs.has_value__;
+      if (!has_value__) {
+        ::new (&storage__) JSException(std::move(*rhs.get_exception_pointer()));
+      }
+      return *this;
+    }
+
+    ~JSExpected() HAL_NOEXCEPT {
+      Destroy();
+    }
+
+    bool has_value() const HAL_NOEXCEPT {
+      return has_value__;
+    }
+
+    explicit operator bool() const HAL_NOEXCEPT {
+      return has_value__;
+    }
+
+    // Throw the JavaScript exception if there is one.
+    void value() const {
+      if (!has_value__) {
+        get_exception_pointer() -> Throw();
+      }
+    }
+
+    const JSException& error() const HAL_NOEXCEPT {
+      // precondition
+      assert(!has_value__);
+      return *get_exception_pointer();
+    }
+
+  private:
+
+    void Destroy() HAL_NOEXCEPT {
+      if (!has_value__) {
+        get_exception_pointer() -> ~JSException();
+      }
+    }
+
+    JSException* get_exception_pointer() HAL_NOEXCEPT {
+      return reinterpret_cast<JSException*>(&storage__);
+    }
+
+    const JSException* get_exception_pointer() const HAL_NOEXCEPT {
+      return reinterpret_cast<const JSException*>(&storage__);
+    }
+
+    bool has_value__;
+    std::aligned_storage<sizeof(JSException), std::alignment_of<JSException>::value>::type storage__;
+  };
+
+} // namespace HAL {
+
+#endif // _HAL_JSEXPECTED_HPP_
@@ -12,6 +12,7 @@
 #include "HAL/detail/JSBase.hpp"
 #include "HAL/detail/JSExportClassDefinitionBuilder.hpp"
 
+#include <cstddef>
 #include <string>
 #include <memory>
 #include <mutex>
@@ -119,9 +120,15 @@ namespace HAL {
     
     /*
      @method
-     @abstract Erase all constant cache
+     @abstract Erase all constant cache of every context
      */
     static void EvictAllCache();
+    
+    /*
+     @method
+     @abstract Erase all constant cache of the given context
+     */
+    static void EvictAllCache(const JSContext& js_context);
  
     virtual ~JSExport() HAL_NOEXCEPT {
     }
@@ -165,6 +172,18 @@ namespace HAL {
      */
     static void SetParent(const JSClass& parent);
     
+    /*!
+     @method
+     
+     @abstract Set whether your JSClass installs the values of its
+     constant properties on its automatically generated prototype as
+     plain data properties, once per JavaScript execution context,
+     instead of vending them from native code on every read. The
+     default value is false. See
+     JSExportClassDefinitionBuilder::ConstantsInPrototype.
+     */
+    static void SetConstantsInPrototype(bool constants_in_prototype);
+    
     /*!
      @method
      
@@ -197,10 +216,11 @@ namespace HAL {
      property's value.
      
      @param set_callback The callback to invoke when setting your
-     property's value. This may be nullptr, in which case the
-     'ReadOnly' attribute for your property is automatically set. If
-     this callback returns false, then this indicates that the value
-     was not set.
+     property's value, either a SetNamedValuePropertyCallback or a
+     SetNamedValuePropertyLocalCallback. This may be nullptr, in which
+     case the 'ReadOnly' attribute for your property is automatically
+     set. If this callback returns false, then this indicates that the
+     value was not set.
      
      @param enumerable An optional property attribute that specifies
      whether your property is enumerable. The default value is true,
@@ -215,10 +235,32 @@ namespace HAL {
      
      3. You have already added a property with the same property_name.
      */
+    template<typename U = std::nullptr_t>
     static void AddValueProperty(const JSString& property_name,
                                  detail::GetNamedValuePropertyCallback<T> get_callback,
-                                 detail::SetNamedValuePropertyCallback<T> set_callback = nullptr,
+                                 U set_callback = nullptr,
                                  bool enumerable = true);
+    
+    /*!
+     @method
+     
+     @abstract Add a value property implemented by member functions
+     named at compile time, e.g.
+     
+     AddValueProperty("name", HAL_EXPORT_METHOD(&Foo::GetName), HAL_EXPORT_METHOD(&Foo::SetName));
+     AddValueProperty("pi"  , HAL_EXPORT_METHOD(&Foo::GetPi));
+     
+     @discussion The property has the same attributes as one added
+     with the overload above, but JavaScriptCore calls the member
+     functions directly instead of through a std::function looked up
+     by property name. See detail::JSExportMethod for the supported
+     signatures.
+     */
+    template<typename M, M get_method>
+    static void AddValueProperty(const JSString& property_name, detail::JSExportMethod<M, get_method> getter, bool enumerable = true);
+    
+    template<typename M, M get_method, typename N, N set_method>
+    static void AddValueProperty(const JSString& property_name, detail::JSExportMethod<M, get_method> getter, detail::JSExportMethod<N, set_method> setter, bool enumerable = true);
 
     /*!
      @method
@@ -276,7 +318,8 @@ namespace HAL {
      @param function_name A JSString containing your function's name.
      
      @param function_callback The callback to invoke when calling your
-     JavaScript object as a function.
+     JavaScript object as a function, either a
+     CallNamedFunctionArgumentsCallback or a CallNamedFunctionCallback.
      
      @param enumerable An optional property attribute that specifies
      whether your property is enumerable. The default value is true,
@@ -291,7 +334,24 @@ namespace HAL {
      
      3. You have already added a property with the same property_name.
      */
-    static void AddFunctionProperty(const JSString& function_name, detail::CallNamedFunctionCallback<T> function_callback, bool enumerable = true);
+    template<typename U>
+    static void AddFunctionProperty(const JSString& function_name, U function_callback, bool enumerable = true);
+    
+    /*!
+     @method
+     
+     @abstract Add a function property implemented by a member
+     function named at compile time, e.g.
+     
+     AddFunctionProperty("hello", HAL_EXPORT_METHOD(&Foo::Hello));
+     
+     @discussion The property has the same attributes as one added
+     with the overload above, but JavaScriptCore calls the member
+     function directly instead of through a std::function. See
+     detail::JSExportMethod for the supported signatures.
+     */
+    template<typename M, M method>
+    static void AddFunctionProperty(const JSString& function_name, detail::JSExportMethod<M, method> function, bool enumerable = true);
     
     /*!
      @method
@@ -500,12 +560,14 @@ namespace HAL {
      object).
      
      @param call_as_function_callback The callback to invoke when your
-     JavaScript object is called as a function.
+     JavaScript object is called as a function, either a
+     CallAsFunctionArgumentsCallback or a CallAsFunctionCallback.
      
      @result Your callback should return the value produced by calling
      your JavaScript object as a function.
      */
-    static void AddCallAsFunctionCallback(const detail::CallAsFunctionCallback<T>& call_as_function_callback);
+    template<typename U>
+    static void AddCallAsFunctionCallback(const U& call_as_function_callback);
     
     /*!
      @method
@@ -563,8 +625,26 @@ namespace HAL {
   }
   
   template<typename T>
-  void JSExport<T>::AddValueProperty(const JSString& property_name, detail::GetNamedValuePropertyCallback<T> get_callback, detail::SetNamedValuePropertyCallback<T> set_callback, bool enumerable) {
-    builder__.AddValueProperty(property_name, get_callback, set_callback);
+  void JSExport<T>::SetConstantsInPrototype(bool constants_in_prototype) {
+    builder__.ConstantsInPrototype(constants_in_prototype);
+  }
+  
+  template<typename T>
+  template<typename U>
+  void JSExport<T>::AddValueProperty(const JSString& property_name, detail::GetNamedValuePropertyCallback<T> get_callback, U set_callback, bool enumerable) {
+    builder__.AddValueProperty(property_name, get_callback, set_callback, enumerable);
+  }
+
+  template<typename T>
+  template<typename M, M get_method>
+  void JSExport<T>::AddValueProperty(const JSString& property_name, detail::JSExportMethod<M, get_method> getter, bool enumerable) {
+    builder__.AddValueProperty(property_name, getter, enumerable);
+  }
+  
+  template<typename T>
+  template<typename M, M get_method, typename N, N set_method>
+  void JSExport<T>::AddValueProperty(const JSString& property_name, detail::JSExportMethod<M, get_method> getter, detail::JSExportMethod<N, set_method> setter, bool enumerable) {
+    builder__.AddValueProperty(property_name, getter, setter, enumerable);
   }
 
   template<typename T>
@@ -573,10 +653,17 @@ namespace HAL {
   }
   
   template<typename T>
-  void JSExport<T>::AddFunctionProperty(const JSString& function_name, detail::CallNamedFunctionCallback<T> function_callback, bool enumerable) {
+  template<typename U>
+  void JSExport<T>::AddFunctionProperty(const JSString& function_name, U function_callback, bool enumerable) {
     builder__.AddFunctionProperty(function_name, function_callback, enumerable);
   }
   
+  template<typename T>
+  template<typename M, M method>
+  void JSExport<T>::AddFunctionProperty(const JSString& function_name, detail::JSExportMethod<M, method> function, bool enumerable) {
+    builder__.AddFunctionProperty(function_name, function, enumerable);
+  }
+  
   template<typename T>
   void JSExport<T>::AddHasPropertyCallback(const detail::HasPropertyCallback<T>& has_property_callback) {
     builder__.HasProperty(has_property_callback);
@@ -603,7 +690,8 @@ namespace HAL {
   }
   
   template<typename T>
-  void JSExport<T>::AddCallAsFunctionCallback(const detail::CallAsFunctionCallback<T>& call_as_function_callback) {
+  template<typename U>
+  void JSExport<T>::AddCallAsFunctionCallback(const U& call_as_function_callback) {
     builder__.CallAsFunction(call_as_function_callback);
   }
   
@@ -617,13 +705,13 @@ namespace HAL {
   
   template<typename T>
   detail::JSExportClass<T> JSExport<T>::Class() {
-    static detail::JSExportClassDefinition<T> js_export_class_definition;
-    static detail::JSExportClass<T>           js_export_class;
-    static std::once_flag                     of;
+    static detail::JSExportClass<T> js_export_class;
+    static std::once_flag           of;
     std::call_once(of, []() {
       T::JSExportInitialize();
-      js_export_class_definition = builder__.build();
-      js_export_class            = detail::JSExportClass<T>(js_export_class_definition);
+      // JSExportClass keeps its own copy of the definition, so there
+      // is no need to keep another one here.
+      js_export_class = detail::JSExportClass<T>(builder__.build());
     });
     
     return js_export_class;
@@ -633,6 +721,11 @@ namespace HAL {
   void JSExport<T>::EvictAllCache() {
     detail::JSExportClass<T>::EvictAllCache();
   }
+  
+  template<typename T>
+  void JSExport<T>::EvictAllCache(const JSContext& js_context) {
+    detail::JSExportClass<T>::EvictAllCache(js_context);
+  }
 } // namespace HAL {
 
 #endif // _HAL_JSEXPORT_HPP_
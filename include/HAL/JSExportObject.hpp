@@ -13,6 +13,7 @@
 #include "HAL/JSContext.hpp"
 #include "HAL/JSString.hpp"
 #include "HAL/JSValue.hpp"
+#include "HAL/JSArguments.hpp"
 
 #include <vector>
 #include <unordered_set>
@@ -49,21 +50,25 @@ namespace HAL {
      
      @abstract Return the JSObject of this JavaScript value.
      
-     @result The JSObject of this JavaScript value.
+     @discussion This is a direct read of the back-reference set when
+     the JavaScript object was initialized, so it takes no locks and
+     does no lookup.
+     
+     @result The JSObject of this JavaScript value, or an Error object
+     if this native object is not owned by a JavaScript object.
      */
     virtual JSObject get_object() HAL_NOEXCEPT final;
     
     JSExportObject(const JSContext& js_context) HAL_NOEXCEPT;
     
+    // The back-reference to the owning JavaScript object belongs to
+    // this instance only, so it is never copied, moved or swapped.
     virtual ~JSExportObject() HAL_NOEXCEPT;
-    JSExportObject(const JSExportObject&)            = default;
-    JSExportObject& operator=(const JSExportObject&) = default;
-#ifdef HAL_MOVE_CTOR_AND_ASSIGN_DEFAULT_ENABLE
-    JSExportObject(JSExportObject&&)                 = default;
-    JSExportObject& operator=(JSExportObject&&)      = default;
-#endif
-
-    void swap(JSExportObject&) HAL_NOEXCEPT;
+    JSExportObject(const JSExportObject&)            HAL_NOEXCEPT;
+    JSExportObject(JSExportObject&&)                 HAL_NOEXCEPT;
+    JSExportObject& operator=(const JSExportObject&) HAL_NOEXCEPT;
+    JSExportObject& operator=(JSExportObject&&)      HAL_NOEXCEPT;
+    void swap(JSExportObject&)                       HAL_NOEXCEPT;
     
     static void JSExportInitialize();
 		
@@ -92,11 +97,42 @@ namespace HAL {
      JavaScript 'new' expression.
     */
     virtual void postCallAsConstructor(const JSContext& js_context, const std::vector<JSValue>& arguments);
+
+    /*!
+     @method
+
+     @abstract constructor callback which is invoked when your
+     JavaScript object is created as the result of being called in a
+     JavaScript 'new' expression, receiving its arguments as a
+     JSArguments.
+
+     @discussion Override this instead of the std::vector<JSValue>
+     overload to avoid copying and protecting the arguments. The
+     default implementation calls the std::vector<JSValue> overload.
+
+     @param js_context The JSContext in which your JavaScript object
+     is created.
+
+     @param arguments The arguments of the JavaScript 'new'
+     expression, which are only valid until this method returns.
+    */
+    virtual void postCallAsConstructor(const JSContext& js_context, const JSArguments& arguments);
 		
   private:
     
+    // JSExportClass sets js_object_ref__ when it initializes the
+    // JavaScript object that owns this native object.
+    template<typename T>
+    friend class detail::JSExportClass;
+    
     JSContext js_context__;
     
+    // This is intentionally not protected. The JavaScript object owns
+    // this native object and deletes it when finalized, so the
+    // JavaScript object is alive for as long as this pointer is
+    // reachable, and protecting it would keep both alive forever.
+    JSObjectRef js_object_ref__ { nullptr };
+    
 #undef  HAL_JSEXPORTOBJECT_LOCK_GUARD
 #ifdef  HAL_THREAD_SAFE
     std::recursive_mutex mutex__;
@@ -10,8 +10,9 @@
 #define _HAL_JSFUNCTION_HPP_
 
 #include "HAL/JSObject.hpp"
+#include "HAL/JSArguments.hpp"
+#include "HAL/detail/JSNativeFunction.hpp"
 #include <functional>
-#include <unordered_map>
 
 namespace HAL {
 
@@ -26,39 +27,88 @@ namespace HAL {
 
   The only way to create a JSFunction is by using the
   JSContext::CreateFunction member function.
+
+  A JSFunction created with a native callback keeps its own copy of
+  the callback for as long as JavaScript can call it, even after every
+  JSFunction referring to it has been destroyed. The callback may
+  capture the JSContext it was created with, or JSValues and JSObjects
+  of that context: once nothing but such callbacks refers to the
+  context they are destroyed, and calling their functions from
+  another context in the same group then does nothing. Handles of
+  other contexts captured by the callback keep those contexts alive
+  for as long as the function.
 */
 class HAL_EXPORT JSFunction final : public JSObject HAL_PERFORMANCE_COUNTER2(JSFunction) {
 
-public:
-    
-    static void RegisterJSFunctionCallback(JSObjectRef js_object_ref, JSFunctionCallback);
-    static void UnRegisterJSFunctionCallback(JSObjectRef js_object_ref);
-    static JSFunctionCallback FindJSFunctionCallback(JSObjectRef js_object_ref);
-
-    virtual ~JSFunction() HAL_NOEXCEPT;
-
 private:
     
     // Only a JSContext can create a JSFunction.
     friend JSContext;
     
+    // JSObject::GetPrivate and SetPrivate need to tell native
+    // functions apart from JSExport objects.
+    friend JSObject;
+    
+    // A JSContextGroup destroys the callbacks finalized while releasing
+    // it.
+    friend JSContextGroup;
+    
+    // A JSContextLifetime detaches the callbacks that are the only
+    // references left to its context.
+    friend detail::JSContextLifetime;
+    
     JSFunction(const JSContext& js_context, const JSString& body, const std::vector<JSString>& parameter_names, const JSString& function_name, const JSString& source_url, int starting_line_number);
     JSFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionCallback& callback);
+    JSFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionArgumentsCallback& callback);
 
     static JSObjectRef MakeFunction(const JSContext& js_context, const JSString& body, const std::vector<JSString>& parameter_names, const JSString& function_name, const JSString& source_url, int starting_line_number);
 
+    // A function with a native callback is an object of this class,
+    // which owns a copy of the callback as its private data and
+    // deletes it when the object is finalized. Calling the function is
+    // then just a pointer read. The callbacks are also tracked per
+    // JSContextLifetime, together with the number of references to it
+    // that each one captured.
+    static JSClassRef  GetNativeFunctionClass() HAL_NOEXCEPT;
+    static bool        IsNativeFunction(JSContextRef context_ref, JSObjectRef object_ref) HAL_NOEXCEPT;
+    static JSObjectRef MakeFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionArgumentsCallback& callback);
     static JSValueRef  JSObjectCallAsFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception);
-    static JSObjectRef MakeFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionCallback& callback);
-
-    // Silence 4251 on Windows since private member variables do not
-    // need to be exported from a DLL.
-#pragma warning(push)
-#pragma warning(disable: 4251)
-    static std::unordered_map<std::intptr_t, JSFunctionCallback> js_object_ref_to_js_function__;
-#pragma warning(pop)
+    static void        JSObjectFinalizeCallback(JSObjectRef function_ref);
+    
+    // JavaScriptCore doesn't allow calling into it while it finalizes
+    // objects, but destroying a callback may release the values it
+    // captured. So the finalizer only queues the callback, and it is
+    // destroyed by the next call of this function.
+    static void        DestroyFinalizedCallbacks() HAL_NOEXCEPT;
+    
+    // Detach the callbacks of the given context's native functions
+    // from their functions and destroy them.
+    static void        DetachCallbacks(detail::JSContextLifetime* js_context_lifetime) HAL_NOEXCEPT;
+    
+    // Stop tracking the callbacks of the given context's native
+    // functions, which remain attached, because its JSContextLifetime
+    // is about to be reused.
+    static void        ForgetCallbacks(detail::JSContextLifetime* js_context_lifetime) HAL_NOEXCEPT;
+    
+    // Adapt a callback taking its arguments as a std::vector<JSValue>
+    // to a callback taking a JSArguments.
+    static JSFunctionArgumentsCallback ToArgumentsCallback(const JSFunctionCallback& callback);
 
 };
 
+template<typename R, typename... Args>
+JSFunction JSContext::CreateFunction(R (*function)(Args...)) const {
+  return CreateFunction(JSString(), function);
+}
+
+template<typename R, typename... Args>
+JSFunction JSContext::CreateFunction(const JSString& function_name, R (*function)(Args...)) const {
+  const JSFunctionArgumentsCallback callback = [function](const JSArguments& arguments, JSObject& this_object) {
+    return detail::InvokeJSNativeFunction(this_object.get_context(), function, arguments);
+  };
+  return CreateFunction(function_name, callback);
+}
+
 } // namespace HAL {
 
 #endif // _HAL_JSFUNCTION_HPP_
@@ -0,0 +1,80 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSHANDLESCOPE_HPP_
+#define _HAL_JSHANDLESCOPE_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+
+#include <cstddef>
+
+namespace HAL {
+
+  /*!
+   @class
+
+   @discussion A JSHandleScope marks the region of native code in
+   which JSLocal handles may be created and used.
+
+   JavaScriptCore scans the machine stack conservatively, so a
+   JSValueRef held in a stack variable can not be collected while the
+   function holding it is running. A JSLocal relies on this instead of
+   calling JSValueProtect, and a JSHandleScope is the RAII object that
+   documents (and in debug builds asserts) the lifetime of the
+   JSLocals created inside it.
+
+   Every JSExport callback opens a JSHandleScope before calling into
+   your code, so you only need to create one yourself when you create
+   JSLocals outside of a JSExport callback.
+
+   JSHandleScopes nest and are per thread. Like JSLocals they must
+   live on the stack.
+   */
+  class HAL_EXPORT JSHandleScope final {
+
+  public:
+
+    JSHandleScope()                                HAL_NOEXCEPT;
+    ~JSHandleScope()                               HAL_NOEXCEPT;
+    JSHandleScope(const JSHandleScope&)            = delete;
+    JSHandleScope(JSHandleScope&&)                 = delete;
+    JSHandleScope& operator=(const JSHandleScope&) = delete;
+    JSHandleScope& operator=(JSHandleScope&&)      = delete;
+
+    /*!
+     @method
+
+     @abstract Determine whether a JSHandleScope is open on the
+     calling thread.
+
+     @result true if at least one JSHandleScope is open on the calling
+     thread.
+     */
+    static bool IsOpen() HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Return the number of nested JSHandleScopes open on the
+     calling thread.
+
+     @result The number of nested JSHandleScopes open on the calling
+     thread.
+     */
+    static std::size_t GetDepth() HAL_NOEXCEPT;
+
+  private:
+
+    // Prevent heap based objects.
+    static void * operator new(std::size_t);     // #1: To prevent allocation of scalar objects
+    static void * operator new [] (std::size_t); // #2: To prevent allocation of array of objects
+  };
+
+} // namespace HAL {
+
+#endif // _HAL_JSHANDLESCOPE_HPP_
@@ -0,0 +1,186 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSLOCAL_HPP_
+#define _HAL_JSLOCAL_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/JSValue.hpp"
+
+#include <string>
+
+namespace HAL {
+  class JSString;
+  class JSObject;
+
+  /*!
+   @class
+
+   @discussion A JSLocal is a lightweight, non-owning handle to a
+   JavaScript value that is only valid inside the JSHandleScope it was
+   created in.
+
+   Unlike a JSValue, a JSLocal does not call JSValueProtect or
+   JSValueUnprotect, and copying one only copies two pointers. This
+   makes JSLocals the cheap way to inspect the values that
+   JavaScriptCore hands to a JSExport callback.
+
+   A JSLocal must not outlive its JSHandleScope and must not be
+   stored anywhere but the stack (e.g. not in a member variable or a
+   std::vector), because nothing else keeps its value from being
+   garbage collected. Call ToPersistent to promote it to a JSValue
+   when the value must outlive the scope.
+   */
+  class HAL_EXPORT JSLocal final {
+
+  public:
+
+    /*!
+     @method
+
+     @abstract Promote this JSLocal to a JSValue that keeps its
+     JavaScript value alive for as long as the JSValue exists.
+
+     @result A JSValue for the same JavaScript value.
+     */
+    JSValue ToPersistent() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to a JSObject, which keeps the
+     resulting JavaScript object alive for as long as the JSObject
+     exists.
+
+     @result A JSObject with the result of conversion.
+
+     @throws std::runtime_error if this JSLocal could not be converted
+     to a JSObject.
+     */
+    explicit operator JSObject() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to a JSString.
+
+     @result A JSString with the result of conversion.
+     */
+    explicit operator JSString() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to a std::string.
+
+     @result A std::string with the result of conversion.
+     */
+    explicit operator std::string() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to a boolean.
+
+     @result The boolean result of conversion.
+     */
+    explicit operator bool() const HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to a double.
+
+     @result The double result of conversion.
+     */
+    explicit operator double() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to an int32_t according to the
+     rules specified by the JavaScript language.
+
+     @result The int32_t result of conversion.
+     */
+    explicit operator int32_t() const;
+
+    /*!
+     @method
+
+     @abstract Convert this JSLocal to an uint32_t according to the
+     rules specified by the JavaScript language.
+
+     @result The uint32_t result of conversion.
+     */
+    explicit operator uint32_t() const {
+      return operator int32_t();
+    }
+
+    /*!
+     @method
+
+     @abstract Return this JavaScript value's type.
+
+     @result A value of type JSValue::Type that identifies this
+     JavaScript value's type.
+     */
+    JSValue::Type GetType() const HAL_NOEXCEPT;
+
+    bool IsUndefined() const HAL_NOEXCEPT;
+    bool IsNull()      const HAL_NOEXCEPT;
+    bool IsBoolean()   const HAL_NOEXCEPT;
+    bool IsNumber()    const HAL_NOEXCEPT;
+    bool IsString()    const HAL_NOEXCEPT;
+    bool IsObject()    const HAL_NOEXCEPT;
+
+    /*!
+     @method
+
+     @abstract Return the execution context of this JavaScript value.
+
+     @result The the execution context of this JavaScript value.
+     */
+    JSContext get_context() const HAL_NOEXCEPT;
+
+    // For interoperability with the JavaScriptCore C API.
+    JSLocal(JSContextRef js_context_ref, JSValueRef js_value_ref) HAL_NOEXCEPT;
+
+    // For interoperability with the JavaScriptCore C API.
+    explicit operator JSValueRef() const HAL_NOEXCEPT {
+      return js_value_ref__;
+    }
+
+    JSLocal()                          = delete;
+    ~JSLocal()                         = default;
+    JSLocal(const JSLocal&)            = default;
+    JSLocal& operator=(const JSLocal&) = default;
+
+  private:
+
+    // Prevent heap based objects.
+    static void * operator new(std::size_t);     // #1: To prevent allocation of scalar objects
+    static void * operator new [] (std::size_t); // #2: To prevent allocation of array of objects
+
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    JSContextRef js_context_ref__ { nullptr };
+    JSValueRef   js_value_ref__   { nullptr };
+#pragma warning(pop)
+  };
+
+  inline
+  std::string to_string(const JSLocal& js_local) {
+    return static_cast<std::string>(js_local);
+  }
+
+} // namespace HAL {
+
+#endif // _HAL_JSLOCAL_HPP_
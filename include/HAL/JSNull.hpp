@@ -31,6 +31,11 @@ private:
 	explicit JSNull(const JSContext& js_context)
 			: JSValue(js_context, JSValueMakeNull(static_cast<JSContextRef>(js_context))) {
 	}
+	
+	// Refer to the JSContext's cached null value.
+	JSNull(const JSContext& js_context, JSValueRef cached_js_value_ref) HAL_NOEXCEPT
+			: JSValue(js_context, cached_js_value_ref, Type::Null) {
+	}
 };
 
 } // namespace HAL {
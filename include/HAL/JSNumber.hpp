@@ -36,7 +36,7 @@ public:
     @result The JSNumber with a new value of the given number.
   */
 	JSNumber& operator=(double number) {
-		return operator=(JSNumber(get_context(), number));
+		return operator=(get_context().CreateNumber(number));
   }
 
 	/*!
@@ -49,7 +49,7 @@ public:
     @result The JSNumber with the new value of the given number.
   */
 	JSNumber& operator=(int32_t number) {
-		return operator=(JSNumber(get_context(), number));
+		return operator=(get_context().CreateNumber(number));
   }
 
 	/*!
@@ -62,7 +62,7 @@ public:
     @result The JSNumber with the new value of the given number.
   */
 	JSNumber& operator=(uint32_t number) {
-		return operator=(JSNumber(get_context(), number));
+		return operator=(get_context().CreateNumber(number));
   }
 
 private:
@@ -70,8 +70,9 @@ private:
 	// Only a JSContext can create a JSNumber.
 	friend JSContext;
 
-	explicit JSNumber(const JSContext& js_context, double number = 0)
-			: JSValue(js_context, JSValueMakeNumber(static_cast<JSContextRef>(js_context), number)) {
+	// The JSValueRef is only made when JavaScriptCore needs it.
+	explicit JSNumber(const JSContext& js_context, double number = 0) HAL_NOEXCEPT
+			: JSValue(js_context, number, Deferred()) {
 	}
 	
 	JSNumber(const JSContext& js_context, int32_t number)
@@ -81,6 +82,11 @@ private:
 	JSNumber(const JSContext& js_context, uint32_t number)
 			: JSNumber(js_context, static_cast<double>(number)) {
 	}
+	
+	// Refer to one of the JSContext's cached numbers.
+	JSNumber(const JSContext& js_context, JSValueRef cached_js_value_ref) HAL_NOEXCEPT
+			: JSValue(js_context, cached_js_value_ref, Type::Number) {
+	}
 };
 
 } // namespace HAL {
@@ -11,7 +11,9 @@
 
 #include "HAL/detail/JSBase.hpp"
 #include "HAL/JSContext.hpp"
+#include "HAL/JSExpected.hpp"
 #include "HAL/JSPropertyAttribute.hpp"
+#include "HAL/JSPropertyKey.hpp"
 #include "HAL/JSPropertyNameArray.hpp"
 
 #include <memory>
@@ -70,6 +72,18 @@ namespace HAL {
      */
     virtual bool HasProperty(const JSString& property_name) const HAL_NOEXCEPT final;
     
+    /*!
+     @method
+     
+     @abstract Determine whether this JavaScript object has a property
+     named by a compile-time key, e.g. HAL_KEY("name").
+     
+     @param property_key The key of the property.
+     
+     @result true if this JavaScript object has the property.
+     */
+    virtual bool HasProperty(const JSPropertyKey& property_key) const HAL_NOEXCEPT final;
+    
     /*!
      @method
      
@@ -85,6 +99,22 @@ namespace HAL {
      */
     virtual JSValue GetProperty(const JSString& property_name) const final;
     
+    /*!
+     @method
+     
+     @abstract Return a property of this JavaScript object named by a
+     compile-time key, e.g. HAL_KEY("name").
+     
+     @param property_key The key of the property to get.
+     
+     @result The property's value if this JavaScript object has the
+     property, otherwise JSUndefined.
+     
+     @throws std::runtime_error if getting the property threw a
+     JavaScript exception.
+     */
+    virtual JSValue GetProperty(const JSPropertyKey& property_key) const final;
+    
     /*!
      @method
      
@@ -104,6 +134,23 @@ namespace HAL {
      */
     virtual JSValue GetProperty(unsigned property_index) const final;
     
+    /*!
+     @method
+     
+     @abstract Return a property of this JavaScript object without
+     throwing a C++ exception, e.g. in a hot path where a getter is
+     expected to throw.
+     
+     @param property_name The name of the property to get.
+     
+     @result The property's value if this JavaScript object has the
+     property, otherwise JSUndefined, or the JavaScript exception if
+     getting the property threw one.
+     */
+    virtual JSExpected<JSValue> TryGetProperty(const JSString& property_name) const final;
+    virtual JSExpected<JSValue> TryGetProperty(const JSPropertyKey& property_key) const final;
+    virtual JSExpected<JSValue> TryGetProperty(unsigned property_index) const final;
+    
     /*!
      @method
      
@@ -124,6 +171,25 @@ namespace HAL {
      */
     virtual void SetProperty(const JSString& property_name, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes = {}) final;
     
+    /*!
+     @method
+     
+     @abstract Set a property named by a compile-time key, e.g.
+     HAL_KEY("name"), on this JavaScript object with an optional set
+     of attributes.
+     
+     @param property_key The key of the property to set.
+     
+     @param value The value of the the property to set.
+     
+     @param attributes An optional set of property attributes to give
+     to the property.
+     
+     @throws std::runtime_error if setting the property threw a
+     JavaScript exception.
+     */
+    virtual void SetProperty(const JSPropertyKey& property_key, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes = {}) final;
+    
     /*!
      @method
      
@@ -142,6 +208,24 @@ namespace HAL {
      */
     virtual void SetProperty(unsigned property_index, const JSValue& property_value) final;
     
+    /*!
+     @method
+     
+     @abstract Set a property on this JavaScript object without
+     throwing a C++ exception.
+     
+     @param property_name The name of the property to set.
+     
+     @param property_value The value of the the property to set.
+     
+     @param attributes An optional set of property attributes to give
+     to the property.
+     
+     @result Nothing, or the JavaScript exception if setting the
+     property threw one.
+     */
+    virtual JSExpected<void> TrySetProperty(const JSString& property_name, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes = {}) final;
+    
     /*!
      @method
      
@@ -156,6 +240,21 @@ namespace HAL {
      */
     virtual bool DeleteProperty(const JSString& property_name) final;
     
+    /*!
+     @method
+     
+     @abstract Delete a property named by a compile-time key, e.g.
+     HAL_KEY("name"), from this JavaScript object.
+     
+     @param property_key The key of the property to delete.
+     
+     @result true if the property was deleted.
+     
+     @throws std::runtime_error if deleting the property threw a
+     JavaScript exception.
+     */
+    virtual bool DeleteProperty(const JSPropertyKey& property_key) final;
+    
     /*!
      @method
      
@@ -268,6 +367,38 @@ namespace HAL {
     virtual JSObject CallAsConstructor(const std::vector<JSString>& arguments) final;
     virtual JSObject CallAsConstructor(const std::vector<JSValue>&  arguments) final;
     
+    /*!
+     @method
+     
+     @abstract Call this JavaScript object as a function without
+     throwing a C++ exception.
+     
+     @param arguments The JSValue arguments to pass to the function.
+     
+     @param this_object The object to use as 'this'.
+     
+     @result The function's return value, or the JavaScript exception
+     if either this JavaScript object can't be called as a function
+     (an Error), or calling the function threw one.
+     */
+    virtual JSExpected<JSValue> TryCallAsFunction(const std::vector<JSValue>& arguments, JSObject this_object) final;
+    
+    /*!
+     @method
+     
+     @abstract Call this JavaScript object as a constructor without
+     throwing a C++ exception.
+     
+     @param arguments The JSValue arguments to pass to the
+     constructor.
+     
+     @result The JavaScript object of the constructor's return value,
+     or the JavaScript exception if either this JavaScript object
+     can't be called as a constructor (an Error), or calling the
+     constructor threw one.
+     */
+    virtual JSExpected<JSObject> TryCallAsConstructor(const std::vector<JSValue>& arguments = {}) final;
+    
     /*!
      @method
      
@@ -337,18 +468,53 @@ namespace HAL {
     template<typename T>
     std::shared_ptr<T> GetPrivate() const HAL_NOEXCEPT;
     
-    
+    // Like a JSValue, a moved-from JSObject is empty: it may be copied,
+    // assigned to, assigned from or destroyed.
     virtual ~JSObject()            HAL_NOEXCEPT;
     JSObject(const JSObject&)      HAL_NOEXCEPT;
     JSObject(JSObject&&)           HAL_NOEXCEPT;
     JSObject& operator=(JSObject);
     void swap(JSObject&)           HAL_NOEXCEPT;
     
+    /*!
+     @method
+     
+     @abstract Return the JavaScript object that owns the given native
+     object.
+     
+     @discussion This reads the native object's direct back-reference
+     to its JavaScript object, so it is O(1) and takes no locks.
+     
+     @param js_context The execution context to use if the native
+     object has no JavaScript object.
+     
+     @param private_data The native object.
+     
+     @result The JavaScript object that owns private_data, or an Error
+     object if private_data is not owned by a JavaScript object.
+     */
+    static JSObject FindJSObjectFromPrivateData(JSContext js_context, JSExportObject* private_data);
+    
+    /*!
+     @method
+     
+     @abstract Return the JavaScript object that owns the given native
+     object, passed as the untyped private data of its JavaScript
+     object.
+     
+     @param js_context The execution context to use if the native
+     object has no JavaScript object.
+     
+     @param private_data The native object, as returned by
+     JSObject::GetPrivate.
+     
+     @result The JavaScript object that owns private_data, or an Error
+     object if private_data is not owned by a JavaScript object.
+     */
     static JSObject FindJSObjectFromPrivateData(JSContext js_context, void* private_data);
-    static void     UnRegisterPrivateData(void* private_data);
-    static void     RegisterPrivateData(JSObjectRef js_object_ref, void* private_data);
+    
     // The JSExportClass static functions also need access to
-    // GetPrivate and SetPrivate.
+    // GetJSExportPrivate and SetJSExportPrivate.
     template<typename T>
     friend class detail::JSExportClass;
 
@@ -390,7 +556,8 @@ namespace HAL {
      @abstract Gets this object's private data.
      
      @result A void* that is this object's private data, if the object
-     has private data, otherwise nullptr.
+     has private data, otherwise nullptr. A function created with a
+     native callback has no private data of its own.
      */
     virtual void* GetPrivate() const HAL_NOEXCEPT final;
     
@@ -404,7 +571,8 @@ namespace HAL {
      
      @param data A void* to set as this object's private data.
      
-     @result true if this object can store private data.
+     @result true if this object can store private data. A function
+     created with a native callback can't.
      */
     virtual bool SetPrivate(void* data) const HAL_NOEXCEPT final;
     
@@ -429,8 +597,22 @@ namespace HAL {
      */
     virtual void GetPropertyNames(const JSPropertyNameAccumulator& accumulator) const HAL_NOEXCEPT final;
     
-    static void     RegisterJSContext(JSContextRef js_context_ref, JSObjectRef js_object_ref);
-    static void     UnRegisterJSContext(JSObjectRef js_object_ref);
+    /*!
+     @method
+     
+     @abstract Wrap a JSObjectRef received in a JavaScriptCore C API
+     callback.
+     
+     @discussion The owning context is derived from the callback's
+     JSContextRef, so no global bookkeeping is needed and wrappers can
+     be created and destroyed on any thread without contention.
+     
+     @param js_context_ref The JSContextRef passed to the callback.
+     
+     @param js_object_ref The JSObjectRef passed to the callback.
+     
+     @result The JSObject for js_object_ref.
+     */
     static JSObject FindJSObject(JSContextRef js_context_ref, JSObjectRef js_object_ref);
     
     // JSContext (and already friended JSExportClass) use the
@@ -439,15 +621,19 @@ namespace HAL {
 
     JSObject(const JSContext& js_context, const JSClass& js_class, void* private_data = nullptr);
     
+    // Get and set the private data of an object already known to be a
+    // JSExport object, without checking whether it is a native
+    // function.
+    void* GetJSExportPrivate() const HAL_NOEXCEPT;
+    bool  SetJSExportPrivate(void* data) const HAL_NOEXCEPT;
+    
     JSContext js_context__;
 
     // Silence 4251 on Windows since private member variables do not
     // need to be exported from a DLL.
 #pragma warning(push)
 #pragma warning(disable: 4251)
-    JSObjectRef js_object_ref__;
-    static std::unordered_map<std::intptr_t, std::tuple<std::intptr_t, std::size_t>> js_object_ref_to_js_context_ref_map__;
-    static std::unordered_map<std::intptr_t, std::intptr_t> js_private_data_to_js_object_ref_map__;
+    JSObjectRef js_object_ref__ { nullptr };
 #pragma warning(pop)
 
 #undef  HAL_JSOBJECT_LOCK_GUARD
@@ -0,0 +1,119 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSPROPERTYKEY_HPP_
+#define _HAL_JSPROPERTYKEY_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/detail/HashUtilities.hpp"
+#include "HAL/JSString.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace HAL {
+  
+  /*!
+   @class
+   
+   @discussion A JSPropertyKey is a property name known at compile
+   time. Create one with the HAL_KEY macro and pass it to
+   JSObject::GetProperty, SetProperty, HasProperty or DeleteProperty:
+   
+   const auto name = js_object.GetProperty(HAL_KEY("name"));
+   
+   Each use of HAL_KEY names a single, constant-initialized
+   JSPropertyKey whose hash value is computed by the compiler (or when
+   the key is first used, on compilers without constexpr). Its
+   JSString is interned (see JSString::Intern) the first time the key
+   is used and reused from then on, so after the first call using a
+   JSPropertyKey costs no allocation, transcoding or hashing.
+   */
+  class HAL_EXPORT JSPropertyKey final {
+    
+  public:
+    
+    /*!
+     @method
+     
+     @abstract Create a property key from a string literal. Prefer
+     the HAL_KEY macro, which supplies the length and gives the key
+     static storage duration.
+     
+     @param string The UTF-8 string literal naming the property.
+     
+     @param length The length of string in bytes.
+     */
+    HAL_CONSTEXPR JSPropertyKey(const char* string, std::size_t length) HAL_NOEXCEPT
+    : string__(string)
+    , length__(length)
+    , is_ascii__(detail::is_ascii(string, length))
+    , hash_value__(detail::fnv1a_utf16_ascii(string, length)) {
+    }
+    
+    /*!
+     @method
+     
+     @abstract Return the name of this property key as a JSString,
+     creating it the first time it is requested.
+     
+     @result The interned JSString naming this property key.
+     */
+    const JSString& get_js_string() const;
+    
+    /*!
+     @method
+     
+     @abstract Return the hash value of this property key, which is
+     the same as the hash value of its JSString. For ASCII names it is
+     computed at compile time.
+     
+     @result The hash value of this property key.
+     */
+    std::size_t hash_value() const {
+      return is_ascii__ ? hash_value__ : get_js_string().hash_value();
+    }
+    
+    operator const JSString&() const {
+      return get_js_string();
+    }
+    
+    JSPropertyKey(const JSPropertyKey&)            = delete;
+    JSPropertyKey(JSPropertyKey&&)                 = delete;
+    JSPropertyKey& operator=(const JSPropertyKey&) = delete;
+    JSPropertyKey& operator=(JSPropertyKey&&)      = delete;
+    
+  private:
+    
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    const char*                              string__;
+    std::size_t                              length__;
+    bool                                     is_ascii__;
+    std::size_t                              hash_value__;
+    mutable std::atomic<const JSString*>     js_string__ { nullptr };
+#pragma warning(pop)
+  };
+  
+} // namespace HAL {
+
+/*!
+ @define
+ 
+ @abstract Return the JSPropertyKey for the given string literal, e.g.
+ HAL_KEY("length").
+ */
+#define HAL_KEY(string_literal) \
+  ([]() -> const HAL::JSPropertyKey& { \
+    static const HAL::JSPropertyKey key(string_literal "", sizeof(string_literal) - 1); \
+    return key; \
+  }())
+
+#endif // _HAL_JSPROPERTYKEY_HPP_
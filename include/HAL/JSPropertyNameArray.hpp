@@ -100,7 +100,7 @@ namespace HAL {
     // need to be exported from a DLL.
 #pragma warning(push)
 #pragma warning(disable: 4251)
-    JSPropertyNameArrayRef js_property_name_array_ref__;
+    JSPropertyNameArrayRef js_property_name_array_ref__ { nullptr };
 #pragma warning(pop)
     
 #undef  HAL_JSPROPERTYNAMEARRAY_LOCK_GUARD
@@ -18,6 +18,11 @@
 #include <vector>
 #include <utility>
 #include <mutex>
+#include <atomic>
+
+#if HAL_STRING_VIEW_ENABLE
+#include <string_view>
+#endif
 
 namespace HAL {
   class JSString;
@@ -45,6 +50,12 @@ namespace HAL {
    Specifically, a JSString is comparable with an equivalence relation,
    provides a strict weak ordering, and provides a custom hash
    function.
+   
+   A JSString's UTF-8 representation and hash value are computed the
+   first time they are needed and then cached, so a JSString that is
+   only passed back to JavaScriptCore never pays for either. The
+   caches are filled without locking and are safe to fill from
+   multiple threads.
    */
     class HAL_EXPORT JSString final HAL_PERFORMANCE_COUNTER1(JSString) {
       
@@ -85,6 +96,100 @@ namespace HAL {
        */
       JSString(const std::string& string) HAL_NOEXCEPT;
       
+      /*!
+       @method
+       
+       @abstract Create a JavaScript string from a UTF8 string that
+       need not be null-terminated, e.g. a slice of a larger buffer.
+       
+       @param string The UTF8 string to copy into the new JSString.
+       
+       @param length The length of string in bytes.
+       
+       @result A JSString containing string.
+       */
+      JSString(const char* string, std::size_t length) HAL_NOEXCEPT;
+      
+      /*!
+       @method
+       
+       @abstract Create a JavaScript string from a UTF16 string that
+       need not be null-terminated.
+       
+       @param string The UTF16 string to copy into the new JSString.
+       
+       @param length The length of string in UTF16 code units.
+       
+       @result A JSString containing string.
+       */
+      JSString(const JSChar* string, std::size_t length) HAL_NOEXCEPT;
+      
+#if HAL_STRING_VIEW_ENABLE
+      /*!
+       @method
+       
+       @abstract Create a JavaScript string from a UTF8 string view.
+       
+       @param string The UTF8 string to copy into the new JSString.
+       
+       @result A JSString containing string.
+       */
+      explicit JSString(std::string_view string) HAL_NOEXCEPT
+      : JSString(string.data(), string.size()) {
+      }
+      
+      /*!
+       @method
+       
+       @abstract Create a JavaScript string from a UTF16 string view.
+       
+       @param string The UTF16 string to copy into the new JSString.
+       
+       @result A JSString containing string.
+       */
+      explicit JSString(std::u16string_view string) HAL_NOEXCEPT
+      : JSString(reinterpret_cast<const JSChar*>(string.data()), string.size()) {
+      }
+      
+      /*!
+       @method
+       
+       @abstract Return a view of this JavaScript string's UTF16 code
+       units without copying them.
+       
+       @result A view of this JavaScript string's UTF16 code units,
+       which is valid for as long as this JSString exists. A
+       moved-from JSString has an empty view.
+       */
+      std::u16string_view u16view() const HAL_NOEXCEPT {
+        if (!js_string_ref__) {
+          return std::u16string_view();
+        }
+        return std::u16string_view(reinterpret_cast<const char16_t*>(JSStringGetCharactersPtr(js_string_ref__)), JSStringGetLength(js_string_ref__));
+      }
+#endif
+      
+      /*!
+       @method
+       
+       @abstract Return the interned JavaScript string with the given
+       UTF-8 value, creating it the first time it is requested.
+       
+       @discussion An interned JSString is shared by every caller and
+       every thread, and lives until the process exits. Interning is
+       meant for property names that are used over and over again,
+       e.g. "length". Intern a name once and keep the returned
+       reference, typically in a function-local static:
+       
+       static const auto& length = JSString::Intern("length");
+       const auto js_value = js_object.GetProperty(length);
+       
+       @param string The null-terminated UTF8 string to intern.
+       
+       @result The interned JSString containing string.
+       */
+      static const JSString& Intern(const std::string& string);
+      
       /*!
        @method
        
@@ -128,7 +233,36 @@ namespace HAL {
        */
       operator std::string() const HAL_NOEXCEPT;
       
-      std::size_t hash_value() const;
+      /*!
+       @method
+       
+       @abstract Convert this JavaScript string to UTF-8 into the
+       caller's buffer, followed by a null terminator.
+       
+       @discussion If the buffer is too small then as many complete
+       characters as fit are written. Use size() * 3 + 1 bytes to be
+       sure the whole string fits.
+       
+       @param buffer The buffer to write into.
+       
+       @param buffer_size The size of buffer in bytes, including room
+       for the null terminator.
+       
+       @result The number of bytes written, not counting the null
+       terminator.
+       */
+      std::size_t CopyUTF8To(char* buffer, std::size_t buffer_size) const HAL_NOEXCEPT;
+      
+      /*!
+       @method
+       
+       @abstract Return the hash value of this JavaScript string, which
+       is computed from its UTF-16 code units without converting it to
+       UTF-8.
+       
+       @result The hash value of this JavaScript string.
+       */
+      std::size_t hash_value() const HAL_NOEXCEPT;
       
       ~JSString()                   HAL_NOEXCEPT;
       JSString(const JSString&)     HAL_NOEXCEPT;
@@ -173,11 +307,15 @@ namespace HAL {
     // need to be exported from a DLL.
 #pragma warning(push)
 #pragma warning(disable: 4251)
-      JSStringRef    js_string_ref__ { nullptr };
-      std::string    string__;
-      std::size_t    hash_value__;
+      JSStringRef                              js_string_ref__ { nullptr };
+      mutable std::atomic<const std::string*>  string__        { nullptr };
+      mutable std::atomic<std::size_t>         hash_value__    { 0 };
 #pragma warning(pop)
       
+      // Return this JavaScript string converted to UTF-8, converting it
+      // on first use.
+      const std::string& GetUTF8() const HAL_NOEXCEPT;
+      
 #undef HAL_JSSTRING_LOCK_GUARD
 #ifdef  HAL_THREAD_SAFE
       std::recursive_mutex mutex__;
@@ -0,0 +1,185 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_JSSTRINGBUILDER_HPP_
+#define _HAL_JSSTRINGBUILDER_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/JSString.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#if HAL_STRING_VIEW_ENABLE
+#include <string_view>
+#endif
+
+namespace HAL {
+  
+  class JSContext;
+  class JSValue;
+  
+  /*!
+   @class
+   
+   @discussion A JSStringBuilder assembles a JavaScript string from
+   many UTF-8 and UTF-16 fragments, e.g. when generating HTML or JSON
+   natively.
+   
+   Fragments are converted to UTF-16 as they are appended and
+   accumulate in a single buffer that grows geometrically, so the
+   whole string is never transcoded at once. ToJSString copies the
+   buffer into JavaScriptCore exactly once, and the resulting JSString
+   does not keep a UTF-8 copy of its value.
+   */
+  class HAL_EXPORT JSStringBuilder final {
+    
+  public:
+    
+    JSStringBuilder() = default;
+    
+    /*!
+     @method
+     
+     @abstract Create a JSStringBuilder with room for the given number
+     of UTF-16 code units.
+     
+     @param capacity The number of UTF-16 code units to reserve.
+     */
+    explicit JSStringBuilder(std::size_t capacity);
+    
+    /*!
+     @method
+     
+     @abstract Append a null-terminated UTF-8 string.
+     
+     @param string The UTF-8 string to append.
+     
+     @result This JSStringBuilder.
+     */
+    JSStringBuilder& Append(const char* string);
+    
+    /*!
+     @method
+     
+     @abstract Append a UTF-8 string that need not be null-terminated.
+     
+     @param string The UTF-8 string to append.
+     
+     @param length The length of string in bytes.
+     
+     @result This JSStringBuilder.
+     */
+    JSStringBuilder& Append(const char* string, std::size_t length);
+    
+    /*!
+     @method
+     
+     @abstract Append a UTF-8 string.
+     
+     @param string The UTF-8 string to append.
+     
+     @result This JSStringBuilder.
+     */
+    JSStringBuilder& Append(const std::string& string);
+    
+    /*!
+     @method
+     
+     @abstract Append a UTF-16 string that need not be
+     null-terminated.
+     
+     @param string The UTF-16 string to append.
+     
+     @param length The length of string in UTF-16 code units.
+     
+     @result This JSStringBuilder.
+     */
+    JSStringBuilder& Append(const JSChar* string, std::size_t length);
+    
+    /*!
+     @method
+     
+     @abstract Append a JavaScript string.
+     
+     @param js_string The JavaScript string to append.
+     
+     @result This JSStringBuilder.
+     */
+    JSStringBuilder& Append(const JSString& js_string);
+    
+#if HAL_STRING_VIEW_ENABLE
+    JSStringBuilder& Append(std::string_view string) {
+      return Append(string.data(), string.size());
+    }
+    
+    JSStringBuilder& Append(std::u16string_view string) {
+      return Append(reinterpret_cast<const JSChar*>(string.data()), string.size());
+    }
+#endif
+    
+    /*!
+     @method
+     
+     @abstract Return the number of UTF-16 code units appended so
+     far.
+     
+     @result The number of UTF-16 code units appended so far.
+     */
+    std::size_t size() const HAL_NOEXCEPT {
+      return buffer__.size();
+    }
+    
+    bool empty() const HAL_NOEXCEPT {
+      return buffer__.empty();
+    }
+    
+    void reserve(std::size_t capacity) {
+      buffer__.reserve(capacity);
+    }
+    
+    void clear() HAL_NOEXCEPT {
+      buffer__.clear();
+    }
+    
+    /*!
+     @method
+     
+     @abstract Create a JavaScript string from everything appended so
+     far.
+     
+     @result A JSString containing everything appended so far.
+     */
+    JSString ToJSString() const HAL_NOEXCEPT;
+    
+    /*!
+     @method
+     
+     @abstract Create a JavaScript string value from everything
+     appended so far.
+     
+     @param js_context The execution context to use.
+     
+     @result A JSValue containing everything appended so far.
+     */
+    JSValue ToJSValue(const JSContext& js_context) const HAL_NOEXCEPT;
+    
+  private:
+    
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    std::vector<JSChar> buffer__;
+#pragma warning(pop)
+  };
+  
+} // namespace HAL {
+
+#endif // _HAL_JSSTRINGBUILDER_HPP_
@@ -31,6 +31,11 @@ private:
 	explicit JSUndefined(const JSContext& js_context)
 			: JSValue(js_context, JSValueMakeUndefined(static_cast<JSContextRef>(js_context))) {
 	}
+	
+	// Refer to the JSContext's cached undefined value.
+	JSUndefined(const JSContext& js_context, JSValueRef cached_js_value_ref) HAL_NOEXCEPT
+			: JSValue(js_context, cached_js_value_ref, Type::Undefined) {
+	}
 };
 
 } // namespace HAL {
@@ -12,8 +12,15 @@
 #include "HAL/detail/JSBase.hpp"
 #include "HAL/JSContext.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <ostream>
+#include <type_traits>
+#include <utility>
 
 namespace HAL {
   class JSString;
@@ -109,6 +116,68 @@ namespace HAL {
      */
     explicit operator std::string() const;
     
+    /*!
+     @method
+     
+     @abstract Convert this JSValue to a string and write it as UTF-8
+     into the caller's buffer, followed by a null terminator.
+     
+     @discussion Undefined, null, booleans and numbers that are
+     integers, NaN or infinite are formatted without asking
+     JavaScriptCore for a string. If the buffer is too small then as
+     many complete characters as fit are written.
+     
+     @param buffer The buffer to write into.
+     
+     @param buffer_size The size of buffer in bytes, including room
+     for the null terminator.
+     
+     @result The number of bytes written, not counting the null
+     terminator.
+     
+     @throws std::runtime_error if converting this JSValue to a
+     string threw a JavaScript exception.
+     */
+    std::size_t ToUTF8(char* buffer, std::size_t buffer_size) const;
+    
+    /*!
+     @method
+     
+     @abstract Convert this JSValue to a string and append it as UTF-8
+     to the given std::string, reusing its capacity.
+     
+     @param string The std::string to append to.
+     
+     @throws std::runtime_error if converting this JSValue to a
+     string threw a JavaScript exception.
+     */
+    void AppendUTF8To(std::string& string) const;
+    
+    /*!
+     @method
+     
+     @abstract Convert this JSValue to a string and write it as UTF-8
+     to the given output iterator, e.g. a fmt::memory_buffer's
+     std::back_inserter. Raw pointers are rejected because nothing
+     bounds the write; use ToUTF8(char*, std::size_t) for fixed-size
+     buffers.
+     
+     @param output The output iterator to write to.
+     
+     @result The output iterator past the last character written.
+     
+     @throws std::runtime_error if converting this JSValue to a
+     string threw a JavaScript exception.
+     */
+    template<typename OutputIterator>
+    typename std::enable_if<!std::is_pointer<OutputIterator>::value, OutputIterator>::type ToUTF8(OutputIterator output) const {
+      WriteUTF8([](void* context, const char* data, std::size_t size) {
+        auto& output = *static_cast<OutputIterator*>(context);
+        output = std::copy(data, data + size, output);
+      }, &output);
+      return output;
+    }
+    
     /*!
      @method
      
@@ -173,10 +242,67 @@ namespace HAL {
      
      @abstract Return this JavaScript value's type.
      
+     @discussion A JavaScript value's type never changes, so it is
+     only queried from JavaScriptCore the first time it is needed. The
+     Is* member functions below share the same cached type.
+     
      @result A value of type JSValue::Type that identifies this
      JavaScript value's type.
      */
-    virtual Type GetType() const HAL_NOEXCEPT final;
+    virtual Type GetType() const HAL_NOEXCEPT final {
+      const auto type = type__.load(std::memory_order_relaxed);
+      return type != kTypeUnknown ? static_cast<Type>(type) : QueryType();
+    }
+    
+    // The types Visit passes for undefined and null values.
+    struct Undefined {};
+    struct Null {};
+    
+    /*!
+     @method
+     
+     @abstract Call the given visitor with this JavaScript value
+     converted according to its type, querying the type at most once.
+     
+     @discussion The visitor is called with exactly one of
+     JSValue::Undefined, JSValue::Null, bool, double, JSString or
+     JSObject, and all of its overloads must return the same type. Use
+     HAL::overloaded to combine lambdas into a visitor:
+     
+     js_value.Visit(overloaded(
+       [](JSValue::Undefined)      { ... },
+       [](JSValue::Null)           { ... },
+       [](bool boolean)            { ... },
+       [](double number)           { ... },
+       [](const JSString& string)  { ... },
+       [](const JSObject& object)  { ... }));
+     
+     @param visitor The visitor to call.
+     
+     @result The result of calling the visitor.
+     */
+    template<typename Visitor>
+    auto Visit(Visitor&& visitor) const -> decltype(visitor(Undefined())) {
+      // JSString and JSObject are incomplete here, so name them
+      // through Visitor to defer the conversions until instantiation.
+      using String = typename std::conditional<true, JSString, Visitor>::type;
+      using Object = typename std::conditional<true, JSObject, Visitor>::type;
+      switch (GetType()) {
+        case Type::Null:
+          return visitor(Null());
+        case Type::Boolean:
+          return visitor(static_cast<bool>(*this));
+        case Type::Number:
+          return visitor(static_cast<double>(*this));
+        case Type::String:
+          return visitor(static_cast<String>(*this));
+        case Type::Object:
+          return visitor(static_cast<Object>(*this));
+        case Type::Undefined:
+        default:
+          return visitor(Undefined());
+      }
+    }
     
     /*!
      @method
@@ -187,7 +313,9 @@ namespace HAL {
      @result true if this JavaScript value's type is the undefined
      type.
      */
-    virtual bool IsUndefined() const HAL_NOEXCEPT final;
+    virtual bool IsUndefined() const HAL_NOEXCEPT final {
+      return GetType() == Type::Undefined;
+    }
     
     /*!
      @method
@@ -197,7 +325,9 @@ namespace HAL {
      
      @result true if this JavaScript value's type is the null type.
      */
-    virtual bool IsNull() const HAL_NOEXCEPT final;
+    virtual bool IsNull() const HAL_NOEXCEPT final {
+      return GetType() == Type::Null;
+    }
 		
     /*!
      @method
@@ -217,7 +347,9 @@ namespace HAL {
      
      @result true if this JavaScript value's type is the boolean type.
      */
-    virtual bool IsBoolean() const HAL_NOEXCEPT final;
+    virtual bool IsBoolean() const HAL_NOEXCEPT final {
+      return GetType() == Type::Boolean;
+    }
 
     /*!
      @method
@@ -227,7 +359,9 @@ namespace HAL {
      
      @result true if this JavaScript value's type is the number type.
      */
-    virtual bool IsNumber() const HAL_NOEXCEPT final;
+    virtual bool IsNumber() const HAL_NOEXCEPT final {
+      return GetType() == Type::Number;
+    }
     
     /*!
      @method
@@ -237,7 +371,9 @@ namespace HAL {
      
      @result true if this JavaScript value's type is the string type.
      */
-    virtual bool IsString() const HAL_NOEXCEPT final;
+    virtual bool IsString() const HAL_NOEXCEPT final {
+      return GetType() == Type::String;
+    }
     
     /*!
      @method
@@ -247,7 +383,9 @@ namespace HAL {
      
      @result true if this JavaScript value's type is the object type.
      */
-    virtual bool IsObject() const HAL_NOEXCEPT final;
+    virtual bool IsObject() const HAL_NOEXCEPT final {
+      return GetType() == Type::Object;
+    }
     
     /*!
      @method
@@ -311,6 +449,9 @@ namespace HAL {
       is_native_nullptr__ = true;
     }
     
+    // Moving a JSValue transfers its protection to the new JSValue
+    // without calling JSValueProtect. A moved-from JSValue is empty: it
+    // may be copied, assigned to, assigned from or destroyed.
     virtual ~JSValue()           HAL_NOEXCEPT;
     JSValue(const JSValue&)      HAL_NOEXCEPT;
     JSValue(JSValue&&)           HAL_NOEXCEPT;
@@ -325,7 +466,7 @@ namespace HAL {
       if (is_native_nullptr__) {
         return nullptr;
       }
-      return js_value_ref__;
+      return GetJSValueRef();
     }
      
   protected:
@@ -334,6 +475,18 @@ namespace HAL {
     friend class JSContext;
     
     JSValue(const JSContext& js_context, const JSString& js_string, bool parse_as_json = false);
+    
+    // For the primitives cached by a JSContext: refer to a JSValueRef
+    // of the given type that the JSContext keeps protected, without
+    // protecting it again. Copying or destroying such a JSValue never
+    // calls into JavaScriptCore.
+    JSValue(const JSContext& js_context, JSValueRef cached_js_value_ref, Type type) HAL_NOEXCEPT;
+    
+    // For JSNumber: hold the number itself and only make a JSValueRef
+    // for it the first time one is needed. Converting such a JSValue
+    // to a number, bool or string never calls into JavaScriptCore.
+    struct Deferred {};
+    JSValue(const JSContext& js_context, double number, Deferred) HAL_NOEXCEPT;
   
     // These classes and functions need access to operator
     // JSValueRef().
@@ -348,15 +501,59 @@ namespace HAL {
     static void * operator new(std::size_t);     // #1: To prevent allocation of scalar objects
     static void * operator new [] (std::size_t); // #2: To prevent allocation of array of objects
     
+    // Query this JavaScript value's type from JavaScriptCore and cache
+    // it.
+    Type QueryType() const HAL_NOEXCEPT;
+    
+    // Return this JavaScript value's JSValueRef, making it first if
+    // this JSValue is deferred.
+    JSValueRef GetJSValueRef() const HAL_NOEXCEPT {
+      return (deferred_state__.load(std::memory_order_acquire) == kNotDeferred) ? js_value_ref__.load(std::memory_order_relaxed) : MakeDeferredJSValueRef();
+    }
+    
+    JSValueRef MakeDeferredJSValueRef() const HAL_NOEXCEPT;
+    
+    // If this JSValue is still a deferred number then load it into
+    // number and return true.
+    bool LoadDeferredNumber(double& number) const HAL_NOEXCEPT;
+    
+    // Convert this JSValue to a string and pass it as UTF-8 to write,
+    // possibly in several pieces.
+    void WriteUTF8(void (*write)(void* context, const char* data, std::size_t size), void* context) const;
+    
     JSContext  js_context__;
 		
     bool is_native_nullptr__{false};
+    
+    // Whether js_value_ref__ is cached, and so protected, by
+    // js_context__.
+    bool is_cached__ { false };
+    
+    // Whether this JSValue is the number number__, whose JSValueRef is
+    // only made when first needed. Since several threads may share one
+    // const JSValue, the JSValueRef replaces the number like a
+    // seqlock: the thread that moves the state from kDeferred to
+    // kPublishing stores the JSValueRef and then moves it to
+    // kNotDeferred, and a thread that read the number while the state
+    // changed reads it again.
+    static const std::uint8_t kNotDeferred = 0;
+    static const std::uint8_t kDeferred    = 1;
+    static const std::uint8_t kPublishing  = 2;
+    mutable std::atomic<std::uint8_t> deferred_state__ { kNotDeferred };
+    
+    // This JavaScript value's Type, or kTypeUnknown if it hasn't been
+    // queried yet.
+    static const std::uint8_t kTypeUnknown = 0xFF;
+    mutable std::atomic<std::uint8_t> type__ { kTypeUnknown };
 
     // Silence 4251 on Windows since private member variables do not
     // need to be exported from a DLL.
 #pragma warning(push)
 #pragma warning(disable: 4251)
-    JSValueRef js_value_ref__ { nullptr };
+    union {
+      mutable std::atomic<JSValueRef> js_value_ref__ { nullptr };
+      mutable std::atomic<double>     number__;
+    };
 #pragma warning(pop)
     
 #undef  HAL_JSVALUE_LOCK_GUARD
@@ -368,6 +565,38 @@ namespace HAL {
 #endif  // HAL_THREAD_SAFE
   };
   
+  namespace detail {
+    template<typename... Functions>
+    struct Overloaded;
+    
+    template<typename Function>
+    struct Overloaded<Function> : Function {
+      explicit Overloaded(Function function) : Function(std::move(function)) {
+      }
+      using Function::operator();
+    };
+    
+    template<typename Function, typename... Functions>
+    struct Overloaded<Function, Functions...> : Function, Overloaded<Functions...> {
+      explicit Overloaded(Function function, Functions... functions) : Function(std::move(function)), Overloaded<Functions...>(std::move(functions)...) {
+      }
+      using Function::operator();
+      using Overloaded<Functions...>::operator();
+    };
+  } // namespace detail {
+  
+  /*!
+   @function
+   
+   @abstract Combine the given function objects, typically lambdas,
+   into one function object overloaded on their parameters, e.g. for
+   JSValue::Visit.
+   */
+  template<typename... Functions>
+  detail::Overloaded<typename std::decay<Functions>::type...> overloaded(Functions&&... functions) {
+    return detail::Overloaded<typename std::decay<Functions>::type...>(std::forward<Functions>(functions)...);
+  }
+  
   inline
   void swap(JSValue& first, JSValue& second) HAL_NOEXCEPT {
     first.swap(second);
@@ -7,6 +7,8 @@
 #ifndef _HAL_DETAIL_HASHUTILITIES_HPP_
 #define _HAL_DETAIL_HASHUTILITIES_HPP_
 
+#include "HAL/detail/JSBase.hpp"
+
 #include <cstddef>
 #include <functional>
 
@@ -46,6 +48,49 @@ std::size_t hash_val(const Types&... args) {
   return seed;
 }
 
+// FNV-1a, with the 32-bit or 64-bit parameters depending on the size
+// of std::size_t. HAL hashes strings by their UTF-16 code units, low
+// byte first, so that hashing a JSString never requires converting it
+// to UTF-8. The functions below are constexpr, where the compiler
+// supports it, so that the hash of a string literal can be computed at
+// compile time.
+template<std::size_t size_of_size_t>
+struct fnv1a;
+
+template<>
+struct fnv1a<4> {
+  static HAL_CONSTEXPR std::size_t offset_basis() { return 2166136261u; }
+  static HAL_CONSTEXPR std::size_t prime()        { return 16777619u; }
+};
+
+template<>
+struct fnv1a<8> {
+  static HAL_CONSTEXPR std::size_t offset_basis() { return static_cast<std::size_t>(14695981039346656037ull); }
+  static HAL_CONSTEXPR std::size_t prime()        { return static_cast<std::size_t>(1099511628211ull); }
+};
+
+inline
+HAL_CONSTEXPR std::size_t fnv1a_utf16_step(std::size_t seed, char16_t code_unit) {
+  return (((seed ^ (code_unit & 0xFF)) * fnv1a<sizeof(std::size_t)>::prime()) ^ (code_unit >> 8)) * fnv1a<sizeof(std::size_t)>::prime();
+}
+
+// Zero is reserved to mean "not computed yet".
+inline
+HAL_CONSTEXPR std::size_t fnv1a_utf16_finish(std::size_t seed) {
+  return seed == 0 ? fnv1a<sizeof(std::size_t)>::offset_basis() : seed;
+}
+
+// Hash an ASCII string as if it were the equivalent UTF-16 string.
+inline
+HAL_CONSTEXPR std::size_t fnv1a_utf16_ascii(const char* string, std::size_t length, std::size_t seed = fnv1a<sizeof(std::size_t)>::offset_basis()) {
+  return length == 0 ? fnv1a_utf16_finish(seed) : fnv1a_utf16_ascii(string + 1, length - 1, fnv1a_utf16_step(seed, static_cast<unsigned char>(*string)));
+}
+
+inline
+HAL_CONSTEXPR bool is_ascii(const char* string, std::size_t length) {
+  return length == 0 || (static_cast<unsigned char>(*string) < 0x80 && is_ascii(string + 1, length - 1));
+}
+
 }} // namespace HAL { namespace detail {
 
 #endif // _HAL_DETAIL_HASHUTILITIES_HPP_
@@ -18,6 +18,8 @@
 
 #define HAL_NOEXCEPT_ENABLE
 #define HAL_MOVE_CTOR_AND_ASSIGN_DEFAULT_ENABLE
+#define HAL_THREAD_LOCAL_ENABLE
+#define HAL_CONSTEXPR_ENABLE
 
 // See http://msdn.microsoft.com/en-us/library/b0084kay.aspx for the
 // list of Visual C++ "Predefined Macros". Visual Studio 2013 Update 3
@@ -42,6 +44,13 @@
 #undef HAL_NOEXCEPT_ENABLE
 #undef HAL_MOVE_CTOR_AND_ASSIGN_DEFAULT_ENABLE
 
+// VS 2013 doesn't support thread_local, but __declspec(thread) works
+// for variables of POD type with constant initializers.
+#undef HAL_THREAD_LOCAL_ENABLE
+
+// VS 2013 doesn't support constexpr either.
+#undef HAL_CONSTEXPR_ENABLE
+
 #endif  // #defined(_MSC_VER) && _MSC_VER <= 1800
 
 #ifdef HAL_NOEXCEPT_ENABLE
@@ -50,10 +59,33 @@
 #define HAL_NOEXCEPT
 #endif
 
+#ifdef HAL_THREAD_LOCAL_ENABLE
+#define HAL_THREAD_LOCAL thread_local
+#else
+#define HAL_THREAD_LOCAL __declspec(thread)
+#endif
+
+#ifdef HAL_CONSTEXPR_ENABLE
+#define HAL_CONSTEXPR constexpr
+#else
+#define HAL_CONSTEXPR
+#endif
+
 #ifdef HAL_THREAD_SAFE
 #include <mutex>
 #endif
 
+// Every JSContext caches the JSNumbers for the integers in this range,
+// see JSContext::CreateNumber. Define HAL_JSNUMBER_CACHE_MAX below
+// HAL_JSNUMBER_CACHE_MIN to disable the cache.
+#ifndef HAL_JSNUMBER_CACHE_MIN
+#define HAL_JSNUMBER_CACHE_MIN (-128)
+#endif
+
+#ifndef HAL_JSNUMBER_CACHE_MAX
+#define HAL_JSNUMBER_CACHE_MAX 1023
+#endif
+
 #include "HAL_EXPORT.h"
 
 #include "HAL/detail/JSLogger.hpp"
@@ -62,6 +94,30 @@
 
 #ifdef __APPLE__
 #include <TargetConditionals.h>
+#include <Availability.h>
+#endif
+
+// JSValueIsArray was added to the JavaScriptCore C API in OS X 10.11
+// and iOS 9. Add -DHAL_JSVALUEISARRAY_ENABLE=1 when linking against
+// another JavaScriptCore that has it, or =0 to call Array.isArray
+// instead.
+#ifndef HAL_JSVALUEISARRAY_ENABLE
+#if (defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 101100) || (defined(__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED >= 90000)
+#define HAL_JSVALUEISARRAY_ENABLE 1
+#else
+#define HAL_JSVALUEISARRAY_ENABLE 0
+#endif
+#endif
+
+// The std::string_view interfaces are only declared when compiling as
+// C++17 or later. They are all inline, so a HAL built as C++11 can be
+// used from C++17 code.
+#ifndef HAL_STRING_VIEW_ENABLE
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define HAL_STRING_VIEW_ENABLE 1
+#else
+#define HAL_STRING_VIEW_ENABLE 0
+#endif
 #endif
 
 #if (TARGET_OS_MAC || TARGET_OS_IPHONE)
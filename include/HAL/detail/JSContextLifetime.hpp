@@ -0,0 +1,225 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_DETAIL_JSCONTEXTLIFETIME_HPP_
+#define _HAL_DETAIL_JSCONTEXTLIFETIME_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+namespace HAL {
+  class JSString;
+}
+
+namespace HAL { namespace detail {
+
+  class JSExportConstantsCache;
+
+  /*!
+   @class
+
+   @discussion A JSContextLifetime keeps a JavaScriptCore global
+   context alive for as long as any JSContext refers to it. Since every
+   JSValue and JSObject holds a JSContext, they refer to it too.
+
+   There is at most one JSContextLifetime per JSGlobalContextRef. It
+   makes the only JSGlobalContextRetain on behalf of HAL and releases
+   it when the last reference to the JSContextLifetime goes away. The
+   JSContextLifetime counts its references with a plain atomic
+   counter, so copying a JSContext (and therefore a JSValue or
+   JSObject) never calls into JavaScriptCore.
+
+   Every callback wraps its JSContextRef in a JSContext, so finding
+   the JSContextLifetime of a global context must not serialize
+   threads. Each thread remembers the last JSContextLifetime it
+   acquired and takes another reference to it without locking. To make
+   that safe a JSContextLifetime is never deleted: once its last
+   reference goes away it releases the global context and is kept for
+   reuse by the next global context.
+
+   A JSContextLifetime also caches the context's intrinsics, i.e. the
+   built-in objects HAL itself relies on. Each one is looked up the
+   first time it is needed and stays protected until the global
+   context is released, so it is neither garbage collected nor
+   affected by scripts that later replace it (e.g. "Array = null").
+
+   Likewise a JSContextLifetime caches undefined, null, true, false
+   and the integers from HAL_JSNUMBER_CACHE_MIN to
+   HAL_JSNUMBER_CACHE_MAX. Since it keeps them protected, the JSValues
+   that JSContext hands out for them don't need to be protected
+   themselves.
+
+   Finally a JSContextLifetime counts the references to it held by the
+   callbacks of its context's native functions. A callback commonly
+   captures the JSContext it was created with, and since JavaScript
+   owns the callback this would keep the global context alive
+   forever. So once only those callbacks refer to the
+   JSContextLifetime nothing else can reach the context, and the
+   callbacks are destroyed to break the cycle.
+   */
+  class HAL_EXPORT JSContextLifetime final {
+
+  public:
+
+    /*!
+     @method
+
+     @abstract Return the JSContextLifetime of the given global context,
+     creating it if necessary.
+
+     @param js_global_context_ref The global context.
+
+     @result The JSContextLifetime of the given global context, with one
+     reference owned by the caller.
+     */
+    static JSContextLifetime* Acquire(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT;
+
+    // Add a reference. The caller must already own one.
+    void Retain() HAL_NOEXCEPT {
+      reference_count__.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Remove a reference, releasing the global context and destroying
+    // this JSContextLifetime if it was the last one.
+    void Release() HAL_NOEXCEPT;
+
+    JSGlobalContextRef get_global_context_ref() const HAL_NOEXCEPT {
+      return js_global_context_ref__;
+    }
+
+    JSContextGroupRef get_context_group_ref() const HAL_NOEXCEPT {
+      return js_context_group_ref__;
+    }
+
+    std::size_t get_reference_count() const HAL_NOEXCEPT {
+      return reference_count__;
+    }
+
+    // Add or remove references held by the callbacks of this
+    // context's native functions. JSFunction keeps track of which
+    // callback holds how many.
+    void AddCallbackReferences(std::size_t count) HAL_NOEXCEPT {
+      callback_reference_count__.fetch_add(count, std::memory_order_release);
+    }
+
+    void RemoveCallbackReferences(std::size_t count) HAL_NOEXCEPT {
+      callback_reference_count__.fetch_sub(count, std::memory_order_release);
+    }
+
+    // Return the intrinsic Array.isArray function, or nullptr if it
+    // could not be found.
+    JSObjectRef GetArrayIsArray() HAL_NOEXCEPT;
+
+    // Return the intrinsic Error constructor, or nullptr if it could
+    // not be found.
+    JSObjectRef GetErrorConstructor() HAL_NOEXCEPT;
+
+    // Return the intrinsic Function.prototype, or nullptr if it could
+    // not be found.
+    JSObjectRef GetFunctionPrototype() HAL_NOEXCEPT;
+
+    // Return the cached primitive values.
+    JSValueRef GetUndefined() HAL_NOEXCEPT;
+    JSValueRef GetNull() HAL_NOEXCEPT;
+    JSValueRef GetBoolean(bool boolean) HAL_NOEXCEPT;
+
+    // Return the cached number for the given integer, or nullptr if it
+    // is outside the range of cached integers.
+    JSValueRef GetSmallInteger(std::int64_t number) HAL_NOEXCEPT;
+
+    // Return this context's cache of the constants of the JSExport
+    // class with the given type, creating it with the given capacity
+    // if necessary.
+    JSExportConstantsCache& GetJSExportConstantsCache(std::type_index type_index, std::uint32_t capacity);
+
+#ifdef HAL_THREAD_SAFE
+    // Every JSContext referring to the same global context serializes
+    // on this mutex.
+    std::recursive_mutex& get_mutex() HAL_NOEXCEPT {
+      return mutex__;
+    }
+#endif
+
+    JSContextLifetime(const JSContextLifetime&)            = delete;
+    JSContextLifetime(JSContextLifetime&&)                 = delete;
+    JSContextLifetime& operator=(const JSContextLifetime&) = delete;
+    JSContextLifetime& operator=(JSContextLifetime&&)      = delete;
+
+  private:
+
+    JSContextLifetime() HAL_NOEXCEPT;
+    ~JSContextLifetime() HAL_NOEXCEPT;
+
+    // Return the JSContextLifetime of the given global context, taking
+    // the lock that protects the map of JSContextLifetimes.
+    static JSContextLifetime* AcquireLocked(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT;
+
+    // Add a reference if this JSContextLifetime is still in use for
+    // the given global context, otherwise return false.
+    bool TryRetain(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT;
+
+    // Retain the given global context. The reference count remains
+    // zero until the JSContextLifetime is published.
+    void Initialize(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT;
+
+    // Destroy the native function callbacks of this context if they
+    // hold all of the given remaining references, and destroy the
+    // callbacks of finalized native functions.
+    void ReleaseCallbacks(std::size_t reference_count) HAL_NOEXCEPT;
+
+    // Unprotect the cached values and release the global context so
+    // that this JSContextLifetime can be reused.
+    void Finalize() HAL_NOEXCEPT;
+
+    // Return the named property of the given object if it is an
+    // object, protecting it on behalf of this JSContextLifetime.
+    JSObjectRef GetIntrinsic(JSObjectRef js_object_ref, const JSString& property_name) HAL_NOEXCEPT;
+
+    // Protect the given value on behalf of this JSContextLifetime and
+    // return it.
+    JSValueRef Protect(JSValueRef js_value_ref) HAL_NOEXCEPT;
+
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    JSGlobalContextRef       js_global_context_ref__ { nullptr };
+    JSContextGroupRef        js_context_group_ref__  { nullptr };
+    std::atomic<std::size_t> reference_count__       { 0 };
+    std::atomic<std::size_t> callback_reference_count__ { 0 };
+    JSObjectRef              array_is_array__        { nullptr };
+    JSObjectRef              error_constructor__     { nullptr };
+    JSObjectRef              function_prototype__    { nullptr };
+    JSValueRef               undefined__             { nullptr };
+    JSValueRef               null__                  { nullptr };
+    JSValueRef               true__                  { nullptr };
+    JSValueRef               false__                 { nullptr };
+    std::unique_ptr<JSValueRef[]> small_integers__;
+    std::unordered_map<std::type_index, std::unique_ptr<JSExportConstantsCache>> js_export_constants_caches__;
+#ifdef HAL_THREAD_SAFE
+    std::recursive_mutex     mutex__;
+#endif
+#pragma warning(pop)
+
+#undef  HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD
+#ifdef  HAL_THREAD_SAFE
+#define HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD std::lock_guard<std::recursive_mutex> lock(mutex__)
+#else
+#define HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD
+#endif  // HAL_THREAD_SAFE
+  };
+
+}} // namespace HAL { namespace detail {
+
+#endif // _HAL_DETAIL_JSCONTEXTLIFETIME_HPP_
@@ -10,12 +10,15 @@
 #define _HAL_DETAIL_JSEXPORTCALLBACKS_HPP_
 
 #include "HAL/JSValue.hpp"
+#include "HAL/JSArguments.hpp"
 
+#include <cstddef>
 #include <vector>
 
 namespace HAL {
   class JSString;
   class JSObject;
+  class JSLocal;
   class JSPropertyNameAccumulator;
 }
 
@@ -72,6 +75,36 @@ namespace HAL { namespace detail {
   template<typename T>
   using SetNamedValuePropertyCallback = std::function<bool(T&, const JSValue&)>;
   
+  /*!
+   @typedef SetNamedValuePropertyLocalCallback
+   
+   @abstract The callback to invoke when setting a property's value on
+   your JavaScript object, receiving the value as a JSLocal.
+   
+   @discussion This is the cheaper form of
+   SetNamedValuePropertyCallback since the value is not protected from
+   garbage collection unless your callback promotes it with
+   JSLocal::ToPersistent. For example, given this class definition:
+   
+   class Foo {
+   bool SetBar(const JSLocal& value);
+   };
+   
+   You would define the callback like this:
+   
+   SetNamedValuePropertyLocalCallback callback(&Foo::SetBar);
+   
+   @param 1 A non-const reference to the C++ object that implements
+   your JavaScript object.
+   
+   @param 2 A const reference to the property's value, which is only
+   valid until your callback returns.
+   
+   @result Return true to indicate that the property was set.
+   */
+  template<typename T>
+  using SetNamedValuePropertyLocalCallback = std::function<bool(T&, const JSLocal&)>;
+  
   /*!
    @typedef CallNamedFunctionCallback
    
@@ -106,6 +139,39 @@ namespace HAL { namespace detail {
   template<typename T>
   using CallNamedFunctionCallback = std::function<JSValue(T&, const std::vector<JSValue>&, JSObject&)>;
   
+  /*!
+   @typedef CallNamedFunctionArgumentsCallback
+   
+   @abstract The callback to invoke when your JavaScript object is
+   called as a function, receiving its arguments as a JSArguments.
+   
+   @discussion This is the cheaper form of CallNamedFunctionCallback
+   since the arguments are neither copied into a std::vector nor
+   protected from garbage collection. For example, given this class
+   definition:
+   
+   class Foo {
+   JSValue Hello(const JSArguments& arguments, JSObject& this_object);
+   };
+   
+   You would define the callback like this:
+   
+   CallNamedFunctionArgumentsCallback callback(&Foo::Hello);
+   
+   @param 1 A non-const reference to the C++ object that implements
+   your JavaScript object.
+   
+   @param 2 A const reference to the arguments passed to the
+   function, which are only valid until your callback returns.
+   
+   @param 3 An non-const rvalue reference to the 'this' JavaScript
+   object.
+   
+   @result Return the function's value.
+   */
+  template<typename T>
+  using CallNamedFunctionArgumentsCallback = std::function<JSValue(T&, const JSArguments&, JSObject&)>;
+  
   /*!
    @typedef HasPropertyCallback
    
@@ -346,6 +412,65 @@ namespace HAL { namespace detail {
   template<typename T>
   using CallAsFunctionCallback = std::function<JSValue(T&, const std::vector<JSValue>&, JSObject&)>;
   
+  /*!
+   @typedef CallAsFunctionArgumentsCallback
+   
+   @abstract The callback to invoke when your JavaScript object is
+   called as a function, receiving its arguments as a JSArguments.
+   
+   @discussion This is the cheaper form of CallAsFunctionCallback
+   since the arguments are neither copied into a std::vector nor
+   protected from garbage collection. For example, given this class
+   definition:
+   
+   class Foo {
+   JSValue CallAsFunction(const JSArguments& arguments, JSObject& this_object);
+   };
+   
+   You would define the callback like this:
+   
+   CallAsFunctionArgumentsCallback callback(&Foo::CallAsFunction);
+   
+   @param 1 A non-const reference to the C++ object that implements
+   your JavaScript object.
+   
+   @param 2 A const reference to the arguments passed to the
+   function, which are only valid until your callback returns.
+   
+   @param 3 An non-const rvalue reference to the 'this' JavaScript
+   object.
+   
+   @result Return the value produced by calling your JavaScript object
+   as a function.
+   */
+  template<typename T>
+  using CallAsFunctionArgumentsCallback = std::function<JSValue(T&, const JSArguments&, JSObject&)>;
+  
+  // Adapt a callback taking its arguments as a std::vector<JSValue>
+  // to a callback taking a JSArguments. The adapted callback pays for
+  // the std::vector on every call, exactly as it did before
+  // JSArguments existed.
+  template<typename T>
+  CallAsFunctionArgumentsCallback<T> ToArgumentsCallback(CallAsFunctionCallback<T> callback) {
+    if (!callback) {
+      return nullptr;
+    }
+    
+    return [callback](T& native_object, const JSArguments& arguments, JSObject& this_object) {
+      return callback(native_object, arguments.ToVector(), this_object);
+    };
+  }
+  
+  template<typename T>
+  CallAsFunctionArgumentsCallback<T> ToArgumentsCallback(CallAsFunctionArgumentsCallback<T> callback) {
+    return callback;
+  }
+  
+  template<typename T>
+  CallAsFunctionArgumentsCallback<T> ToArgumentsCallback(std::nullptr_t) {
+    return nullptr;
+  }
+  
   /*!
    @typedef ConvertToTypeCallback
    
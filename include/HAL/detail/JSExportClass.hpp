@@ -15,29 +15,38 @@
 
 #include "HAL/JSString.hpp"
 #include "HAL/JSValue.hpp"
+#include "HAL/JSLocal.hpp"
+#include "HAL/JSArguments.hpp"
+#include "HAL/JSHandleScope.hpp"
 #include "HAL/JSObject.hpp"
 #include "HAL/JSNumber.hpp"
 #include "HAL/JSError.hpp"
 #include "HAL/JSArray.hpp"
 
+#include "HAL/detail/JSExportConstantsCache.hpp"
+#include "HAL/detail/JSExportMethod.hpp"
 #include "HAL/detail/JSPropertyNameAccumulator.hpp"
 #include "HAL/detail/JSUtil.hpp"
 #include "HAL/detail/JSValueUtil.hpp"
 
 #include <string>
-#include <regex>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <memory>
 #include <utility>
 #include <typeinfo>
 #include <typeindex>
+#include <type_traits>
 #include <unordered_map>
-#include <list>
 
 namespace HAL {
   template<typename T>
   class JSExport;
+  
+  class JSExportObject;
 }
 
 namespace HAL { namespace detail {
@@ -49,6 +58,12 @@ namespace HAL { namespace detail {
   template<typename T>
   class JSExportClassDefinition;
   
+  // Call the JSArguments overload of
+  // JSExportObject::postCallAsConstructor. This is defined out of line
+  // because JSExportObject is still incomplete here: JSExportObject.hpp
+  // includes this header.
+  HAL_EXPORT void JSExportObjectPostCallAsConstructor(JSExportObject* native_object_ptr, const JSContext& js_context, const JSArguments& arguments);
+  
   /*!
    @class
    
@@ -76,19 +91,35 @@ namespace HAL { namespace detail {
     JSExportClass& operator=(JSExportClass&&)      = default;
 #endif
 
-    // Erase least-recently-used constant cache.
+    // The values of constant properties are cached per JSContext, see
+    // JSExportConstantsCache.
+
+    // Erase least-recently-used constant cache of the given context.
     // Making this public only for testing porpose.
-    static void EvictCache();
+    static void EvictCache(const JSContext& js_context);
     
-    // Erase all constant cache
+    // Erase all constant cache of the given context.
+    static void EvictAllCache(const JSContext& js_context);
+    
+    // Erase all constant cache of every context.
     static void EvictAllCache();
 
-    //  Sets the size of the cache. Note that this clears all cache
+    // Sets the size of the cache of the given context. Note that this
+    // clears its cache.
+    static void ResizeCache(const JSContext& js_context, std::uint32_t maxSize);
+
+    // Sets the size of the cache of every context, including ones
+    // created later. Note that this clears all cache.
     static void ResizeCache(const std::uint32_t& maxSize);
 
-    // Returns cached constant names, sorted by Most-Recently-Used order.
+    // Returns cached constant names of the given context, sorted by
+    // Most-Recently-Used order.
     // Making this public only for testing porpose.
-    static std::vector<std::string> GetCachedKeys();
+    static std::vector<std::string> GetCachedKeys(const JSContext& js_context);
+    
+    // Returns the hits, misses and evictions of the given context's
+    // cache.
+    static JSExportConstantsCache::Statistics GetCacheStatistics(const JSContext& js_context);
 
   private:
     
@@ -110,8 +141,27 @@ namespace HAL { namespace detail {
     static JSValueRef  GetNamedValuePropertyCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef* exception);
     static bool        SetNamedValuePropertyCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef value_ref, JSValueRef* exception);
     
-    // Support for JSStaticFunction
+    // Support for JSStaticFunction. Each function property is bound
+    // to the callback at its own index when the class is built, so
+    // JavaScriptCore calls it without us having to recover the
+    // function's name.
+    static ::JSObjectCallAsFunctionCallback GetNamedFunctionCallback(std::size_t index);
+    template<std::size_t... indexes>
+    static ::JSObjectCallAsFunctionCallback GetNamedFunctionCallback(std::size_t index, index_sequence<indexes...>);
+    template<std::size_t index>
     static JSValueRef  CallNamedFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception);
+    static JSValueRef  CallNamedFunctionCallback(std::size_t index, JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception);
+    
+    // Support for value and function properties implemented by a
+    // member function named at compile time, see JSExportMethod. Each
+    // instantiation is the JavaScriptCore callback of exactly one
+    // member function, which it calls directly.
+    template<typename M, M method>
+    static JSValueRef  GetStaticValueCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef* exception);
+    template<typename M, M method>
+    static bool        SetStaticValueCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef value_ref, JSValueRef* exception);
+    template<typename M, M method>
+    static JSValueRef  CallStaticFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception);
     
     // JavaScriptCore C API callback interface.
     static void        JSObjectInitializeCallback(JSContextRef context_ref, JSObjectRef object_ref);
@@ -126,16 +176,40 @@ namespace HAL { namespace detail {
     static bool        JSObjectHasInstanceCallback(JSContextRef context_ref, JSObjectRef constructor_ref, JSValueRef possible_instance_ref, JSValueRef* exception);
     static JSValueRef  JSObjectConvertToTypeCallback(JSContextRef context_ref, JSObjectRef object_ref, JSType type, JSValueRef* exception);
     
+    // Give a native object derived from JSExportObject a direct
+    // back-reference to the JavaScript object that owns it.
+    template<typename U>
+    static typename std::enable_if<std::is_base_of<JSExportObject, U>::value>::type  SetJSObjectRef(U* native_object_ptr, JSObjectRef object_ref) HAL_NOEXCEPT;
+    template<typename U>
+    static typename std::enable_if<!std::is_base_of<JSExportObject, U>::value>::type SetJSObjectRef(U* native_object_ptr, JSObjectRef object_ref) HAL_NOEXCEPT;
+    
+    // Call JSExportObject::postCallAsConstructor through the base
+    // class so that a subclass overriding only the std::vector<JSValue>
+    // overload does not hide the JSArguments overload.
+    template<typename U>
+    static typename std::enable_if<std::is_base_of<JSExportObject, U>::value>::type  PostCallAsConstructor(U* native_object_ptr, const JSContext& js_context, const JSArguments& arguments);
+    template<typename U>
+    static typename std::enable_if<!std::is_base_of<JSExportObject, U>::value>::type PostCallAsConstructor(U* native_object_ptr, const JSContext& js_context, const JSArguments& arguments);
+    
     // Helper functions.
     static JSValue CreateJSError(const std::string& function_name, const std::string& location, JSObject js_object, const js_runtime_error& e);
     static JSValue CreateJSError(const std::string& function_name, JSObject js_object, const std::exception& e);
     static JSValue CreateJSError(const std::string& function_name, JSObject js_object, const std::string& what);
     static std::string GetJSExportComponentName(const std::string& function_name, const std::string& location = "");
     
+    // Install the constants on the prototype of the given JavaScript
+    // object unless they already are, see
+    // JSExportClassDefinitionBuilder::ConstantsInPrototype.
+    static void InstallConstants(const JSObject& js_object, T& native_object);
+    
+    // Return the constants cache of the given context, first clearing
+    // and resizing it if ResizeCache or EvictAllCache were called for
+    // every context since it was last used.
+    static JSExportConstantsCache& GetConstantsCache(const JSContext& js_context);
+    
     static JSExportClassDefinition<T> js_export_class_definition__;
-    static std::unordered_map<std::string, JSValue> constants_cache__;
-    static std::list<std::string>                   constants_cache_history__;
-    static std::uint32_t                            constants_cache_capacity__;
+    static std::atomic<std::uint32_t>               constants_cache_capacity__;
+    static std::atomic<std::uint64_t>               constants_cache_generation__;
     
 #undef HAL_DETAIL_JSEXPORTCLASS_LOCK_GUARD_STATIC
 #ifdef HAL_THREAD_SAFE
@@ -154,18 +228,15 @@ namespace HAL { namespace detail {
   template<typename T>
   JSExportClassDefinition<T> JSExportClass<T>::js_export_class_definition__;
 
-  template<typename T>
-  std::unordered_map<std::string, JSValue> JSExportClass<T>::constants_cache__;
-
-  template<typename T>
-  std::list<std::string> JSExportClass<T>::constants_cache_history__;
-
   //
   // Constants cache capacity
   // Consider optimizing this based on memory consumption
   //
   template<typename T>
-  std::uint32_t JSExportClass<T>::constants_cache_capacity__ = 16;
+  std::atomic<std::uint32_t> JSExportClass<T>::constants_cache_capacity__ { 16 };
+
+  template<typename T>
+  std::atomic<std::uint64_t> JSExportClass<T>::constants_cache_generation__ { 0 };
 
   template<typename T>
   JSExportClass<T>::JSExportClass() HAL_NOEXCEPT {
@@ -195,7 +266,7 @@ namespace HAL { namespace detail {
       HAL_LOG_DEBUG("JSExportClass: has value property callback ", name, " with attributes ", to_string(attributes));
     }
     
-    for (const auto& entry : js_export_class_definition__.named_function_property_callback_map__) {
+    for (const auto& entry : js_export_class_definition__.named_function_property_callbacks__) {
       const auto& name       = entry.first;
       const auto& attributes = entry.second.get_attributes();
       HAL_LOG_DEBUG("JSExportClass: has function property callback ", name, " with attributes ", to_string(attributes));
@@ -211,7 +282,7 @@ namespace HAL { namespace detail {
     JSObject js_object(JSContext(context_ref), object_ref);
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::Initialize: JSContextRef = ", context_ref, ", JSObjectRef = ", object_ref);
 
-    const auto previous_native_object_ptr = static_cast<JSExport<T>*>(js_object.GetPrivate());
+    const auto previous_native_object_ptr = static_cast<JSExport<T>*>(js_object.GetJSExportPrivate());
     const auto native_object_ptr          = new T(js_object.get_context());
     
     if (previous_native_object_ptr != nullptr) {
@@ -219,14 +290,70 @@ namespace HAL { namespace detail {
       delete previous_native_object_ptr;
     }
     
-    const bool result = js_object.SetPrivate(native_object_ptr);
-    HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::Initialize: private data set to ", js_object.GetPrivate(), " for ", object_ref);
+    const bool result = js_object.SetJSExportPrivate(native_object_ptr);
+    HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::Initialize: private data set to ", js_object.GetJSExportPrivate(), " for ", object_ref);
+    
+    SetJSObjectRef(native_object_ptr, object_ref);
     
     native_object_ptr->postInitialize(js_object);
     
+    if (js_export_class_definition__.constants_in_prototype__) {
+      InstallConstants(js_object, *native_object_ptr);
+    }
+    
     assert(result);
   }
   
+  template<typename T>
+  void JSExportClass<T>::InstallConstants(const JSObject& js_object, T& native_object) {
+    const auto prototype = js_object.GetPrototype();
+    if (!prototype.IsObject()) {
+      return;
+    }
+    
+    // The prototype is usually this class's automatic prototype, but
+    // when this class is the parent of another one it is the
+    // automatic prototype of the derived class instead.
+    auto js_prototype          = static_cast<JSObject>(prototype);
+    const auto prototype_ref   = static_cast<JSObjectRef>(js_prototype);
+    auto& constants_cache      = GetConstantsCache(js_object.get_context());
+    if (constants_cache.IsInstalledOn(prototype_ref)) {
+      return;
+    }
+    
+    for (const auto& property_name : js_export_class_definition__.named_constants__) {
+      const auto& value_property_callback = js_export_class_definition__.named_value_property_callback_map__.at(property_name);
+      const auto callback                 = value_property_callback.get_callback();
+      js_prototype.SetProperty(property_name, callback(native_object), value_property_callback.get_attributes());
+      HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::InstallConstants: installed ", property_name, " on ", prototype_ref);
+    }
+    
+    constants_cache.SetInstalledOn(prototype_ref);
+  }
+  
+  template<typename T>
+  template<typename U>
+  typename std::enable_if<std::is_base_of<JSExportObject, U>::value>::type JSExportClass<T>::SetJSObjectRef(U* native_object_ptr, JSObjectRef object_ref) HAL_NOEXCEPT {
+    native_object_ptr -> js_object_ref__ = object_ref;
+  }
+  
+  template<typename T>
+  template<typename U>
+  typename std::enable_if<!std::is_base_of<JSExportObject, U>::value>::type JSExportClass<T>::SetJSObjectRef(U* native_object_ptr, JSObjectRef object_ref) HAL_NOEXCEPT {
+  }
+  
+  template<typename T>
+  template<typename U>
+  typename std::enable_if<std::is_base_of<JSExportObject, U>::value>::type JSExportClass<T>::PostCallAsConstructor(U* native_object_ptr, const JSContext& js_context, const JSArguments& arguments) {
+    JSExportObjectPostCallAsConstructor(native_object_ptr, js_context, arguments);
+  }
+  
+  template<typename T>
+  template<typename U>
+  typename std::enable_if<!std::is_base_of<JSExportObject, U>::value>::type JSExportClass<T>::PostCallAsConstructor(U* native_object_ptr, const JSContext& js_context, const JSArguments& arguments) {
+    native_object_ptr -> postCallAsConstructor(js_context, arguments.ToVector());
+  }
+  
   template<typename T>
   void JSExportClass<T>::JSObjectFinalizeCallback(JSObjectRef object_ref) {
     HAL_DETAIL_JSEXPORTCLASS_LOCK_GUARD_STATIC;
@@ -242,33 +369,53 @@ namespace HAL { namespace detail {
   }
   
   template<typename T>
-  void JSExportClass<T>::EvictCache() {
-    assert(!constants_cache_history__.empty());
-    const auto least_cache_key = constants_cache_history__.front();
-    constants_cache_history__.pop_front();
-    constants_cache__.erase(least_cache_key);
+  JSExportConstantsCache& JSExportClass<T>::GetConstantsCache(const JSContext& js_context) {
+    const auto capacity = constants_cache_capacity__.load();
+    auto& constants_cache = js_context.get_context_lifetime() -> GetJSExportConstantsCache(typeid(T), capacity);
+    const auto generation = constants_cache_generation__.load();
+    if (constants_cache.get_generation() != generation) {
+      constants_cache.Resize(capacity);
+      constants_cache.set_generation(generation);
+    }
+    
+    return constants_cache;
+  }
+  
+  template<typename T>
+  void JSExportClass<T>::EvictCache(const JSContext& js_context) {
+    GetConstantsCache(js_context).EvictLeastRecentlyUsed();
+  }
+
+  template<typename T>
+  void JSExportClass<T>::EvictAllCache(const JSContext& js_context) {
+    GetConstantsCache(js_context).Clear();
   }
 
   template<typename T>
   void JSExportClass<T>::EvictAllCache() {
-    constants_cache_history__.clear();
-    constants_cache__.clear();    
+    // Every context's cache clears itself the next time it is used.
+    ++constants_cache_generation__;
+  }
+
+  template<typename T>
+  void JSExportClass<T>::ResizeCache(const JSContext& js_context, std::uint32_t maxSize) {
+    GetConstantsCache(js_context).Resize(maxSize);
   }
 
   template<typename T>
   void JSExportClass<T>::ResizeCache(const std::uint32_t& maxSize) {
-    constants_cache_history__.clear();
-    constants_cache__.clear();    
     constants_cache_capacity__ = maxSize;
+    ++constants_cache_generation__;
   }
 
   template<typename T>
-  std::vector<std::string> JSExportClass<T>::GetCachedKeys() {
-    std::vector<std::string> keys;
-    for (auto it = constants_cache_history__.rbegin(); it != constants_cache_history__.rend(); ++it) {
-      keys.push_back(*it);
-    }
-    return keys;
+  std::vector<std::string> JSExportClass<T>::GetCachedKeys(const JSContext& js_context) {
+    return GetConstantsCache(js_context).GetKeys();
+  }
+
+  template<typename T>
+  JSExportConstantsCache::Statistics JSExportClass<T>::GetCacheStatistics(const JSContext& js_context) {
+    return GetConstantsCache(js_context).get_statistics();
   }
 
   template<typename T>
@@ -295,26 +442,15 @@ namespace HAL { namespace detail {
 
         HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::GetNamedProperty: constant found = ", constant_found, " for ", to_string(js_object), ".", property_name);
 
-        // check if it's cached
-        const auto cache_position = constants_cache__.find(property_name);
-        const bool cache_found    = cache_position != constants_cache__.end();
-
         // if it's cached, we just use it
-        if (cache_found) {
+        const JSValueRef cached_js_value_ref = GetConstantsCache(js_object.get_context()).Find(property_name);
+        if (cached_js_value_ref) {
           HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::GetNamedProperty: constant cache found = ", constant_found, " for ", to_string(js_object), ".", property_name);
-
-          //
-          // update LRU cache access history
-          //
-          const auto cache_history_position = std::find(constants_cache_history__.begin(), constants_cache_history__.end(), property_name);
-          assert(cache_history_position != constants_cache_history__.end());
-          constants_cache_history__.splice(constants_cache_history__.end(), constants_cache_history__, cache_history_position);
-
-          return static_cast<JSValueRef>(constants_cache__.at(property_name));
-        } 
+          return cached_js_value_ref;
+        }
       }
 
-      auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+      auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
       const auto callback          = (callback_position -> second).get_callback();
       const auto result            = callback(*native_object_ptr);
       
@@ -322,24 +458,7 @@ namespace HAL { namespace detail {
 
       // make sure to cache the result if it's a constant
       if (constant_found) {
-        constants_cache__.emplace(property_name, result);
-
-        //
-        // create LRU cache access history
-        //
-        const auto cache_history_position = std::find(constants_cache_history__.begin(), constants_cache_history__.end(), property_name);
-        // make sure it's called only when cache misses
-        assert(cache_history_position == constants_cache_history__.end());
-        //
-        // check the capacity and evict when necessary
-        // this only caches up to constants_cache_capacity__ entries
-        // consider optimizing this based on memory consumption
-        //
-        if (constants_cache_history__.size() >= constants_cache_capacity__) {
-          EvictCache();
-        }
-
-        constants_cache_history__.insert(constants_cache_history__.end(), property_name);
+        GetConstantsCache(js_object.get_context()).Insert(property_name, static_cast<JSValueRef>(result));
       }
       
       return static_cast<JSValueRef>(result);
@@ -363,8 +482,9 @@ namespace HAL { namespace detail {
   template<typename T>
   bool JSExportClass<T>::SetNamedValuePropertyCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef value_ref, JSValueRef* exception) try {
     
+    JSHandleScope handle_scope;
     JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
-    JSValue  js_value(js_object.get_context(), value_ref);
+    JSLocal  js_value(context_ref, value_ref);
     
     const std::string property_name = JSString(property_name_ref);
     
@@ -377,9 +497,9 @@ namespace HAL { namespace detail {
     assert(callback_found);
     
     try {
-      auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
-      const auto callback    = (callback_position -> second).set_callback();
-      const auto result      = callback(*native_object_ptr, js_value);
+      auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
+      const auto& callback   = (callback_position -> second).set_callback();
+      const auto  result     = callback(*native_object_ptr, js_value);
       
       HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::SetNamedProperty: result = ", result, " for ", to_string(js_object), ".", property_name);
       
@@ -402,57 +522,48 @@ namespace HAL { namespace detail {
   }
   
   template<typename T>
-  JSValueRef JSExportClass<T>::CallNamedFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) try {
-    // to_string(js_object) produces this text:
-    //
-    // function sayHello() {
-    //     [native code]
-    // }
-    //
-    // So this is the regular expression we use to determing the
-    // function's name for lookup.
-    static std::regex regex("^function\\s+([^(]+)\\(\\)(.|\\n)*$");
-    
-    JSObject          js_object(JSObject::FindJSObject(context_ref, function_ref));
-    JSObject          this_object(JSObject::FindJSObject(context_ref, this_object_ref));
-    const std::string js_object_string = to_string(js_object);
-    std::smatch       match_results;
-    const bool        found = std::regex_match(js_object_string, match_results, regex);
-
-    static_cast<void>(found);
-    HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallNamedFunction: function name found = ", found, ", match_results.size() = ", match_results.size(), ", input = ", js_object_string);
-    
+  ::JSObjectCallAsFunctionCallback JSExportClass<T>::GetNamedFunctionCallback(std::size_t index) {
     // precondition
-    // The size of the match results should be 3:
-    // match_results[0] == the whole string.
-    // match_results[1] == The function's name
-    // match_results[2] == Everything after the function's name.
-    assert(match_results.size() == 3);
-    const std::string function_name = match_results[1];
+    assert(index < HAL_JSEXPORT_FUNCTION_PROPERTY_MAX);
+    return GetNamedFunctionCallback(index, make_index_sequence<HAL_JSEXPORT_FUNCTION_PROPERTY_MAX>());
+  }
+  
+  template<typename T>
+  template<std::size_t... indexes>
+  ::JSObjectCallAsFunctionCallback JSExportClass<T>::GetNamedFunctionCallback(std::size_t index, index_sequence<indexes...>) {
+    static const ::JSObjectCallAsFunctionCallback callbacks[] = { CallNamedFunctionCallback<indexes>... };
+    return callbacks[index];
+  }
+  
+  template<typename T>
+  template<std::size_t index>
+  JSValueRef JSExportClass<T>::CallNamedFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) {
+    return CallNamedFunctionCallback(index, context_ref, function_ref, this_object_ref, argument_count, arguments_array, exception);
+  }
+  
+  template<typename T>
+  JSValueRef JSExportClass<T>::CallNamedFunctionCallback(std::size_t index, JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) try {
     
     // precondition
-    assert(js_object.IsFunction());
+    assert(index < js_export_class_definition__.named_function_property_callbacks__.size());
     
-    const auto callback_position = js_export_class_definition__.named_function_property_callback_map__.find(function_name);
-    const bool callback_found    = callback_position != js_export_class_definition__.named_function_property_callback_map__.end();
-    const auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
-    const auto native_this_ptr   = static_cast<T*>(this_object.GetPrivate());
-
-    static_cast<void>(native_object_ptr);
-    HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallNamedFunction: callback found = ", callback_found, " for this[", native_this_ptr, "].", function_name, "(...)");
+    JSHandleScope handle_scope;
+    const auto& entry            = js_export_class_definition__.named_function_property_callbacks__[index];
+    const auto& function_name    = entry.first;
+    JSObject    this_object(JSObject::FindJSObject(context_ref, this_object_ref));
+    const auto  native_this_ptr  = static_cast<T*>(this_object.GetJSExportPrivate());
+    
+    HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallNamedFunction: callback ", index, " for this[", native_this_ptr, "].", function_name, "(...)");
     
-    // precondition
-    assert(callback_found);
-
     try {
-      const auto callback = (callback_position -> second).function_callback();
-      const auto result   = callback(*native_this_ptr, to_vector(this_object.get_context(), argument_count, arguments_array), this_object);
+      const auto& callback = entry.second.function_callback();
+      const auto  result   = callback(*native_this_ptr, JSArguments(context_ref, argument_count, arguments_array), this_object);
       
 #ifdef HAL_LOGGING_ENABLE
       std::string js_value_str;
       if (result.IsObject()) {
         JSObject js_object = static_cast<JSObject>(result);
-        const auto native_object_ptr = reinterpret_cast<std::intptr_t>(js_object.GetPrivate());
+        const auto native_object_ptr = reinterpret_cast<std::intptr_t>(js_object.GetJSExportPrivate());
         js_value_str = std::to_string(native_object_ptr);
       }
       else {
@@ -479,6 +590,93 @@ namespace HAL { namespace detail {
     *exception = static_cast<JSValueRef>(CreateJSError("CallNamedFunction", js_object, "unknown exception"));
     return nullptr;
   }
+  
+  template<typename T>
+  template<typename M, M method>
+  JSValueRef JSExportClass<T>::GetStaticValueCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef* exception) try {
+    
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
+    
+    try {
+      const auto result = InvokeJSExportGetter(*native_object_ptr, method, js_object);
+      HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::GetStaticValue: result = ", to_string(result), " for ", to_string(js_object), ".", static_cast<std::string>(JSString(property_name_ref)));
+      return static_cast<JSValueRef>(result);
+      
+    } catch (const js_runtime_error& e) {
+      *exception = static_cast<JSValueRef>(CreateJSError("GetStaticValue", static_cast<std::string>(JSString(property_name_ref)), js_object, e));
+      return nullptr;
+    }
+    
+  } catch (const std::exception& e) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("GetStaticValue", js_object, e));
+    return nullptr;
+  } catch (...) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("GetStaticValue", js_object, "unknown exception"));
+    return nullptr;
+  }
+  
+  template<typename T>
+  template<typename M, M method>
+  bool JSExportClass<T>::SetStaticValueCallback(JSContextRef context_ref, JSObjectRef object_ref, JSStringRef property_name_ref, JSValueRef value_ref, JSValueRef* exception) try {
+    
+    JSHandleScope handle_scope;
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    JSLocal  js_value(context_ref, value_ref);
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
+    
+    try {
+      const bool result = InvokeJSExportSetter(*native_object_ptr, method, js_value);
+      HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::SetStaticValue: result = ", result, " for ", to_string(js_object), ".", static_cast<std::string>(JSString(property_name_ref)));
+      return result;
+      
+    } catch (const js_runtime_error& e) {
+      *exception = static_cast<JSValueRef>(CreateJSError("SetStaticValue", static_cast<std::string>(JSString(property_name_ref)), js_object, e));
+      return false;
+    }
+    
+  } catch (const std::exception& e) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("SetStaticValue", js_object, e));
+    return false;
+  } catch (...) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, object_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("SetStaticValue", js_object, "unknown exception"));
+    return false;
+  }
+  
+  template<typename T>
+  template<typename M, M method>
+  JSValueRef JSExportClass<T>::CallStaticFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) try {
+    
+    JSHandleScope handle_scope;
+    JSObject    this_object(JSObject::FindJSObject(context_ref, this_object_ref));
+    const auto  native_this_ptr = static_cast<T*>(this_object.GetJSExportPrivate());
+    
+    try {
+      const auto result = InvokeJSExportFunction(*native_this_ptr, method, JSArguments(context_ref, argument_count, arguments_array), this_object);
+      return static_cast<JSValueRef>(result);
+      
+    } catch (const js_runtime_error& e) {
+      // JavaScriptCore names the function after its property.
+      static const auto& name_property_name = JSString::Intern("name");
+      JSObject js_object(JSObject::FindJSObject(context_ref, function_ref));
+      const auto function_name = static_cast<std::string>(js_object.GetProperty(name_property_name));
+      *exception = static_cast<JSValueRef>(CreateJSError("CallStaticFunction", function_name, js_object, e));
+      return nullptr;
+    }
+    
+  } catch (const std::exception& e) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, function_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("CallStaticFunction", js_object, e));
+    return nullptr;
+  } catch (...) {
+    JSObject js_object(JSObject::FindJSObject(context_ref, function_ref));
+    *exception = static_cast<JSValueRef>(CreateJSError("CallStaticFunction", js_object, "unknown exception"));
+    return nullptr;
+  }
 
   template<typename T>
   JSValue JSExportClass<T>::CreateJSError(const std::string& function_name, const std::string& location, JSObject js_source, const js_runtime_error& e) {
@@ -490,12 +688,18 @@ namespace HAL { namespace detail {
     std::vector<JSValue> js_stack = e.js_stack();
     js_stack.push_back(js_context.CreateString(name));
 
+    static const auto& message_property_name      = JSString::Intern("message");
+    static const auto& name_property_name         = JSString::Intern("name");
+    static const auto& filename_property_name     = JSString::Intern("fileName");
+    static const auto& native_stack_property_name = JSString::Intern("native_stack");
+    static const auto& linenumber_property_name   = JSString::Intern("lineNumber");
+
     auto js_error = js_context.CreateError();
-    js_error.SetProperty("message",    js_context.CreateString(e.js_message()));
-    js_error.SetProperty("name",       js_context.CreateString(e.js_name()));
-    js_error.SetProperty("fileName",   js_context.CreateString(e.js_filename()));
-    js_error.SetProperty("native_stack",      js_context.CreateArray(js_stack));
-    js_error.SetProperty("lineNumber", js_context.CreateNumber(e.js_linenumber()));
+    js_error.SetProperty(message_property_name,      js_context.CreateString(e.js_message()));
+    js_error.SetProperty(name_property_name,         js_context.CreateString(e.js_name()));
+    js_error.SetProperty(filename_property_name,     js_context.CreateString(e.js_filename()));
+    js_error.SetProperty(native_stack_property_name, js_context.CreateArray(js_stack));
+    js_error.SetProperty(linenumber_property_name,   js_context.CreateNumber(e.js_linenumber()));
     return js_error;
   }
 
@@ -511,9 +715,12 @@ namespace HAL { namespace detail {
 
     HAL_LOG_ERROR(name, ": ", what);
 
+    static const auto& message_property_name      = JSString::Intern("message");
+    static const auto& native_stack_property_name = JSString::Intern("native_stack");
+
     auto js_error = js_context.CreateError();
-    js_error.SetProperty("message",    js_context.CreateString(what));
-    js_error.SetProperty("native_stack",      js_context.CreateArray({ js_context.CreateString(name) }));
+    js_error.SetProperty(message_property_name,      js_context.CreateString(what));
+    js_error.SetProperty(native_stack_property_name, js_context.CreateArray({ js_context.CreateString(name) }));
     return js_error;
   }
   
@@ -526,7 +733,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.has_property_callback__;
     const bool callback_found = callback != nullptr;
 
-    const auto native_object_ptr = static_cast<const T*>(js_object.GetPrivate());
+    const auto native_object_ptr = static_cast<const T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::HasProperty: callback found = ", callback_found, " for this[", native_object_ptr, "].", static_cast<std::string>(property_name));
     
     // precondition
@@ -555,7 +762,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.get_property_callback__;
     const bool callback_found = callback != nullptr;
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::GetProperty: callback found = ", callback_found, " for this[", native_object_ptr, "].", static_cast<std::string>(property_name));
     
     // precondition
@@ -568,7 +775,7 @@ namespace HAL { namespace detail {
       std::string js_value_str;
       if (result.IsObject()) {
         JSObject js_object = static_cast<JSObject>(result);
-        const auto native_object_ptr = reinterpret_cast<std::intptr_t>(js_object.GetPrivate());
+        const auto native_object_ptr = reinterpret_cast<std::intptr_t>(js_object.GetJSExportPrivate());
         js_value_str = std::to_string(native_object_ptr);
       }
       else {
@@ -603,7 +810,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.set_property_callback__;
     const bool callback_found = callback != nullptr;
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::SetProperty: callback found = ", callback_found, " for this[", native_object_ptr, "].", static_cast<std::string>(property_name));
     
     // precondition
@@ -638,7 +845,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.delete_property_callback__;
     const bool callback_found = callback != nullptr;
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::DeleteProperty: callback found = ", callback_found, " for this[", native_object_ptr, "].", static_cast<std::string>(property_name));
     
     // precondition
@@ -673,7 +880,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.get_property_names_callback__;
     const bool callback_found = callback != nullptr;
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::GetPropertyNames: callback found = ", callback_found, " for this[", native_object_ptr, "]");
     
     // precondition
@@ -690,24 +897,25 @@ namespace HAL { namespace detail {
   template<typename T>
   JSValueRef JSExportClass<T>::JSObjectCallAsFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) try {
     
+    JSHandleScope handle_scope;
     JSObject js_object(JSObject::FindJSObject(context_ref, function_ref));
     JSObject this_object(JSObject::FindJSObject(context_ref, this_object_ref));
     
     // precondition
     assert(js_object.IsFunction());
     
-    auto       callback       = js_export_class_definition__.call_as_function_callback__;
+    const auto& callback      = js_export_class_definition__.call_as_function_callback__;
     const bool callback_found = callback != nullptr;
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
-    auto native_this_ptr   = static_cast<T*>(this_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
+    auto native_this_ptr   = static_cast<T*>(this_object.GetJSExportPrivate());
     static_cast<void>(native_this_ptr);
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallAsFunction: callback found = ", callback_found, " for this[", native_this_ptr, "].this[", native_object_ptr, "](...)");
     
     // precondition
     assert(callback_found);
     
-    const auto result = callback(*native_object_ptr, to_vector(this_object.get_context(), argument_count, arguments_array), this_object);
+    const auto result = callback(*native_object_ptr, JSArguments(context_ref, argument_count, arguments_array), this_object);
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallAsFunction: result = ", to_string(result), " for this[", native_this_ptr, "].this[", native_object_ptr, "](...)");
     return static_cast<JSValueRef>(result);
 
@@ -728,14 +936,15 @@ namespace HAL { namespace detail {
   template<typename T>
   JSObjectRef JSExportClass<T>::JSObjectCallAsConstructorCallback(JSContextRef context_ref, JSObjectRef constructor_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) try {
     
+    JSHandleScope handle_scope;
     JSObject  js_object(JSObject::FindJSObject(context_ref, constructor_ref));
     JSContext js_context = js_object.get_context();
 
     auto new_object = js_context.CreateObject(JSExport<T>::Class());
-    const auto native_object_ptr = static_cast<T*>(new_object.GetPrivate());
+    const auto native_object_ptr = static_cast<T*>(new_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::CallAsConstructor: for this[", native_object_ptr, "]");
 
-    native_object_ptr->postCallAsConstructor(js_context, to_vector(js_context, argument_count, arguments_array));
+    PostCallAsConstructor(native_object_ptr, js_context, JSArguments(context_ref, argument_count, arguments_array));
 
     return static_cast<JSObjectRef>(new_object);
     
@@ -770,7 +979,7 @@ namespace HAL { namespace detail {
       }
     }
     
-    auto native_object_ptr = static_cast<T*>(js_object.GetPrivate());
+    auto native_object_ptr = static_cast<T*>(js_object.GetJSExportPrivate());
     static_cast<void>(native_object_ptr);
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::HasInstance: result = ", result, " for ", to_string(possible_instance), " instanceof this[", native_object_ptr, "]");
     return result;
@@ -797,7 +1006,7 @@ namespace HAL { namespace detail {
     auto       callback       = js_export_class_definition__.convert_to_type_callback__;
     const bool callback_found = callback != nullptr;
     
-    const auto native_object_ptr = static_cast<const T*>(js_object.GetPrivate());
+    const auto native_object_ptr = static_cast<const T*>(js_object.GetJSExportPrivate());
     HAL_LOG_DEBUG("JSExportClass<", typeid(T).name(), ">::ConvertToType: callback found = ", callback_found, " for this[", native_object_ptr, "]");
     
     // precondition
@@ -19,6 +19,15 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <utility>
+
+// The maximum number of function properties a single JSExport class
+// can add. Each function property is bound to its own JavaScriptCore
+// callback when the class is built.
+#ifndef HAL_JSEXPORT_FUNCTION_PROPERTY_MAX
+#define HAL_JSEXPORT_FUNCTION_PROPERTY_MAX 256
+#endif
 
 namespace HAL { namespace detail {
   
@@ -28,6 +37,16 @@ namespace HAL { namespace detail {
   template<typename T>
   using JSExportNamedFunctionPropertyCallbackMap_t = std::unordered_map<std::string, JSExportNamedFunctionPropertyCallback<T>>;
   
+  template<typename T>
+  using JSExportNamedFunctionPropertyCallbacks_t   = std::vector<std::pair<std::string, JSExportNamedFunctionPropertyCallback<T>>>;
+  
+  // Value and function properties implemented by a member function
+  // named at compile time (see JSExportMethod), whose JavaScriptCore
+  // callbacks are known before the class is built. The name pointers
+  // are set when the static tables are built.
+  using JSExportStaticValues_t                     = std::vector<std::pair<std::string, ::JSStaticValue>>;
+  using JSExportStaticFunctions_t                  = std::vector<std::pair<std::string, ::JSStaticFunction>>;
+  
   template<typename T>
   class JSExportClassDefinitionBuilder;
   
@@ -68,14 +87,24 @@ namespace HAL { namespace detail {
     friend class JSExportClass;
     
     std::unordered_set<std::string>               named_constants__;
+    
+    // Whether the constants are installed on the automatic prototype
+    // instead of being vended by GetNamedValuePropertyCallback.
+    bool                                          constants_in_prototype__       { false };
     JSExportNamedValuePropertyCallbackMap_t<T>    named_value_property_callback_map__;
-    JSExportNamedFunctionPropertyCallbackMap_t<T> named_function_property_callback_map__;
+    
+    // The position of each function property in this vector is the
+    // index of the JavaScriptCore callback it is bound to, so the
+    // order must survive copies and moves.
+    JSExportNamedFunctionPropertyCallbacks_t<T>   named_function_property_callbacks__;
+    JSExportStaticValues_t                        named_static_values__;
+    JSExportStaticFunctions_t                     named_static_functions__;
     HasPropertyCallback<T>                        has_property_callback__        { nullptr };
     GetPropertyCallback<T>                        get_property_callback__        { nullptr };
     SetPropertyCallback<T>                        set_property_callback__        { nullptr };
     DeletePropertyCallback<T>                     delete_property_callback__     { nullptr };
     GetPropertyNamesCallback<T>                   get_property_names_callback__  { nullptr };
-    CallAsFunctionCallback<T>                     call_as_function_callback__    { nullptr };
+    CallAsFunctionArgumentsCallback<T>            call_as_function_callback__    { nullptr };
     ConvertToTypeCallback<T>                      convert_to_type_callback__     { nullptr };
   };
   
@@ -83,8 +112,11 @@ namespace HAL { namespace detail {
   JSExportClassDefinition<T>::JSExportClassDefinition(const JSExportClassDefinition<T>& rhs) HAL_NOEXCEPT
   : JSClassDefinition(rhs)
   , named_constants__(rhs.named_constants__)
+  , constants_in_prototype__(rhs.constants_in_prototype__)
   , named_value_property_callback_map__(rhs.named_value_property_callback_map__)
-  , named_function_property_callback_map__(rhs.named_function_property_callback_map__)
+  , named_function_property_callbacks__(rhs.named_function_property_callbacks__)
+  , named_static_values__(rhs.named_static_values__)
+  , named_static_functions__(rhs.named_static_functions__)
   , has_property_callback__(rhs.has_property_callback__)
   , get_property_callback__(rhs.get_property_callback__)
   , set_property_callback__(rhs.set_property_callback__)
@@ -102,8 +134,11 @@ namespace HAL { namespace detail {
   JSExportClassDefinition<T>::JSExportClassDefinition(JSExportClassDefinition<T>&& rhs) HAL_NOEXCEPT
   : JSClassDefinition(rhs)
   , named_constants__(std::move(rhs.named_constants__))
+  , constants_in_prototype__(rhs.constants_in_prototype__)
   , named_value_property_callback_map__(std::move(rhs.named_value_property_callback_map__))
-  , named_function_property_callback_map__(std::move(rhs.named_function_property_callback_map__))
+  , named_function_property_callbacks__(std::move(rhs.named_function_property_callbacks__))
+  , named_static_values__(std::move(rhs.named_static_values__))
+  , named_static_functions__(std::move(rhs.named_static_functions__))
   , has_property_callback__(std::move(rhs.has_property_callback__))
   , get_property_callback__(std::move(rhs.get_property_callback__))
   , set_property_callback__(std::move(rhs.set_property_callback__))
@@ -122,8 +157,11 @@ namespace HAL { namespace detail {
     HAL_JSCLASSDEFINITION_LOCK_GUARD;
     JSClassDefinition::operator=(rhs);
     named_constants__                      = rhs.named_constants__;
+    constants_in_prototype__               = rhs.constants_in_prototype__;
     named_value_property_callback_map__    = rhs.named_value_property_callback_map__;
-    named_function_property_callback_map__ = rhs.named_function_property_callback_map__;
+    named_function_property_callbacks__    = rhs.named_function_property_callbacks__;
+    named_static_values__                  = rhs.named_static_values__;
+    named_static_functions__               = rhs.named_static_functions__;
     has_property_callback__                = rhs.has_property_callback__;
     get_property_callback__                = rhs.get_property_callback__;
     set_property_callback__                = rhs.set_property_callback__;
@@ -160,8 +198,11 @@ namespace HAL { namespace detail {
       // By swapping the members of two classes, the two classes are
       // effectively swapped.
       swap(named_constants__                     , other.named_constants__);
+      swap(constants_in_prototype__              , other.constants_in_prototype__);
       swap(named_value_property_callback_map__   , other.named_value_property_callback_map__);
-      swap(named_function_property_callback_map__, other.named_function_property_callback_map__);
+      swap(named_function_property_callbacks__   , other.named_function_property_callbacks__);
+      swap(named_static_values__                 , other.named_static_values__);
+      swap(named_static_functions__              , other.named_static_functions__);
       swap(has_property_callback__               , other.has_property_callback__);
       swap(get_property_callback__               , other.get_property_callback__);
       swap(set_property_callback__               , other.set_property_callback__);
@@ -182,18 +223,26 @@ namespace HAL { namespace detail {
       // Initialize staticValues.
       static_values__.clear();
       js_class_definition__.staticValues = nullptr;
-      if (!named_value_property_callback_map__.empty()) {
-        for (const auto& entry : named_value_property_callback_map__) {
-          const auto& property_name       = entry.first;
-          const auto& property_attributes = entry.second.get_attributes();
-          ::JSStaticValue static_value;
-          static_value.name        = property_name.c_str();
-          static_value.getProperty = JSExportClass<T>::GetNamedValuePropertyCallback;
-          static_value.setProperty = JSExportClass<T>::SetNamedValuePropertyCallback;
-          static_value.attributes  = ToJSPropertyAttributes(property_attributes);
-          static_values__.push_back(static_value);
-          // HAL_LOG_DEBUG("JSExportClassDefinition<", name__, "> added value property ", static_values__.back().name);
+      for (const auto& entry : named_value_property_callback_map__) {
+        const auto& property_name       = entry.first;
+        const auto& property_attributes = entry.second.get_attributes();
+        if (constants_in_prototype__ && named_constants__.count(property_name) > 0) {
+          continue;
         }
+        ::JSStaticValue static_value;
+        static_value.name        = property_name.c_str();
+        static_value.getProperty = JSExportClass<T>::GetNamedValuePropertyCallback;
+        static_value.setProperty = JSExportClass<T>::SetNamedValuePropertyCallback;
+        static_value.attributes  = ToJSPropertyAttributes(property_attributes);
+        static_values__.push_back(static_value);
+        // HAL_LOG_DEBUG("JSExportClassDefinition<", name__, "> added value property ", static_values__.back().name);
+      }
+      for (const auto& entry : named_static_values__) {
+        ::JSStaticValue static_value = entry.second;
+        static_value.name            = entry.first.c_str();
+        static_values__.push_back(static_value);
+      }
+      if (!static_values__.empty()) {
         static_values__.push_back({nullptr, nullptr, nullptr, kJSPropertyAttributeNone});
         js_class_definition__.staticValues = &static_values__[0];
       }
@@ -201,17 +250,22 @@ namespace HAL { namespace detail {
       // Initialize staticFunctions.
       static_functions__.clear();
       js_class_definition__.staticFunctions = nullptr;
-      if (!named_function_property_callback_map__.empty()) {
-        for (const auto& entry : named_function_property_callback_map__) {
-          const auto& function_name = entry.first;
-          const auto& property_attributes = entry.second.get_attributes();
-          ::JSStaticFunction static_function;
-          static_function.name           = function_name.c_str();
-          static_function.callAsFunction = JSExportClass<T>::CallNamedFunctionCallback;
-          static_function.attributes     = ToJSPropertyAttributes(property_attributes);
-          static_functions__.push_back(static_function);
-          // HAL_LOG_DEBUG("JSExportClassDefinition<", name__, "> added function property ", static_functions__.back().name);
-        }
+      for (std::size_t index = 0; index < named_function_property_callbacks__.size(); ++index) {
+        const auto& function_name       = named_function_property_callbacks__[index].first;
+        const auto& property_attributes = named_function_property_callbacks__[index].second.get_attributes();
+        ::JSStaticFunction static_function;
+        static_function.name           = function_name.c_str();
+        static_function.callAsFunction = JSExportClass<T>::GetNamedFunctionCallback(index);
+        static_function.attributes     = ToJSPropertyAttributes(property_attributes);
+        static_functions__.push_back(static_function);
+        // HAL_LOG_DEBUG("JSExportClassDefinition<", name__, "> added function property ", static_functions__.back().name);
+      }
+      for (const auto& entry : named_static_functions__) {
+        ::JSStaticFunction static_function = entry.second;
+        static_function.name               = entry.first.c_str();
+        static_functions__.push_back(static_function);
+      }
+      if (!static_functions__.empty()) {
         static_functions__.push_back({nullptr, nullptr, kJSPropertyAttributeNone});
         js_class_definition__.staticFunctions = &static_functions__[0];
       }
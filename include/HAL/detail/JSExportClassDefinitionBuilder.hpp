@@ -12,9 +12,12 @@
 #include "HAL/detail/JSBase.hpp"
 #include "HAL/detail/JSExportClassDefinition.hpp"
 #include "HAL/detail/JSExportClass.hpp"
+#include "HAL/detail/JSExportMethod.hpp"
 #include "HAL/detail/JSUtil.hpp"
 
+#include <algorithm>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 
 #undef HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_MUTEX
@@ -200,6 +203,48 @@ namespace HAL { namespace detail {
       return *this;
     }
     
+    /*!
+     @method
+     
+     @abstract Return whether your JSClass installs its constant
+     properties on its prototype.
+     
+     @result true if your JSClass installs its constant properties on
+     its prototype.
+     */
+    bool ConstantsInPrototype() const HAL_NOEXCEPT {
+      return constants_in_prototype__;
+    }
+    
+    /*!
+     @method
+     
+     @abstract Set whether your JSClass installs its constant
+     properties on its prototype. The default value is false.
+     
+     @discussion By default reading a constant property calls into
+     native code, which returns the cached value. Instead, when this
+     is true, the first time a JavaScript object of your JSClass is
+     created in a JavaScript execution context the getter callback of
+     every constant property is invoked once and the values are
+     installed on the automatically generated prototype as plain data
+     properties with the same attributes. Reading them never calls
+     into native code again, and JavaScriptCore optimizes them like
+     any other data property.
+     
+     The constant properties then belong to the prototype rather than
+     to each JavaScript object, e.g. hasOwnProperty returns false for
+     them. This has no effect if the JSClassAttribute is
+     'NoAutomaticPrototype'.
+     
+     @result A reference to the builder for chaining.
+     */
+    JSExportClassDefinitionBuilder<T>& ConstantsInPrototype(bool constants_in_prototype) HAL_NOEXCEPT {
+      HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
+      constants_in_prototype__ = constants_in_prototype;
+      return *this;
+    }
+    
     /*!
      @method
      
@@ -233,10 +278,12 @@ namespace HAL { namespace detail {
      property's value from your JavaScript object.
      
      @param set_callback The callback to invoke when setting a
-     property's value on your JavaScript object. This may be nullptr,
-     in which case the 'ReadOnly' attribute for this property is
-     automatically set. If this callback returns false, then this
-     indicates that the value was not set.
+     property's value on your JavaScript object, either a
+     SetNamedValuePropertyCallback or a
+     SetNamedValuePropertyLocalCallback. This may be nullptr, in which
+     case the 'ReadOnly' attribute for this property is automatically
+     set. If this callback returns false, then this indicates that the
+     value was not set.
      
      @param enumerable An optional property attribute that specifies
      whether the property is enumerable. The default value is true,
@@ -250,14 +297,75 @@ namespace HAL { namespace detail {
      
      @result A reference to the builder for chaining.
      */
-    JSExportClassDefinitionBuilder<T>& AddValueProperty(const JSString& property_name, GetNamedValuePropertyCallback<T> get_callback, SetNamedValuePropertyCallback<T> set_callback = nullptr, bool enumerable = true) {
+    template<typename U = std::nullptr_t>
+    JSExportClassDefinitionBuilder<T>& AddValueProperty(const JSString& property_name, GetNamedValuePropertyCallback<T> get_callback, U set_callback = nullptr, bool enumerable = true) {
+      // The 'ReadOnly' attribute is set by
+      // JSExportNamedValuePropertyCallback when set_callback is
+      // missing.
       std::unordered_set<JSPropertyAttribute> attributes { JSPropertyAttribute::DontDelete };
-      static_cast<void>(!enumerable   && attributes.insert(JSPropertyAttribute::DontEnum).second);
-      static_cast<void>(!set_callback && attributes.insert(JSPropertyAttribute::ReadOnly).second);
+      static_cast<void>(!enumerable && attributes.insert(JSPropertyAttribute::DontEnum).second);
       HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
       AddValuePropertyCallback(JSExportNamedValuePropertyCallback<T>(property_name, get_callback, set_callback, attributes));
       return *this;
     }
+    
+    /*!
+     @method
+     
+     @abstract Add a read-only value property implemented by a getter
+     named at compile time with HAL_EXPORT_METHOD. The property will
+     always have the 'DontDelete' and 'ReadOnly' attributes. By
+     default the property is enumerable unless you specify otherwise.
+     
+     @discussion Unlike the overload above, the getter is called
+     directly by its own JavaScriptCore callback instead of through a
+     std::function looked up by property name. For example:
+     
+     builder.AddValueProperty("pi", HAL_EXPORT_METHOD(&Foo::GetPi));
+     
+     See JSExportMethod for the supported signatures.
+     
+     @throws std::invalid_argument exception if property_name is
+     empty or was already added.
+     
+     @result A reference to the builder for chaining.
+     */
+    template<typename M, M get_method>
+    JSExportClassDefinitionBuilder<T>& AddValueProperty(const JSString& property_name, JSExportMethod<M, get_method>, bool enumerable = true) {
+      std::unordered_set<JSPropertyAttribute> attributes { JSPropertyAttribute::DontDelete, JSPropertyAttribute::ReadOnly };
+      static_cast<void>(!enumerable && attributes.insert(JSPropertyAttribute::DontEnum).second);
+      HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
+      AddStaticValue(property_name, JSExportClass<T>::template GetStaticValueCallback<M, get_method>, nullptr, attributes);
+      return *this;
+    }
+    
+    /*!
+     @method
+     
+     @abstract Add a value property implemented by a getter and a
+     setter named at compile time with HAL_EXPORT_METHOD. The property
+     will always have the 'DontDelete' attribute. By default the
+     property is enumerable unless you specify otherwise.
+     
+     @discussion For example:
+     
+     builder.AddValueProperty("name", HAL_EXPORT_METHOD(&Foo::GetName), HAL_EXPORT_METHOD(&Foo::SetName));
+     
+     See JSExportMethod for the supported signatures.
+     
+     @throws std::invalid_argument exception if property_name is
+     empty or was already added.
+     
+     @result A reference to the builder for chaining.
+     */
+    template<typename M, M get_method, typename N, N set_method>
+    JSExportClassDefinitionBuilder<T>& AddValueProperty(const JSString& property_name, JSExportMethod<M, get_method>, JSExportMethod<N, set_method>, bool enumerable = true) {
+      std::unordered_set<JSPropertyAttribute> attributes { JSPropertyAttribute::DontDelete };
+      static_cast<void>(!enumerable && attributes.insert(JSPropertyAttribute::DontEnum).second);
+      HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
+      AddStaticValue(property_name, JSExportClass<T>::template GetStaticValueCallback<M, get_method>, JSExportClass<T>::template SetStaticValueCallback<N, set_method>, attributes);
+      return *this;
+    }
 
     /*!
      @method
@@ -332,6 +440,10 @@ namespace HAL { namespace detail {
      
      @param function_name A JSString containing the function's name.
      
+     @param function_callback The callback to invoke when calling your
+     JavaScript object as a function, either a
+     CallNamedFunctionArgumentsCallback or a CallNamedFunctionCallback.
+     
      @param enumerable An optional property attribute that specifies
      whether the property is enumerable. The default value is true,
      which means the property is enumerable.
@@ -341,10 +453,14 @@ namespace HAL { namespace detail {
      1. If function_name is empty.
      
      2. If function_callback is not provided.
-     
+
+     3. If HAL_JSEXPORT_FUNCTION_PROPERTY_MAX function properties
+     have already been added.
+
      @result A reference to the builder for chaining.
      */
-    JSExportClassDefinitionBuilder<T>& AddFunctionProperty(const JSString& function_name, CallNamedFunctionCallback<T> function_callback, bool enumerable = true) {
+    template<typename U>
+    JSExportClassDefinitionBuilder<T>& AddFunctionProperty(const JSString& function_name, U function_callback, bool enumerable = true) {
       std::unordered_set<JSPropertyAttribute> attributes { JSPropertyAttribute::DontDelete, JSPropertyAttribute::ReadOnly };
       static_cast<void>(!enumerable && attributes.insert(JSPropertyAttribute::DontEnum).second);
       HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
@@ -352,6 +468,37 @@ namespace HAL { namespace detail {
       return *this;
     }
     
+    /*!
+     @method
+     
+     @abstract Add a function property implemented by a member
+     function named at compile time with HAL_EXPORT_METHOD, with the
+     'DontDelete' and 'ReadOnly' attributes. By default the property
+     is enumerable unless you specify otherwise.
+     
+     @discussion Unlike the overload above, the member function is
+     called directly by its own JavaScriptCore callback instead of
+     through a std::function, and it doesn't count towards
+     HAL_JSEXPORT_FUNCTION_PROPERTY_MAX. For example:
+     
+     builder.AddFunctionProperty("hello", HAL_EXPORT_METHOD(&Foo::Hello));
+     
+     See JSExportMethod for the supported signatures.
+     
+     @throws std::invalid_argument exception if function_name is
+     empty or was already added.
+     
+     @result A reference to the builder for chaining.
+     */
+    template<typename M, M method>
+    JSExportClassDefinitionBuilder<T>& AddFunctionProperty(const JSString& function_name, JSExportMethod<M, method>, bool enumerable = true) {
+      std::unordered_set<JSPropertyAttribute> attributes { JSPropertyAttribute::DontDelete, JSPropertyAttribute::ReadOnly };
+      static_cast<void>(!enumerable && attributes.insert(JSPropertyAttribute::DontEnum).second);
+      HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
+      AddStaticFunction(function_name, JSExportClass<T>::template CallStaticFunctionCallback<M, method>, attributes);
+      return *this;
+    }
+    
     /*!
      @method
      
@@ -595,7 +742,7 @@ namespace HAL { namespace detail {
      @result The callback to invoke when your JavaScript object is
      called as a function.
      */
-    CallAsFunctionCallback<T> CallAsFunction() const HAL_NOEXCEPT {
+    CallAsFunctionArgumentsCallback<T> CallAsFunction() const HAL_NOEXCEPT {
       return call_as_function_callback__;
     }
     
@@ -625,11 +772,15 @@ namespace HAL { namespace detail {
      is the context of the function call (i.e. the 'this' JavaScript
      object).
      
+     @param call_as_function_callback Either a
+     CallAsFunctionArgumentsCallback or a CallAsFunctionCallback.
+     
      @result A reference to the builder for chaining.
      */
-    JSExportClassDefinitionBuilder<T>& CallAsFunction(const CallAsFunctionCallback<T>& call_as_function_callback) HAL_NOEXCEPT {
+    template<typename U>
+    JSExportClassDefinitionBuilder<T>& CallAsFunction(const U& call_as_function_callback) HAL_NOEXCEPT {
       HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
-      call_as_function_callback__ = call_as_function_callback;
+      call_as_function_callback__ = ToArgumentsCallback<T>(call_as_function_callback);
       return *this;
     }
     
@@ -694,6 +845,13 @@ namespace HAL { namespace detail {
     void AddConstantPropertyCallback(const JSExportNamedValuePropertyCallback<T>& value_property_callback);
     void AddValuePropertyCallback(const JSExportNamedValuePropertyCallback<T>& value_property_callback);
     void AddFunctionPropertyCallback(const JSExportNamedFunctionPropertyCallback<T>& function_property_callback);
+    void AddStaticValue(const std::string& property_name, ::JSObjectGetPropertyCallback get_callback, ::JSObjectSetPropertyCallback set_callback, const std::unordered_set<JSPropertyAttribute>& attributes);
+    void AddStaticFunction(const std::string& function_name, ::JSObjectCallAsFunctionCallback function_callback, const std::unordered_set<JSPropertyAttribute>& attributes);
+    
+    template<typename U>
+    static bool Contains(const U& named_entries, const std::string& name) HAL_NOEXCEPT {
+      return std::find_if(named_entries.begin(), named_entries.end(), [&name](const typename U::value_type& entry) { return entry.first == name; }) != named_entries.end();
+    }
     
     // JSExportClassDefinition needs access to js_class_definition__ in
     // accordance with the Builder Pattern.
@@ -704,14 +862,17 @@ namespace HAL { namespace detail {
     std::string                                   name__;
     JSClass                                       parent__;
     std::unordered_set<std::string>               named_constants__;
+    bool                                          constants_in_prototype__       { false };
     JSExportNamedValuePropertyCallbackMap_t<T>    named_value_property_callback_map__;
     JSExportNamedFunctionPropertyCallbackMap_t<T> named_function_property_callback_map__;
+    JSExportStaticValues_t                        named_static_values__;
+    JSExportStaticFunctions_t                     named_static_functions__;
     HasPropertyCallback<T>                        has_property_callback__        { nullptr };
     GetPropertyCallback<T>                        get_property_callback__        { nullptr };
     SetPropertyCallback<T>                        set_property_callback__        { nullptr };
     DeletePropertyCallback<T>                     delete_property_callback__     { nullptr };
     GetPropertyNamesCallback<T>                   get_property_names_callback__  { nullptr };
-    CallAsFunctionCallback<T>                     call_as_function_callback__    { nullptr };
+    CallAsFunctionArgumentsCallback<T>            call_as_function_callback__    { nullptr };
     ConvertToTypeCallback<T>                      convert_to_type_callback__     { nullptr };
 
     HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_MUTEX;
@@ -742,7 +903,7 @@ namespace HAL { namespace detail {
     const std::string internal_component_name = "JSExportClassDefinitionBuilder<" + name__ + ">::AddValuePropertyCallback";
     const auto property_name                  = value_property_callback.get_name();
     const auto position                       = named_value_property_callback_map__.find(property_name);
-    const bool found                          = position != named_value_property_callback_map__.end();
+    const bool found                          = position != named_value_property_callback_map__.end() || Contains(named_static_values__, property_name);
     
     if (found) {
       const std::string message = "Value property " + property_name + " already added";
@@ -761,13 +922,18 @@ namespace HAL { namespace detail {
     const std::string internal_component_name = "JSExportClassDefinitionBuilder<" + name__ + ">::AddFunctionPropertyCallback";
     const auto property_name                  = function_property_callback.get_name();
     const auto position                       = named_function_property_callback_map__.find(property_name);
-    const bool found                          = position != named_function_property_callback_map__.end();
+    const bool found                          = position != named_function_property_callback_map__.end() || Contains(named_static_functions__, property_name);
     
     if (found) {
       const std::string message = "Function property " + property_name + " already added.";
       ThrowInvalidArgument(internal_component_name, message);
     }
     
+    if (named_function_property_callback_map__.size() >= HAL_JSEXPORT_FUNCTION_PROPERTY_MAX) {
+      const std::string message = "Function property " + property_name + " exceeds the limit of " + std::to_string(HAL_JSEXPORT_FUNCTION_PROPERTY_MAX) + " function properties.";
+      ThrowInvalidArgument(internal_component_name, message);
+    }
+    
     const auto callback_insert_result = named_function_property_callback_map__.emplace(property_name, function_property_callback);
     const bool callback_inserted      = callback_insert_result.second;
     
@@ -775,6 +941,45 @@ namespace HAL { namespace detail {
     assert(callback_inserted);
   }
   
+  template<typename T>
+  void JSExportClassDefinitionBuilder<T>::AddStaticValue(const std::string& property_name, ::JSObjectGetPropertyCallback get_callback, ::JSObjectSetPropertyCallback set_callback, const std::unordered_set<JSPropertyAttribute>& attributes) {
+    const std::string internal_component_name = "JSExportClassDefinitionBuilder<" + name__ + ">::AddStaticValue";
+    if (property_name.empty()) {
+      ThrowInvalidArgument(internal_component_name, "property_name is missing");
+    }
+    
+    if (named_value_property_callback_map__.find(property_name) != named_value_property_callback_map__.end() || Contains(named_static_values__, property_name)) {
+      const std::string message = "Value property " + property_name + " already added";
+      ThrowInvalidArgument(internal_component_name, message);
+    }
+    
+    ::JSStaticValue static_value;
+    static_value.name        = nullptr;
+    static_value.getProperty = get_callback;
+    static_value.setProperty = set_callback;
+    static_value.attributes  = ToJSPropertyAttributes(attributes);
+    named_static_values__.emplace_back(property_name, static_value);
+  }
+  
+  template<typename T>
+  void JSExportClassDefinitionBuilder<T>::AddStaticFunction(const std::string& function_name, ::JSObjectCallAsFunctionCallback function_callback, const std::unordered_set<JSPropertyAttribute>& attributes) {
+    const std::string internal_component_name = "JSExportClassDefinitionBuilder<" + name__ + ">::AddStaticFunction";
+    if (function_name.empty()) {
+      ThrowInvalidArgument(internal_component_name, "function_name is missing");
+    }
+    
+    if (named_function_property_callback_map__.find(function_name) != named_function_property_callback_map__.end() || Contains(named_static_functions__, function_name)) {
+      const std::string message = "Function property " + function_name + " already added.";
+      ThrowInvalidArgument(internal_component_name, message);
+    }
+    
+    ::JSStaticFunction static_function;
+    static_function.name           = nullptr;
+    static_function.callAsFunction = function_callback;
+    static_function.attributes     = ToJSPropertyAttributes(attributes);
+    named_static_functions__.emplace_back(function_name, static_function);
+  }
+  
   template<typename T>
   JSExportClassDefinition<T> JSExportClassDefinitionBuilder<T>::build() {
     HAL_DETAIL_JSEXPORTCLASSDEFINITIONBUILDER_LOCK_GUARD;
@@ -822,8 +1027,11 @@ namespace HAL { namespace detail {
   JSExportClassDefinition<T>::JSExportClassDefinition(const JSExportClassDefinitionBuilder<T>& builder)
   : JSClassDefinition(builder.js_class_definition__)
   , named_constants__(builder.named_constants__)
+  , constants_in_prototype__(builder.constants_in_prototype__ && !(builder.js_class_definition__.attributes & kJSClassAttributeNoAutomaticPrototype))
   , named_value_property_callback_map__(builder.named_value_property_callback_map__)
-  , named_function_property_callback_map__(builder.named_function_property_callback_map__)
+  , named_function_property_callbacks__(builder.named_function_property_callback_map__.begin(), builder.named_function_property_callback_map__.end())
+  , named_static_values__(builder.named_static_values__)
+  , named_static_functions__(builder.named_static_functions__)
   , has_property_callback__(builder.has_property_callback__)
   , get_property_callback__(builder.get_property_callback__)
   , set_property_callback__(builder.set_property_callback__)
@@ -0,0 +1,139 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_DETAIL_JSEXPORTCONSTANTSCACHE_HPP_
+#define _HAL_DETAIL_JSEXPORTCONSTANTSCACHE_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace HAL { namespace detail {
+
+  /*!
+   @class
+
+   @discussion A JSExportConstantsCache is a least-recently-used cache
+   of the values of one JSExport class's constant properties (see
+   JSExport::AddConstantProperty) in one JavaScript context. Finding,
+   inserting and evicting a value are all O(1): a hash map indexes a
+   list kept in most-recently-used order.
+
+   The cache protects its values on behalf of its context instead of
+   holding JSValues, since a JSValue would keep the context alive.
+   Every JSContextLifetime owns one per JSExport class and destroys
+   them before releasing its global context.
+
+   For a JSExport class that installs its constants on its prototype
+   instead (see JSExport::SetConstantsInPrototype) the cache also
+   remembers the prototypes they were installed on.
+   */
+  class HAL_EXPORT JSExportConstantsCache final {
+
+  public:
+
+    struct Statistics {
+      std::uint64_t hits      { 0 };
+      std::uint64_t misses    { 0 };
+      std::uint64_t evictions { 0 };
+    };
+
+    JSExportConstantsCache(JSGlobalContextRef js_global_context_ref, std::uint32_t capacity) HAL_NOEXCEPT;
+    ~JSExportConstantsCache() HAL_NOEXCEPT;
+
+    // Return the cached value of the named constant, or nullptr if it
+    // isn't cached.
+    JSValueRef Find(const std::string& property_name) HAL_NOEXCEPT;
+
+    // Cache the value of the named constant unless it is already
+    // cached, evicting the least-recently-used value if the cache is
+    // full.
+    void Insert(const std::string& property_name, JSValueRef js_value_ref);
+
+    // Evict the least-recently-used value, if any.
+    void EvictLeastRecentlyUsed() HAL_NOEXCEPT;
+
+    // Evict every value.
+    void Clear() HAL_NOEXCEPT;
+
+    // Evict every value and change the capacity. A capacity of 0
+    // disables the cache.
+    void Resize(std::uint32_t capacity) HAL_NOEXCEPT;
+
+    // Return true if the constants were installed on the given
+    // prototype.
+    bool IsInstalledOn(JSObjectRef prototype_ref) const HAL_NOEXCEPT;
+
+    // Remember that the constants were installed on the given
+    // prototype. The prototype stays protected until the context goes
+    // away, since JavaScriptCore would otherwise be free to collect it
+    // and hand out a new one without them.
+    void SetInstalledOn(JSObjectRef prototype_ref);
+
+    // Return the names of the cached constants in most-recently-used
+    // order.
+    std::vector<std::string> GetKeys() const;
+
+    std::size_t size() const HAL_NOEXCEPT {
+      return entries__.size();
+    }
+
+    std::uint32_t get_capacity() const HAL_NOEXCEPT {
+      return capacity__;
+    }
+
+    Statistics get_statistics() const HAL_NOEXCEPT {
+      return statistics__;
+    }
+
+    // The JSExportClass-wide generation this cache was last
+    // synchronized with, see JSExportClass::ResizeCache.
+    std::uint64_t get_generation() const HAL_NOEXCEPT {
+      return generation__;
+    }
+
+    void set_generation(std::uint64_t generation) HAL_NOEXCEPT {
+      generation__ = generation;
+    }
+
+    JSExportConstantsCache(const JSExportConstantsCache&)            = delete;
+    JSExportConstantsCache(JSExportConstantsCache&&)                 = delete;
+    JSExportConstantsCache& operator=(const JSExportConstantsCache&) = delete;
+    JSExportConstantsCache& operator=(JSExportConstantsCache&&)      = delete;
+
+  private:
+
+    using Entry = std::pair<std::string, JSValueRef>;
+
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    JSGlobalContextRef js_global_context_ref__ { nullptr };
+    std::uint32_t      capacity__              { 0 };
+    std::uint64_t      generation__            { 0 };
+    Statistics         statistics__;
+
+    // Most-recently-used first.
+    std::list<Entry>                                         entries__;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index__;
+
+    // The prototypes the constants were installed on. There is usually
+    // just one, so a vector beats a set.
+    std::vector<JSObjectRef> prototypes__;
+#pragma warning(pop)
+  };
+
+}} // namespace HAL { namespace detail {
+
+#endif // _HAL_DETAIL_JSEXPORTCONSTANTSCACHE_HPP_
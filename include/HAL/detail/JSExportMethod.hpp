@@ -0,0 +1,123 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_DETAIL_JSEXPORTMETHOD_HPP_
+#define _HAL_DETAIL_JSEXPORTMETHOD_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/detail/JSNativeFunction.hpp"
+#include "HAL/JSValue.hpp"
+#include "HAL/JSArguments.hpp"
+#include "HAL/JSLocal.hpp"
+#include "HAL/JSObject.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace HAL { namespace detail {
+
+  /*!
+   @class
+
+   @discussion A JSExportMethod names a member function of a JSExport
+   class at compile time. Use the HAL_EXPORT_METHOD macro to create
+   one, and pass it to JSExport::AddValueProperty or
+   JSExport::AddFunctionProperty in place of a std::mem_fn:
+
+   AddValueProperty("name", HAL_EXPORT_METHOD(&Foo::GetName), HAL_EXPORT_METHOD(&Foo::SetName));
+   AddFunctionProperty("hello", HAL_EXPORT_METHOD(&Foo::Hello));
+
+   Each member function gets its own JavaScriptCore callback, which
+   calls it directly instead of through a std::function looked up by
+   property name.
+
+   The supported member function signatures are:
+
+   Getter  : R GetName() [const];
+
+   Setter  : bool SetName(V value);
+             void SetName(V value);
+
+   Function: JSValue Hello(const std::vector<JSValue>& arguments, JSObject& this_object);
+             JSValue Hello(const JSArguments& arguments, JSObject& this_object);
+             R Hello(Args... arguments) [const];
+
+   where R, V and each of Args is a type with a JSConverter, such as
+   JSValue, std::string or double, optionally taken by const
+   reference, and R may also be void. For example:
+
+   double Scale(double factor, int32_t steps, const std::string& unit);
+
+   Arguments are converted straight from JavaScript without building a
+   std::vector<JSValue>. A missing argument, or a value of the wrong
+   JavaScript type, throws a JavaScript exception instead of calling
+   the member function.
+   */
+  template<typename M, M method>
+  struct JSExportMethod final {
+  };
+
+  // Call the member function that implements a value property's
+  // getter, converting its result with JSConverter.
+  template<typename T, typename U, typename R>
+  inline JSValue InvokeJSExportGetter(T& native_object, R (U::*method)(), const JSObject& js_object) {
+    return JSConverter<JSNativeType<R>>::ToJS(js_object.get_context(), (native_object.*method)());
+  }
+
+  template<typename T, typename U, typename R>
+  inline JSValue InvokeJSExportGetter(T& native_object, R (U::*method)() const, const JSObject& js_object) {
+    return JSConverter<JSNativeType<R>>::ToJS(js_object.get_context(), (native_object.*method)());
+  }
+
+  // Call the member function that implements a value property's
+  // setter, converting the value with JSConverter.
+  template<typename T, typename U, typename V>
+  inline bool InvokeJSExportSetter(T& native_object, bool (U::*method)(V), const JSLocal& js_value) {
+    return (native_object.*method)(ToNativeValue<V>(js_value, "value"));
+  }
+
+  template<typename T, typename U, typename V>
+  inline bool InvokeJSExportSetter(T& native_object, void (U::*method)(V), const JSLocal& js_value) {
+    (native_object.*method)(ToNativeValue<V>(js_value, "value"));
+    return true;
+  }
+
+  // Call the member function that implements a function property.
+  template<typename T, typename U>
+  inline JSValue InvokeJSExportFunction(T& native_object, JSValue (U::*method)(const std::vector<JSValue>&, JSObject&), const JSArguments& arguments, JSObject& this_object) {
+    return (native_object.*method)(arguments.ToVector(), this_object);
+  }
+
+  template<typename T, typename U>
+  inline JSValue InvokeJSExportFunction(T& native_object, JSValue (U::*method)(const JSArguments&, JSObject&), const JSArguments& arguments, JSObject& this_object) {
+    return (native_object.*method)(arguments, this_object);
+  }
+
+  // Call a member function with a typed signature, converting each
+  // argument and the result with JSConverter.
+  template<typename T, typename U, typename R, typename... Args>
+  inline JSValue InvokeJSExportFunction(T& native_object, R (U::*method)(Args...), const JSArguments& arguments, JSObject& this_object) {
+    return JSNativeSignature<R, Args...>::Invoke(this_object.get_context(), [&native_object, method](Args... native_arguments) {
+      return (native_object.*method)(std::forward<Args>(native_arguments)...);
+    }, arguments);
+  }
+
+  template<typename T, typename U, typename R, typename... Args>
+  inline JSValue InvokeJSExportFunction(T& native_object, R (U::*method)(Args...) const, const JSArguments& arguments, JSObject& this_object) {
+    return JSNativeSignature<R, Args...>::Invoke(this_object.get_context(), [&native_object, method](Args... native_arguments) {
+      return (native_object.*method)(std::forward<Args>(native_arguments)...);
+    }, arguments);
+  }
+
+}} // namespace HAL { namespace detail {
+
+// Name a member function of a JSExport class at compile time, see
+// HAL::detail::JSExportMethod.
+#define HAL_EXPORT_METHOD(method) ::HAL::detail::JSExportMethod<decltype(method), method>()
+
+#endif // _HAL_DETAIL_JSEXPORTMETHOD_HPP_
@@ -44,12 +44,12 @@ namespace HAL { namespace detail {
      For example, given this class definition:
      
      class Foo {
-     JSValue sayHello(const std::vector<JSValue>& arguments, JSObject& this_object);
+     JSValue sayHello(const JSArguments& arguments, JSObject& this_object);
      };
      
      You would define the callback like this:
      
-     CallNamedFunctionCallback callback(&Foo::sayHello);
+     CallNamedFunctionArgumentsCallback callback(&Foo::sayHello);
      
      @param name The function property's name.
      
@@ -70,10 +70,29 @@ namespace HAL { namespace detail {
      2. If the function_callback is not provided.
      */
     JSExportNamedFunctionPropertyCallback(const std::string& function_name,
-                                          CallNamedFunctionCallback<T> function_callback,
+                                          CallNamedFunctionArgumentsCallback<T> function_callback,
                                           const std::unordered_set<JSPropertyAttribute>& attributes);
     
-    CallNamedFunctionCallback<T> function_callback() const {
+    /*!
+     @method
+     
+     @abstract Create a callback to invoke when a JavaScript object
+     is called as a function, where the function_callback receives
+     its arguments as a std::vector<JSValue>.
+     
+     @discussion The function_callback is adapted to a
+     CallNamedFunctionArgumentsCallback that copies the arguments into
+     a std::vector<JSValue> before calling it. See the constructor
+     above for the meaning of the parameters and the exceptions
+     thrown.
+     */
+    JSExportNamedFunctionPropertyCallback(const std::string& function_name,
+                                          CallNamedFunctionCallback<T> function_callback,
+                                          const std::unordered_set<JSPropertyAttribute>& attributes)
+    : JSExportNamedFunctionPropertyCallback(function_name, ToArgumentsCallback<T>(function_callback), attributes) {
+    }
+    
+    const CallNamedFunctionArgumentsCallback<T>& function_callback() const {
       return function_callback__;
     }
     
@@ -89,13 +108,13 @@ namespace HAL { namespace detail {
     template<typename U>
     friend bool operator==(const JSExportNamedFunctionPropertyCallback<U>& lhs, const JSExportNamedFunctionPropertyCallback<U>& rhs) HAL_NOEXCEPT;
     
-    CallNamedFunctionCallback<T> function_callback__ { nullptr };
+    CallNamedFunctionArgumentsCallback<T> function_callback__ { nullptr };
   };
   
   template<typename T>
   JSExportNamedFunctionPropertyCallback<T>::JSExportNamedFunctionPropertyCallback(
                                                                                   const std::string& function_name,
-                                                                                  CallNamedFunctionCallback<T> function_callback,
+                                                                                  CallNamedFunctionArgumentsCallback<T> function_callback,
                                                                                   const std::unordered_set<JSPropertyAttribute>& attributes)
   : JSPropertyCallback(function_name, attributes)
   , function_callback__(function_callback) {
@@ -13,6 +13,9 @@
 #include "HAL/detail/JSPropertyCallback.hpp"
 #include "HAL/detail/JSExportCallbacks.hpp"
 #include "HAL/detail/JSUtil.hpp"
+#include "HAL/JSLocal.hpp"
+
+#include <cstddef>
 
 namespace HAL { namespace detail {
   
@@ -61,16 +64,42 @@ namespace HAL { namespace detail {
      
      4. If both get_callback and set_callback are missing.
      */
+    JSExportNamedValuePropertyCallback(const std::string& property_name,
+                                       GetNamedValuePropertyCallback<T> get_callback,
+                                       SetNamedValuePropertyLocalCallback<T> set_callback,
+                                       const std::unordered_set<JSPropertyAttribute>& attributes);
+    
+    /*!
+     @method
+     
+     @abstract Set the callbacks to invoke when getting and setting
+     a property value on a JavaScript object, where the set_callback
+     receives the property's value as a JSValue.
+     
+     @discussion The set_callback is adapted to a
+     SetNamedValuePropertyLocalCallback that promotes the value to a
+     JSValue before calling it. See the constructor above for the
+     meaning of the parameters and the exceptions thrown.
+     */
     JSExportNamedValuePropertyCallback(const std::string& property_name,
                                        GetNamedValuePropertyCallback<T> get_callback,
                                        SetNamedValuePropertyCallback<T> set_callback,
                                        const std::unordered_set<JSPropertyAttribute>& attributes);
     
+    // Disambiguates a missing set_callback between the two
+    // constructors above.
+    JSExportNamedValuePropertyCallback(const std::string& property_name,
+                                       GetNamedValuePropertyCallback<T> get_callback,
+                                       std::nullptr_t,
+                                       const std::unordered_set<JSPropertyAttribute>& attributes)
+    : JSExportNamedValuePropertyCallback(property_name, get_callback, SetNamedValuePropertyLocalCallback<T>(), attributes) {
+    }
+    
     GetNamedValuePropertyCallback<T> get_callback() const HAL_NOEXCEPT {
       return get_callback__;
     }
     
-    SetNamedValuePropertyCallback<T> set_callback() const HAL_NOEXCEPT {
+    const SetNamedValuePropertyLocalCallback<T>& set_callback() const HAL_NOEXCEPT {
       return set_callback__;
     }
     
@@ -86,15 +115,17 @@ namespace HAL { namespace detail {
     template<typename U>
     friend bool operator==(const JSExportNamedValuePropertyCallback<U>& lhs, const JSExportNamedValuePropertyCallback<U>& rhs) HAL_NOEXCEPT;
     
-    GetNamedValuePropertyCallback<T> get_callback__;
-    SetNamedValuePropertyCallback<T> set_callback__;
+    static SetNamedValuePropertyLocalCallback<T> ToLocalCallback(SetNamedValuePropertyCallback<T> set_callback);
+    
+    GetNamedValuePropertyCallback<T>      get_callback__;
+    SetNamedValuePropertyLocalCallback<T> set_callback__;
   };
   
   template<typename T>
   JSExportNamedValuePropertyCallback<T>::JSExportNamedValuePropertyCallback(
                                                                             const std::string& property_name,
                                                                             GetNamedValuePropertyCallback<T> get_callback,
-                                                                            SetNamedValuePropertyCallback<T> set_callback,
+                                                                            SetNamedValuePropertyLocalCallback<T> set_callback,
                                                                             const std::unordered_set<JSPropertyAttribute>& attributes)
   : JSPropertyCallback(property_name, attributes)
   , get_callback__(get_callback)
@@ -121,6 +152,26 @@ namespace HAL { namespace detail {
     }
   }
   
+  template<typename T>
+  JSExportNamedValuePropertyCallback<T>::JSExportNamedValuePropertyCallback(
+                                                                            const std::string& property_name,
+                                                                            GetNamedValuePropertyCallback<T> get_callback,
+                                                                            SetNamedValuePropertyCallback<T> set_callback,
+                                                                            const std::unordered_set<JSPropertyAttribute>& attributes)
+  : JSExportNamedValuePropertyCallback(property_name, get_callback, ToLocalCallback(set_callback), attributes) {
+  }
+  
+  template<typename T>
+  SetNamedValuePropertyLocalCallback<T> JSExportNamedValuePropertyCallback<T>::ToLocalCallback(SetNamedValuePropertyCallback<T> set_callback) {
+    if (!set_callback) {
+      return nullptr;
+    }
+    
+    return [set_callback](T& native_object, const JSLocal& js_value) {
+      return set_callback(native_object, js_value.ToPersistent());
+    };
+  }
+  
   template<typename T>
   JSExportNamedValuePropertyCallback<T>::JSExportNamedValuePropertyCallback(const JSExportNamedValuePropertyCallback& rhs) HAL_NOEXCEPT
   : JSPropertyCallback(rhs)
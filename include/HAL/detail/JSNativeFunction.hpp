@@ -0,0 +1,115 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_DETAIL_JSNATIVEFUNCTION_HPP_
+#define _HAL_DETAIL_JSNATIVEFUNCTION_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+#include "HAL/detail/JSUtil.hpp"
+#include "HAL/JSConverter.hpp"
+#include "HAL/JSArguments.hpp"
+#include "HAL/JSUndefined.hpp"
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace HAL { namespace detail {
+
+  // The type a native function's argument or result is converted
+  // to or from, e.g. std::string for const std::string&.
+  template<typename T>
+  using JSNativeType = typename std::decay<T>::type;
+
+  // Convert a JavaScript value to the native type T, throwing
+  // std::invalid_argument naming the value as description if it
+  // doesn't have the JavaScript type T expects.
+  template<typename T>
+  JSNativeType<T> ToNativeValue(const JSLocal& js_value, const std::string& description) {
+    static_assert(!std::is_lvalue_reference<T>::value || std::is_const<typename std::remove_reference<T>::type>::value,
+                  "native arguments must be taken by value or by const reference");
+    if (!JSConverter<JSNativeType<T>>::IsConvertible(js_value)) {
+      ThrowInvalidArgument("JSNativeFunction", description + " is not " + JSConverter<JSNativeType<T>>::GetTypeName());
+    }
+    return JSConverter<JSNativeType<T>>::FromJS(js_value);
+  }
+
+  // Convert a native value to JavaScript.
+  template<typename R>
+  struct JSNativeResult final {
+    template<typename F, typename... Args>
+    static JSValue Invoke(const JSContext& js_context, F&& function, Args&&... arguments) {
+      return JSConverter<JSNativeType<R>>::ToJS(js_context, std::forward<F>(function)(std::forward<Args>(arguments)...));
+    }
+  };
+
+  template<>
+  struct JSNativeResult<void> final {
+    template<typename F, typename... Args>
+    static JSValue Invoke(const JSContext& js_context, F&& function, Args&&... arguments) {
+      std::forward<F>(function)(std::forward<Args>(arguments)...);
+      return js_context.CreateUndefined();
+    }
+  };
+
+  /*!
+   @class
+
+   @discussion A JSNativeSignature<R, Args...> calls a native function
+   of type R(Args...) with the arguments of a JavaScript function call,
+   converting each of them with JSConverter directly from the
+   JSArguments and the result back to a JSValue.
+
+   Missing arguments, and arguments of the wrong JavaScript type, throw
+   std::invalid_argument before the native function is called. Extra
+   arguments are ignored, as they are by JavaScript functions.
+   */
+  template<typename R, typename... Args>
+  struct JSNativeSignature final {
+
+    template<typename F>
+    static JSValue Invoke(const JSContext& js_context, F&& function, const JSArguments& arguments) {
+      if (arguments.size() < sizeof...(Args)) {
+        ThrowInvalidArgument("JSNativeFunction", "expected " + std::to_string(sizeof...(Args)) + " arguments but got " + std::to_string(arguments.size()));
+      }
+      return Invoke(js_context, std::forward<F>(function), arguments, make_index_sequence<sizeof...(Args)>());
+    }
+
+  private:
+
+    template<typename F, std::size_t... indexes>
+    static JSValue Invoke(const JSContext& js_context, F&& function, const JSArguments& arguments, index_sequence<indexes...>) {
+      // Check the arguments in order so that the first bad one is the
+      // one reported.
+      const bool checked[] = { true, CheckArgument<Args>(arguments, indexes)... };
+      static_cast<void>(checked);
+      return JSNativeResult<R>::Invoke(js_context, std::forward<F>(function), JSConverter<JSNativeType<Args>>::FromJS(arguments[indexes])...);
+    }
+
+    template<typename T>
+    static bool CheckArgument(const JSArguments& arguments, std::size_t index) {
+      static_assert(!std::is_lvalue_reference<T>::value || std::is_const<typename std::remove_reference<T>::type>::value,
+                    "native arguments must be taken by value or by const reference");
+      if (!JSConverter<JSNativeType<T>>::IsConvertible(arguments[index])) {
+        ThrowInvalidArgument("JSNativeFunction", "argument " + std::to_string(index) + " is not " + JSConverter<JSNativeType<T>>::GetTypeName());
+      }
+      return true;
+    }
+  };
+
+  // Call a native function pointer with the arguments of a JavaScript
+  // function call.
+  template<typename R, typename... Args>
+  inline JSValue InvokeJSNativeFunction(const JSContext& js_context, R (*function)(Args...), const JSArguments& arguments) {
+    return JSNativeSignature<R, Args...>::Invoke(js_context, function, arguments);
+  }
+
+}} // namespace HAL { namespace detail {
+
+#endif // _HAL_DETAIL_JSNATIVEFUNCTION_HPP_
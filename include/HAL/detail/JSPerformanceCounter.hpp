@@ -49,6 +49,26 @@ namespace HAL { namespace detail {
       return objects_move_assigned_;
     }
     
+    // The number of times a JavaScriptCore ref was retained (or
+    // protected) on behalf of an object of type T.
+    static long get_refs_retained() {
+      return refs_retained_;
+    }
+    
+    // The number of times a JavaScriptCore ref was released (or
+    // unprotected) on behalf of an object of type T.
+    static long get_refs_released() {
+      return refs_released_;
+    }
+    
+    static void ref_retained() {
+      ++refs_retained_;
+    }
+    
+    static void ref_released() {
+      ++refs_released_;
+    }
+    
     JSPerformanceCounter() {
       ++objects_alive_;
       ++objects_created_;
@@ -69,7 +89,7 @@ namespace HAL { namespace detail {
     }
     
     // copy assignment operator
-    JSPerformanceCounter& operator=(const JSPerformanceCounter&& rhs) {
+    JSPerformanceCounter& operator=(const JSPerformanceCounter& rhs) {
       ++objects_copy_assigned_;
       return *this;
     }
@@ -98,6 +118,8 @@ namespace HAL { namespace detail {
     static std::atomic<long> objects_move_constructed_;
     static std::atomic<long> objects_copy_assigned_;
     static std::atomic<long> objects_move_assigned_;
+    static std::atomic<long> refs_retained_;
+    static std::atomic<long> refs_released_;
   };
   
   template<typename T>
@@ -121,14 +143,24 @@ namespace HAL { namespace detail {
   template<typename T>
   std::atomic<long> JSPerformanceCounter<T>::objects_move_assigned_;
   
+  template<typename T>
+  std::atomic<long> JSPerformanceCounter<T>::refs_retained_;
+  
+  template<typename T>
+  std::atomic<long> JSPerformanceCounter<T>::refs_released_;
+  
   
 }} // namespace HAL { namespace detail {
 
 #define HAL_PERFORMANCE_COUNTER1(class_name) : public detail::JSPerformanceCounter<class_name>
 #define HAL_PERFORMANCE_COUNTER2(class_name) , public detail::JSPerformanceCounter<class_name>
+#define HAL_PERFORMANCE_COUNTER_RETAIN(class_name)  detail::JSPerformanceCounter<class_name>::ref_retained()
+#define HAL_PERFORMANCE_COUNTER_RELEASE(class_name) detail::JSPerformanceCounter<class_name>::ref_released()
 #else
 #define HAL_PERFORMANCE_COUNTER1(class_name)
 #define HAL_PERFORMANCE_COUNTER2(class_name)
+#define HAL_PERFORMANCE_COUNTER_RETAIN(class_name)
+#define HAL_PERFORMANCE_COUNTER_RELEASE(class_name)
 #endif // HAL_PERFORMANCE_COUNTER_ENABLE
 
 #endif // _HAL_DETAIL_JSPERFORMANCECOUNTER_HPP_
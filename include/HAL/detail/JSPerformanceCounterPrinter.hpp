@@ -37,6 +37,8 @@ namespace HAL { namespace detail {
       std::clog << "JSContextGroup:            objects_move_constructed = " << JSPerformanceCounter<JSContextGroup>::get_objects_move_constructed() << std::endl;
       std::clog << "JSContextGroup:            objects_copy_assigned    = " << JSPerformanceCounter<JSContextGroup>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSContextGroup:            objects_move_assigned    = " << JSPerformanceCounter<JSContextGroup>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSContextGroup:            refs_retained            = " << JSPerformanceCounter<JSContextGroup>::get_refs_retained()            << std::endl;
+      std::clog << "JSContextGroup:            refs_released            = " << JSPerformanceCounter<JSContextGroup>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSContext:                 objects_alive            = " << JSPerformanceCounter<JSContext>::get_objects_alive()            << std::endl;
@@ -46,6 +48,8 @@ namespace HAL { namespace detail {
       std::clog << "JSContext:                 objects_move_constructed = " << JSPerformanceCounter<JSContext>::get_objects_move_constructed() << std::endl;
       std::clog << "JSContext:                 objects_copy_assigned    = " << JSPerformanceCounter<JSContext>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSContext:                 objects_move_assigned    = " << JSPerformanceCounter<JSContext>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSContext:                 refs_retained            = " << JSPerformanceCounter<JSContext>::get_refs_retained()            << std::endl;
+      std::clog << "JSContext:                 refs_released            = " << JSPerformanceCounter<JSContext>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSString:                  objects_alive            = " << JSPerformanceCounter<JSString>::get_objects_alive()            << std::endl;
@@ -55,6 +59,8 @@ namespace HAL { namespace detail {
       std::clog << "JSString:                  objects_move_constructed = " << JSPerformanceCounter<JSString>::get_objects_move_constructed() << std::endl;
       std::clog << "JSString:                  objects_copy_assigned    = " << JSPerformanceCounter<JSString>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSString:                  objects_move_assigned    = " << JSPerformanceCounter<JSString>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSString:                  refs_retained            = " << JSPerformanceCounter<JSString>::get_refs_retained()            << std::endl;
+      std::clog << "JSString:                  refs_released            = " << JSPerformanceCounter<JSString>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSValue:                   objects_alive            = " << JSPerformanceCounter<JSValue>::get_objects_alive()            << std::endl;
@@ -64,6 +70,8 @@ namespace HAL { namespace detail {
       std::clog << "JSValue:                   objects_move_constructed = " << JSPerformanceCounter<JSValue>::get_objects_move_constructed() << std::endl;
       std::clog << "JSValue:                   objects_copy_assigned    = " << JSPerformanceCounter<JSValue>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSValue:                   objects_move_assigned    = " << JSPerformanceCounter<JSValue>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSValue:                   refs_retained            = " << JSPerformanceCounter<JSValue>::get_refs_retained()            << std::endl;
+      std::clog << "JSValue:                   refs_released            = " << JSPerformanceCounter<JSValue>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSUndefined:               objects_alive            = " << JSPerformanceCounter<JSUndefined>::get_objects_alive()            << std::endl;
@@ -110,6 +118,8 @@ namespace HAL { namespace detail {
       std::clog << "JSObject:                  objects_move_constructed = " << JSPerformanceCounter<JSObject>::get_objects_move_constructed() << std::endl;
       std::clog << "JSObject:                  objects_copy_assigned    = " << JSPerformanceCounter<JSObject>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSObject:                  objects_move_assigned    = " << JSPerformanceCounter<JSObject>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSObject:                  refs_retained            = " << JSPerformanceCounter<JSObject>::get_refs_retained()            << std::endl;
+      std::clog << "JSObject:                  refs_released            = " << JSPerformanceCounter<JSObject>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSArray:                   objects_alive            = " << JSPerformanceCounter<JSArray>::get_objects_alive()            << std::endl;
@@ -164,6 +174,8 @@ namespace HAL { namespace detail {
       std::clog << "JSClass:                   objects_move_constructed = " << JSPerformanceCounter<JSClass>::get_objects_move_constructed() << std::endl;
       std::clog << "JSClass:                   objects_copy_assigned    = " << JSPerformanceCounter<JSClass>::get_objects_copy_assigned()    << std::endl;
       std::clog << "JSClass:                   objects_move_assigned    = " << JSPerformanceCounter<JSClass>::get_objects_move_assigned()    << std::endl;
+      std::clog << "JSClass:                   refs_retained            = " << JSPerformanceCounter<JSClass>::get_refs_retained()            << std::endl;
+      std::clog << "JSClass:                   refs_released            = " << JSPerformanceCounter<JSClass>::get_refs_released()            << std::endl;
       
       std::clog << std::endl;
       std::clog << "JSPropertyNameAccumulator: objects_alive            = " << JSPerformanceCounter<JSPropertyNameAccumulator>::get_objects_alive()            << std::endl;
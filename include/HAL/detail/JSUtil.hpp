@@ -15,8 +15,10 @@
 #include "HAL/JSValue.hpp"
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 #include <unordered_set>
 
@@ -35,33 +37,61 @@ namespace HAL { namespace detail {
     return std::unique_ptr<T>(new T(std::forward<Ts>(params)...));
   }
 
-  class js_runtime_error : public std::runtime_error {
-  public:
-    js_runtime_error() HAL_NOEXCEPT = default;
-    js_runtime_error(const JSError& js_error);
-    virtual ~js_runtime_error() = default;
+  // C++11 stand-ins for std::index_sequence and
+  // std::make_index_sequence from C++14.
+  template<std::size_t... indexes>
+  struct index_sequence {
+  };
+
+  template<std::size_t N, std::size_t... indexes>
+  struct make_index_sequence : make_index_sequence<N - 1, N - 1, indexes...> {
+  };
 
-    std::string js_name() const {
-      return js_name__;
-    }
-    std::string js_message() const {
-      return js_message__;
-    }
-    std::string js_filename() const {
-      return js_filename__;
-    }
-    std::uint32_t js_linenumber() const {
-      return js_linenumber__;
-    }
-    std::vector<JSValue> js_stack() const {
-      return js_stack__;
-    }
+  template<std::size_t... indexes>
+  struct make_index_sequence<0, indexes...> : index_sequence<indexes...> {
+  };
+
+  /*!
+   @class
+   
+   @discussion A js_runtime_error is the std::runtime_error thrown
+   when JavaScript throws an Error. It reads the Error's message, which
+   what() returns, when it is created, so that what() never calls into
+   JavaScriptCore. It holds on to the Error itself and reads each of
+   its other properties only the first time it is asked for, so
+   throwing one through a deep call chain costs a single property read
+   more than throwing the JSValue.
+   
+   Copies of a js_runtime_error share the properties read so far.
+   */
+  class HAL_EXPORT js_runtime_error : public std::runtime_error {
+  public:
+    js_runtime_error(const JSError& js_error, const std::string& source_url = "", int line_number = 0);
+    virtual ~js_runtime_error() HAL_NOEXCEPT = default;
+    
+    // The Error that was thrown.
+    JSValue js_error() const HAL_NOEXCEPT;
+    
+    std::string js_name() const;
+    std::string js_message() const;
+    
+    // The Error's fileName and lineNumber properties, or else the
+    // source URL and line number of the script that threw it.
+    std::string js_filename() const;
+    std::uint32_t js_linenumber() const;
+    
+    std::vector<JSValue> js_stack() const;
+    
   private:
-    std::string js_name__;
-    std::string js_message__;
-    std::string js_filename__;
-    std::uint32_t js_linenumber__;
-    std::vector<JSValue> js_stack__;
+    
+    struct Fields;
+    
+    // Silence 4251 on Windows since private member variables do not
+    // need to be exported from a DLL.
+#pragma warning(push)
+#pragma warning(disable: 4251)
+    std::shared_ptr<Fields> fields__;
+#pragma warning(pop)
   };
 
   HAL_EXPORT void    ThrowRuntimeError(const std::string& internal_component_name, const std::string& message);
@@ -0,0 +1,45 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#ifndef _HAL_DETAIL_UTFUTILITIES_HPP_
+#define _HAL_DETAIL_UTFUTILITIES_HPP_
+
+#include "HAL/detail/JSBase.hpp"
+
+#include <cstddef>
+
+namespace HAL { namespace detail {
+
+  // Conversions between UTF-8 and the UTF-16 used by JavaScriptCore.
+  //
+  // Runs of ASCII characters, which dominate most real-world strings,
+  // are converted 16 bytes at a time with SSE2 or NEON when available.
+  // Everything else goes through a scalar converter that rejects
+  // malformed input (overlong encodings, surrogate code points in
+  // UTF-8, unpaired surrogates in UTF-16, etc.) instead of guessing, so
+  // that callers can fall back to JavaScriptCore's own conversion and
+  // preserve its behavior for such input.
+
+  // Convert length bytes of UTF-8 to UTF-16. The output buffer must
+  // have room for length code units, which is always enough. Return
+  // false if the input is not valid UTF-8, otherwise store the number
+  // of code units written in utf16_length.
+  HAL_EXPORT bool UTF8ToUTF16(const char* utf8, std::size_t length, JSChar* utf16, std::size_t& utf16_length) HAL_NOEXCEPT;
+
+  // Return false if the UTF-16 input contains an unpaired surrogate,
+  // otherwise store the exact number of bytes of its UTF-8 encoding in
+  // utf8_length.
+  HAL_EXPORT bool GetUTF8Length(const JSChar* utf16, std::size_t length, std::size_t& utf8_length) HAL_NOEXCEPT;
+
+  // Convert valid UTF-16 to UTF-8. The output buffer must have room for
+  // the number of bytes computed by GetUTF8Length.
+  HAL_EXPORT void UTF16ToUTF8(const JSChar* utf16, std::size_t length, char* utf8) HAL_NOEXCEPT;
+
+}} // namespace HAL { namespace detail {
+
+#endif // _HAL_DETAIL_UTFUTILITIES_HPP_
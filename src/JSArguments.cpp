@@ -0,0 +1,75 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSArguments.hpp"
+
+#include "HAL/JSContext.hpp"
+#include "HAL/JSString.hpp"
+
+#include "HAL/detail/JSUtil.hpp"
+
+#include <cassert>
+
+namespace HAL {
+
+  JSArguments::JSArguments(JSContextRef js_context_ref, std::size_t argument_count, const JSValueRef arguments_array[]) HAL_NOEXCEPT
+  : js_context_ref__(js_context_ref)
+  , argument_count__(argument_count)
+  , arguments_array__(arguments_array) {
+    // preconditions
+    assert(js_context_ref__);
+    assert(argument_count__ == 0 || arguments_array__);
+  }
+
+  JSLocal JSArguments::operator[](std::size_t index) const HAL_NOEXCEPT {
+    // precondition
+    assert(index < argument_count__);
+    return JSLocal(js_context_ref__, arguments_array__[index]);
+  }
+
+  JSLocal JSArguments::at(std::size_t index) const {
+    if (index >= argument_count__) {
+      detail::ThrowInvalidArgument("JSArguments", "Index " + std::to_string(index) + " is out of range for " + std::to_string(argument_count__) + " arguments");
+    }
+
+    return operator[](index);
+  }
+
+  bool JSArguments::Has(std::size_t index) const HAL_NOEXCEPT {
+    return index < argument_count__ && !JSValueIsUndefined(js_context_ref__, arguments_array__[index]);
+  }
+
+  bool JSArguments::GetBoolean(std::size_t index, bool default_value) const HAL_NOEXCEPT {
+    return Has(index) ? static_cast<bool>(operator[](index)) : default_value;
+  }
+
+  double JSArguments::GetNumber(std::size_t index, double default_value) const {
+    return Has(index) ? static_cast<double>(operator[](index)) : default_value;
+  }
+
+  int32_t JSArguments::GetInt32(std::size_t index, int32_t default_value) const {
+    return Has(index) ? static_cast<int32_t>(operator[](index)) : default_value;
+  }
+
+  uint32_t JSArguments::GetUInt32(std::size_t index, uint32_t default_value) const {
+    return Has(index) ? static_cast<uint32_t>(operator[](index)) : default_value;
+  }
+
+  std::string JSArguments::GetString(std::size_t index, const std::string& default_value) const {
+    return Has(index) ? static_cast<std::string>(operator[](index)) : default_value;
+  }
+
+  std::vector<JSValue> JSArguments::ToVector() const {
+    return detail::to_vector(get_context(), argument_count__, arguments_array__);
+  }
+
+  JSContext JSArguments::get_context() const HAL_NOEXCEPT {
+    return JSContext(js_context_ref__);
+  }
+
+} // namespace HAL {
@@ -46,10 +46,11 @@ JSObjectRef JSArray::MakeArray(const JSContext& js_context, const std::vector<JS
 }
 
 uint32_t JSArray::GetLength() const HAL_NOEXCEPT {
-	if (!HasProperty("length")) {
+	static const auto& length_property_name = JSString::Intern("length");
+	if (!HasProperty(length_property_name)) {
 		return 0;
 	}
-	const auto length = GetProperty("length");
+	const auto length = GetProperty(length_property_name);
 	if (!length.IsNumber()) {
 		return 0;
 	}
@@ -20,6 +20,7 @@ namespace HAL {
   , js_class_ref__(JSClassCreate(&kJSClassDefinitionEmpty)) {
     HAL_LOG_TRACE("JSClass:: ctor ", this);
     HAL_LOG_TRACE("JSClass:: retain ", js_class_ref__, " (implicit) for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSClass);
   }
   
   JSClass::JSClass(const JSClassDefinition& js_class_definition) HAL_NOEXCEPT
@@ -27,12 +28,17 @@ namespace HAL {
   , js_class_ref__(JSClassCreate(&js_class_definition.js_class_definition__)) {
     HAL_LOG_TRACE("JSClass:: ctor ", this);
     HAL_LOG_TRACE("JSClass:: retain ", js_class_ref__, " for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSClass);
   }
   
   JSClass::~JSClass() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSClass:: dtor ", this);
-    HAL_LOG_TRACE("JSClass:: release ", js_class_ref__, " for ", this);
-    JSClassRelease(js_class_ref__);
+    // A moved-from JSClass no longer owns a JSClassRef.
+    if (js_class_ref__) {
+      HAL_LOG_TRACE("JSClass:: release ", js_class_ref__, " for ", this);
+      JSClassRelease(js_class_ref__);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSClass);
+    }
   }
   
   JSClass::JSClass(const JSClass& rhs) HAL_NOEXCEPT
@@ -41,14 +47,15 @@ namespace HAL {
     HAL_LOG_TRACE("JSClass:: copy ctor ", this);
     HAL_LOG_TRACE("JSClass:: retain ", js_class_ref__, " for ", this);
     JSClassRetain(js_class_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSClass);
   }
   
   JSClass::JSClass(JSClass&& rhs) HAL_NOEXCEPT
   : name__(std::move(rhs.name__))
   , js_class_ref__(rhs.js_class_ref__) {
     HAL_LOG_TRACE("JSClass:: move ctor ", this);
-    HAL_LOG_TRACE("JSClass:: retain ", js_class_ref__, " for ", this);
-    JSClassRetain(js_class_ref__);
+    // Take ownership of rhs's JSClassRef instead of retaining it.
+    rhs.js_class_ref__ = nullptr;
   }
   
   JSClass& JSClass::operator=(JSClass rhs) HAL_NOEXCEPT {
@@ -18,6 +18,7 @@
 #include "HAL/JSNumber.hpp"
 
 #include "HAL/JSObject.hpp"
+#include "HAL/JSExpected.hpp"
 #include "HAL/JSArray.hpp"
 #include "HAL/JSDate.hpp"
 #include "HAL/JSError.hpp"
@@ -27,27 +28,29 @@
 #include "HAL/detail/JSUtil.hpp"
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 
 namespace HAL {
   
   JSObject JSContext::get_global_object() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSObject(JSContext(js_global_context_ref__), JSContextGetGlobalObject(js_global_context_ref__));
+    return JSObject(*this, JSContextGetGlobalObject(get_global_context_ref()));
   }
   
   JSValue JSContext::CreateValueFromJSON(const JSString& js_string) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSValue(JSContext(js_global_context_ref__), js_string, true);
+    return JSValue(*this, js_string, true);
   }
   
   JSValue JSContext::CreateString() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSValue(JSContext(js_global_context_ref__), JSString(), false);
+    return JSValue(*this, JSString(), false);
   }
   
   JSValue JSContext::CreateString(const JSString& js_string) const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSValue(JSContext(js_global_context_ref__), js_string, false);
+    return JSValue(*this, js_string, false);
   }
   
   JSValue JSContext::CreateString(const char* string) const HAL_NOEXCEPT {
@@ -59,41 +62,56 @@ namespace HAL {
   }
   
   JSUndefined JSContext::CreateUndefined() const HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
-    return JSUndefined(JSContext(js_global_context_ref__));
+    return JSUndefined(*this, js_context_lifetime__ -> GetUndefined());
   }
   
   JSNull JSContext::CreateNull() const HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
-    return JSNull(JSContext(js_global_context_ref__));
+    return JSNull(*this, js_context_lifetime__ -> GetNull());
   }
 	
   JSValue JSContext::CreateNativeNull() const HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
     // Use JSNull to represent native nullptr
-    auto value = JSNull(JSContext(js_global_context_ref__));
+    JSValue value = CreateNull();
     value.MarkAsNativeNull();
     return value;
   }
 	
   JSBoolean JSContext::CreateBoolean(bool boolean) const HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
-    return JSBoolean(JSContext(js_global_context_ref__), boolean);
+    return JSBoolean(*this, js_context_lifetime__ -> GetBoolean(boolean));
   }
   
   JSNumber JSContext::CreateNumber(double number) const HAL_NOEXCEPT {
+    // Only integers that survive the round trip through double, which
+    // excludes NaN, are cached, but not -0.
+    if (number >= HAL_JSNUMBER_CACHE_MIN && number <= HAL_JSNUMBER_CACHE_MAX) {
+      const auto integer = static_cast<std::int64_t>(number);
+      if (static_cast<double>(integer) == number && !(integer == 0 && std::signbit(number))) {
+        return CreateNumber(static_cast<int32_t>(integer));
+      }
+    }
+    
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSNumber(JSContext(js_global_context_ref__), number);
+    return JSNumber(*this, number);
   }
   
   JSNumber JSContext::CreateNumber(int32_t number) const HAL_NOEXCEPT {
+    const JSValueRef cached_js_value_ref = js_context_lifetime__ -> GetSmallInteger(number);
+    if (cached_js_value_ref) {
+      return JSNumber(*this, cached_js_value_ref);
+    }
+    
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSNumber(JSContext(js_global_context_ref__), number);
+    return JSNumber(*this, number);
   }
   
   JSNumber JSContext::CreateNumber(uint32_t number) const HAL_NOEXCEPT {
+    const JSValueRef cached_js_value_ref = js_context_lifetime__ -> GetSmallInteger(number);
+    if (cached_js_value_ref) {
+      return JSNumber(*this, cached_js_value_ref);
+    }
+    
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSNumber(JSContext(js_global_context_ref__), number);
+    return JSNumber(*this, number);
   }
   
   JSObject JSContext::CreateObject() const HAL_NOEXCEPT {
@@ -102,7 +120,7 @@ namespace HAL {
   
   JSObject JSContext::CreateObject(const JSClass& js_class) const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSObject(JSContext(js_global_context_ref__), js_class);
+    return JSObject(*this, js_class);
   }
 
   JSObject JSContext::CreateObject(const std::unordered_map<std::string, JSValue>& properties) const HAL_NOEXCEPT {
@@ -121,42 +139,42 @@ namespace HAL {
   
   JSArray JSContext::CreateArray() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSArray(JSContext(js_global_context_ref__));
+    return JSArray(*this);
   }
   
   JSArray JSContext::CreateArray(const std::vector<JSValue>& arguments) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSArray(JSContext(js_global_context_ref__), arguments);
+    return JSArray(*this, arguments);
   }
   
   JSDate JSContext::CreateDate() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSDate(JSContext(js_global_context_ref__));
+    return JSDate(*this);
   }
   
   JSDate JSContext::CreateDate(const std::vector<JSValue>& arguments) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSDate(JSContext(js_global_context_ref__), arguments);
+    return JSDate(*this, arguments);
   }
   
   JSError JSContext::CreateError() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSError(JSContext(js_global_context_ref__));
+    return JSError(*this);
   }
   
   JSError JSContext::CreateError(const std::vector<JSValue>& arguments) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSError(JSContext(js_global_context_ref__), arguments);
+    return JSError(*this, arguments);
   }
   
   JSRegExp JSContext::CreateRegExp() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSRegExp(JSContext(js_global_context_ref__));
+    return JSRegExp(*this);
   }
   
   JSRegExp JSContext::CreateRegExp(const std::vector<JSValue>& arguments) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSRegExp(JSContext(js_global_context_ref__), arguments);
+    return JSRegExp(*this, arguments);
   }
   
   JSFunction JSContext::CreateFunction(const JSString& body) const {
@@ -173,11 +191,11 @@ namespace HAL {
   
   JSFunction JSContext::CreateFunction(const JSString& body, const std::vector<JSString>& parameter_names, const JSString& function_name, const JSString& source_url, int starting_line_number) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSFunction(JSContext(js_global_context_ref__), body, parameter_names, function_name, source_url, starting_line_number);
+    return JSFunction(*this, body, parameter_names, function_name, source_url, starting_line_number);
   }
 
   JSFunction JSContext::CreateFunction() const {
-    JSFunctionCallback noop = [](const std::vector<JSValue>, JSObject& this_object){ return this_object.get_context().CreateUndefined(); };
+    JSFunctionArgumentsCallback noop = [](const JSArguments&, JSObject& this_object){ return this_object.get_context().CreateUndefined(); };
     return CreateFunction(noop);
   }
 
@@ -187,16 +205,26 @@ namespace HAL {
 
   JSFunction JSContext::CreateFunction(const JSString& function_name, JSFunctionCallback& callback) const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    return JSFunction(JSContext(js_global_context_ref__), function_name, callback);
+    return JSFunction(*this, function_name, callback);
+  }
+
+  JSFunction JSContext::CreateFunction(const JSFunctionArgumentsCallback& callback) const {
+    return CreateFunction(JSString(), callback);
+  }
+
+  JSFunction JSContext::CreateFunction(const JSString& function_name, const JSFunctionArgumentsCallback& callback) const {
+    HAL_JSCONTEXT_LOCK_GUARD;
+    return JSFunction(*this, function_name, callback);
   }
   
   JSValue JSContext::JSEvaluateScript(const JSString& script) const {
-    return JSEvaluateScript(script, get_global_object(), JSString());
+    return JSEvaluateScript(script, JSString());
   }
   
   JSValue JSContext::JSEvaluateScript(const JSString& script, const JSString& source_url, int starting_line_number) const {
-    HAL_JSCONTEXT_LOCK_GUARD;
-    return JSEvaluateScript(script, get_global_object(), source_url, starting_line_number);
+    // A null this object evaluates the script with the global object
+    // as "this", without wrapping the global object in a JSObject.
+    return JSEvaluateScript(script, static_cast<JSObjectRef>(nullptr), source_url, starting_line_number);
   }
   
   JSValue JSContext::JSEvaluateScript(const JSString& script, JSObject this_object) const {
@@ -204,20 +232,49 @@ namespace HAL {
   }
   
   JSValue JSContext::JSEvaluateScript(const JSString& script, JSObject this_object, const JSString& source_url, int starting_line_number) const {
+    return JSEvaluateScript(script, static_cast<JSObjectRef>(this_object), source_url, starting_line_number);
+  }
+  
+  JSValue JSContext::JSEvaluateScript(const JSString& script, JSObjectRef this_object_ref, const JSString& source_url, int starting_line_number) const {
+    auto result = TryJSEvaluateScript(script, this_object_ref, source_url, starting_line_number);
+    if (!result) {
+      detail::ThrowRuntimeError("JSContext", result.error().get_value(), source_url, starting_line_number);
+    }
+    
+    return *result;
+  }
+  
+  JSExpected<JSValue> JSContext::TryJSEvaluateScript(const JSString& script) const {
+    return TryJSEvaluateScript(script, JSString());
+  }
+  
+  JSExpected<JSValue> JSContext::TryJSEvaluateScript(const JSString& script, const JSString& source_url, int starting_line_number) const {
+    return TryJSEvaluateScript(script, static_cast<JSObjectRef>(nullptr), source_url, starting_line_number);
+  }
+  
+  JSExpected<JSValue> JSContext::TryJSEvaluateScript(const JSString& script, JSObject this_object) const {
+    return TryJSEvaluateScript(script, this_object, JSString());
+  }
+  
+  JSExpected<JSValue> JSContext::TryJSEvaluateScript(const JSString& script, JSObject this_object, const JSString& source_url, int starting_line_number) const {
+    return TryJSEvaluateScript(script, static_cast<JSObjectRef>(this_object), source_url, starting_line_number);
+  }
+  
+  JSExpected<JSValue> JSContext::TryJSEvaluateScript(const JSString& script, JSObjectRef this_object_ref, const JSString& source_url, int starting_line_number) const {
     HAL_JSCONTEXT_LOCK_GUARD;
     JSValueRef js_value_ref { nullptr };
     const JSStringRef source_url_ref = (source_url.length() > 0) ? static_cast<JSStringRef>(source_url) : nullptr;
     JSValueRef exception { nullptr };
-    js_value_ref = ::JSEvaluateScript(js_global_context_ref__, static_cast<JSStringRef>(script), static_cast<JSObjectRef>(this_object), source_url_ref, starting_line_number, &exception);
+    js_value_ref = ::JSEvaluateScript(get_global_context_ref(), static_cast<JSStringRef>(script), this_object_ref, source_url_ref, starting_line_number, &exception);
     
     if (exception) {
       // If this assert fails then we need to JSValueUnprotect
       // js_value_ref.
       assert(!js_value_ref);
-      detail::ThrowRuntimeError("JSContext", JSValue(JSContext(js_global_context_ref__), exception), source_url, starting_line_number);
+      return JSException(JSValue(*this, exception));
     }
     
-    return JSValue(JSContext(js_global_context_ref__), js_value_ref);
+    return JSValue(*this, js_value_ref);
   }
   
   bool JSContext::JSCheckScriptSyntax(const JSString& script) const HAL_NOEXCEPT {
@@ -228,10 +285,10 @@ namespace HAL {
     HAL_JSCONTEXT_LOCK_GUARD;
     const JSStringRef source_url_ref = (source_url.length() > 0) ? static_cast<JSStringRef>(source_url) : nullptr;
     JSValueRef exception { nullptr };
-    bool result = ::JSCheckScriptSyntax(js_global_context_ref__, static_cast<JSStringRef>(script), source_url_ref, starting_line_number, &exception);
+    bool result = ::JSCheckScriptSyntax(get_global_context_ref(), static_cast<JSStringRef>(script), source_url_ref, starting_line_number, &exception);
     
     if (exception) {
-      detail::ThrowRuntimeError("JSContext", JSValue(JSContext(js_global_context_ref__), exception));
+      detail::ThrowRuntimeError("JSContext", JSValue(*this, exception));
     }
     
     return result;
@@ -239,7 +296,7 @@ namespace HAL {
   
   void JSContext::GarbageCollect() const HAL_NOEXCEPT {
     HAL_JSCONTEXT_LOCK_GUARD;
-    JSGarbageCollect(js_global_context_ref__);
+    JSGarbageCollect(get_global_context_ref());
   }
   
 #ifdef DEBUG
@@ -248,60 +305,61 @@ namespace HAL {
   
   void JSContext::SynchronousGarbageCollectForDebugging() const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    JSSynchronousGarbageCollectForDebugging(js_global_context_ref__);
+    JSSynchronousGarbageCollectForDebugging(get_global_context_ref());
   }
 
   void JSContext::SynchronousEdenCollectForDebugging() const {
     HAL_JSCONTEXT_LOCK_GUARD;
-    JSSynchronousEdenCollectForDebugging(js_global_context_ref__);
+    JSSynchronousEdenCollectForDebugging(get_global_context_ref());
   }
 #endif
   
   JSContext::~JSContext() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSContext:: dtor ", this);
-    HAL_LOG_TRACE("JSContext:: release ", js_global_context_ref__, " for ", this);
-    JSGlobalContextRelease(js_global_context_ref__);
+    // A moved-from JSContext no longer refers to a JSContextLifetime.
+    if (js_context_lifetime__) {
+      js_context_lifetime__ -> Release();
+    }
   }
   
   JSContext::JSContext(const JSContext& rhs) HAL_NOEXCEPT
-  : js_context_group__(rhs.js_context_group__)
-  , js_global_context_ref__(rhs.js_global_context_ref__) {
+  : js_context_lifetime__(rhs.js_context_lifetime__) {
     HAL_LOG_TRACE("JSContext:: copy ctor ", this);
-    HAL_LOG_TRACE("JSContext:: retain ", js_global_context_ref__, " for ", this);
-    JSGlobalContextRetain(js_global_context_ref__);
+    if (js_context_lifetime__) {
+      js_context_lifetime__ -> Retain();
+    }
   }
   
   JSContext::JSContext(JSContext&& rhs) HAL_NOEXCEPT
-  : js_context_group__(std::move(rhs.js_context_group__))
-  , js_global_context_ref__(rhs.js_global_context_ref__) {
+  : js_context_lifetime__(rhs.js_context_lifetime__) {
     HAL_LOG_TRACE("JSContext:: move ctor ", this);
-    HAL_LOG_TRACE("JSContext:: retain ", js_global_context_ref__, " for ", this);
-    JSGlobalContextRetain(js_global_context_ref__);
+    rhs.js_context_lifetime__ = nullptr;
   }
   
+  // Assignment and swap only exchange JSContextLifetime pointers, so
+  // unlike the other member functions they don't lock the context.
   JSContext& JSContext::operator=(JSContext rhs) HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
     HAL_LOG_TRACE("JSContext:: assignment ", this);
     swap(rhs);
     return *this;
   }
   
   void JSContext::swap(JSContext& other) HAL_NOEXCEPT {
-    HAL_JSCONTEXT_LOCK_GUARD;
     HAL_LOG_TRACE("JSContext:: swap ", this);
     using std::swap;
     
     // By swapping the members of two classes, the two classes are
     // effectively swapped.
-    swap(js_context_group__     , other.js_context_group__);
-    swap(js_global_context_ref__, other.js_global_context_ref__);
+    swap(js_context_lifetime__, other.js_context_lifetime__);
   }
   
-  JSContext::JSContext(const JSContextGroup& js_context_group, const JSClass& global_object_class) HAL_NOEXCEPT
-  : js_context_group__(js_context_group)
-  , js_global_context_ref__(JSGlobalContextCreateInGroup(static_cast<JSContextGroupRef>(js_context_group), static_cast<JSClassRef>(global_object_class))) {
+  JSContext::JSContext(const JSContextGroup& js_context_group, const JSClass& global_object_class) HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSContext:: ctor 1 ", this);
-    HAL_LOG_TRACE("JSContext:: retain ", js_global_context_ref__, " (implicit) for ", this);
+    JSGlobalContextRef js_global_context_ref = JSGlobalContextCreateInGroup(static_cast<JSContextGroupRef>(js_context_group), static_cast<JSClassRef>(global_object_class));
+    js_context_lifetime__ = detail::JSContextLifetime::Acquire(js_global_context_ref);
+    
+    // The JSContextLifetime made its own retain.
+    JSGlobalContextRelease(js_global_context_ref);
   }
   
   JSContext::JSContext(JSContextRef js_context_ref) HAL_NOEXCEPT
@@ -310,12 +368,8 @@ namespace HAL {
   
   // For interoperability with the JavaScriptCore C API.
   JSContext::JSContext(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT
-  : js_context_group__(JSContextGetGroup(js_global_context_ref))
-  , js_global_context_ref__(js_global_context_ref) {
+  : js_context_lifetime__(detail::JSContextLifetime::Acquire(js_global_context_ref)) {
     HAL_LOG_TRACE("JSContext:: ctor 2 ", this);
-    assert(js_global_context_ref__);
-    HAL_LOG_TRACE("JSContext:: retain ", js_global_context_ref__, " for ", this);
-    JSGlobalContextRetain(js_global_context_ref__);
   }
   
 } // namespace HAL {
@@ -9,6 +9,7 @@
 #include "HAL/JSContextGroup.hpp"
 #include "HAL/JSContext.hpp"
 #include "HAL/JSClass.hpp"
+#include "HAL/JSFunction.hpp"
 
 #include <cassert>
 
@@ -18,6 +19,7 @@ namespace HAL {
   : js_context_group_ref__(JSContextGroupCreate()) {
     HAL_LOG_TRACE("JSContextGroup:: ctor 1 ", this);
     HAL_LOG_TRACE("JSContextGroup:: retain ", js_context_group_ref__, " (implicit) for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSContextGroup);
   }
   
   JSContext JSContextGroup::CreateContext() const HAL_NOEXCEPT {
@@ -34,14 +36,21 @@ namespace HAL {
     assert(js_context_group_ref__);
     HAL_LOG_TRACE("JSContextGroup:: retain ", js_context_group_ref__, " for ", this);
     JSContextGroupRetain(js_context_group_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSContextGroup);
     managed__ = true;
   }
   
   JSContextGroup::~JSContextGroup() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSContextGroup:: dtor ", this);
-    HAL_LOG_TRACE("JSContextGroup:: release ", js_context_group_ref__, " for ", this);
-    if (managed__) {
+    // A moved-from JSContextGroup no longer owns a JSContextGroupRef.
+    if (managed__ && js_context_group_ref__) {
+      HAL_LOG_TRACE("JSContextGroup:: release ", js_context_group_ref__, " for ", this);
       JSContextGroupRelease(js_context_group_ref__);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSContextGroup);
+      
+      // Releasing the last reference to the group finalizes its
+      // objects, including native functions.
+      JSFunction::DestroyFinalizedCallbacks();
     }
   }
   
@@ -50,15 +59,18 @@ namespace HAL {
     HAL_LOG_TRACE("JSContextGroup:: copy ctor ", this);
     HAL_LOG_TRACE("JSContextGroup:: retain ", js_context_group_ref__, " for ", this);
     JSContextGroupRetain(js_context_group_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSContextGroup);
     managed__ = true;
   }
   
   JSContextGroup::JSContextGroup(JSContextGroup&& rhs) HAL_NOEXCEPT
-  : js_context_group_ref__(rhs.js_context_group_ref__) {
+  : managed__(rhs.managed__)
+  , js_context_group_ref__(rhs.js_context_group_ref__) {
     HAL_LOG_TRACE("JSContextGroup:: move ctor ", this);
-    HAL_LOG_TRACE("JSContextGroup:: retain ", js_context_group_ref__, " for ", this);
-    JSContextGroupRetain(js_context_group_ref__);
-    managed__ = true;
+    // Take ownership of rhs's JSContextGroupRef instead of retaining
+    // it.
+    rhs.managed__              = false;
+    rhs.js_context_group_ref__ = nullptr;
   }
   
   JSContextGroup& JSContextGroup::operator=(JSContextGroup rhs) HAL_NOEXCEPT {
@@ -75,6 +87,7 @@ namespace HAL {
     
     // By swapping the members of two classes, the two classes are
     // effectively swapped.
+    swap(managed__             , other.managed__);
     swap(js_context_group_ref__, other.js_context_group_ref__);
   }
   
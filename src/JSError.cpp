@@ -28,36 +28,46 @@ JSError::JSError(const JSContext& js_context, JSObjectRef js_object_ref)
 }
 
 std::string JSError::message() const {
-	if (HasProperty("message")) {
-		return static_cast<std::string>(GetProperty("message"));
+	static const auto& message_property_name = JSString::Intern("message");
+	const auto js_value = GetProperty(message_property_name);
+	if (!js_value.IsUndefined() || HasProperty(message_property_name)) {
+		return static_cast<std::string>(js_value);
 	}
 	return "";
 }
 
 std::string JSError::name() const {
-	if (HasProperty("name")) {
-		return static_cast<std::string>(GetProperty("name"));
+	static const auto& name_property_name = JSString::Intern("name");
+	const auto js_value = GetProperty(name_property_name);
+	if (!js_value.IsUndefined() || HasProperty(name_property_name)) {
+		return static_cast<std::string>(js_value);
 	}
 	return "";
 }
 
 std::string JSError::filename() const {
-	if (HasProperty("fileName")) {
-		return static_cast<std::string>(GetProperty("fileName"));
+	static const auto& filename_property_name = JSString::Intern("fileName");
+	const auto js_value = GetProperty(filename_property_name);
+	if (!js_value.IsUndefined() || HasProperty(filename_property_name)) {
+		return static_cast<std::string>(js_value);
 	}
 	return "";
 }
 
 std::uint32_t JSError::linenumber() const {
-	if (HasProperty("lineNumber")) {
-		return static_cast<std::uint32_t>(GetProperty("lineNumber"));
+	static const auto& linenumber_property_name = JSString::Intern("lineNumber");
+	const auto js_value = GetProperty(linenumber_property_name);
+	if (!js_value.IsUndefined()) {
+		return static_cast<std::uint32_t>(js_value);
 	}
 	return 0;
 }
 
 std::vector<JSValue> JSError::stack() const {
-	if (HasProperty("native_stack") && GetProperty("native_stack").IsObject()) {
-		const auto js_stack = static_cast<JSObject>(GetProperty("native_stack"));
+	static const auto& native_stack_property_name = JSString::Intern("native_stack");
+	const auto js_value = GetProperty(native_stack_property_name);
+	if (js_value.IsObject()) {
+		const auto js_stack = static_cast<JSObject>(js_value);
 		if (js_stack.IsArray()) {
 			return static_cast<std::vector<JSValue>>(static_cast<JSArray>(js_stack));
 		}
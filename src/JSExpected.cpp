@@ -0,0 +1,18 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSExpected.hpp"
+#include "HAL/detail/JSUtil.hpp"
+
+namespace HAL {
+  
+  void JSException::Throw() const {
+    detail::ThrowRuntimeError("JSException", js_value__);
+  }
+  
+} // namespace HAL {
@@ -24,13 +24,24 @@ namespace HAL {
   void JSExportObject::postCallAsConstructor(const JSContext& js_context, const std::vector<JSValue>& arguments) {
     HAL_LOG_DEBUG("JSExportObject:: postCallAsConstructor ", this);
   }
+
+  void JSExportObject::postCallAsConstructor(const JSContext& js_context, const JSArguments& arguments) {
+    postCallAsConstructor(js_context, arguments.ToVector());
+  }
 	
   JSContext JSExportObject::get_context() const HAL_NOEXCEPT {
     return js_context__;
   }
   
   JSObject JSExportObject::get_object() HAL_NOEXCEPT {
-    return JSObject::FindJSObjectFromPrivateData(get_context(), this);
+    // This could happen when this native object was not created by
+    // JSExportClass. This Error object will be only used internally
+    // to see if object is found or not.
+    if (js_object_ref__ == nullptr) {
+      return js_context__.CreateError();
+    }
+    
+    return JSObject(js_context__, js_object_ref__);
   }
   
   JSExportObject::JSExportObject(const JSContext& js_context) HAL_NOEXCEPT
@@ -40,7 +51,28 @@ namespace HAL {
   
   JSExportObject::~JSExportObject() HAL_NOEXCEPT {
     HAL_LOG_DEBUG("JSExportObject:: dtor ", this);
-    JSObject::UnRegisterPrivateData(this);
+  }
+  
+  JSExportObject::JSExportObject(const JSExportObject& rhs) HAL_NOEXCEPT
+  : js_context__(rhs.js_context__) {
+    HAL_LOG_DEBUG("JSExportObject:: copy ctor ", this);
+  }
+  
+  JSExportObject::JSExportObject(JSExportObject&& rhs) HAL_NOEXCEPT
+  : js_context__(std::move(rhs.js_context__)) {
+    HAL_LOG_DEBUG("JSExportObject:: move ctor ", this);
+  }
+  
+  JSExportObject& JSExportObject::operator=(const JSExportObject& rhs) HAL_NOEXCEPT {
+    HAL_LOG_DEBUG("JSExportObject:: copy assign ", this);
+    js_context__ = rhs.js_context__;
+    return *this;
+  }
+  
+  JSExportObject& JSExportObject::operator=(JSExportObject&& rhs) HAL_NOEXCEPT {
+    HAL_LOG_DEBUG("JSExportObject:: move assign ", this);
+    swap(rhs);
+    return *this;
   }
   
   void JSExportObject::swap(JSExportObject& other) HAL_NOEXCEPT {
@@ -52,3 +84,11 @@ namespace HAL {
   }
   
 } // namespace HAL {
+
+namespace HAL { namespace detail {
+  
+  void JSExportObjectPostCallAsConstructor(JSExportObject* native_object_ptr, const JSContext& js_context, const JSArguments& arguments) {
+    native_object_ptr -> postCallAsConstructor(js_context, arguments);
+  }
+  
+}} // namespace HAL { namespace detail {
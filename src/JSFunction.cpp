@@ -10,27 +10,82 @@
 #include "HAL/JSString.hpp"
 #include "HAL/JSValue.hpp"
 #include "HAL/JSUndefined.hpp"
+#include "HAL/JSError.hpp"
+#include "HAL/JSHandleScope.hpp"
 #include "HAL/detail/JSUtil.hpp"
+#include "HAL/detail/JSContextLifetime.hpp"
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <stdexcept>
 #include <cassert>
 
 namespace HAL {
 
+namespace {
+    // The private data of a native function.
+    struct NativeFunction {
+        NativeFunction(const JSFunctionArgumentsCallback& callback, JSObjectRef js_object_ref)
+                : callback(callback)
+                , js_object_ref(js_object_ref) {
+        }
+
+        JSFunctionArgumentsCallback callback;
+        JSObjectRef                 js_object_ref;
+
+        // The JSContextLifetime of the function's context, and how many
+        // references to it the callback holds. The JSContextLifetime is
+        // nullptr once it no longer keeps track of the callback.
+        detail::JSContextLifetime*  js_context_lifetime { nullptr };
+        std::size_t                 reference_count     { 0 };
+    };
+
+    // The native functions of each context that haven't been finalized
+    // yet.
+    std::unordered_map<detail::JSContextLifetime*, std::unordered_set<NativeFunction*>>& GetNativeFunctions() {
+        static std::unordered_map<detail::JSContextLifetime*, std::unordered_set<NativeFunction*>> native_functions;
+        return native_functions;
+    }
+
+    // The native functions that JavaScriptCore finalized, or whose
+    // callbacks were detached, but that have not been destroyed yet.
+    std::vector<NativeFunction*>& GetFinalizedCallbacks() {
+        static std::vector<NativeFunction*> finalized_callbacks;
+        return finalized_callbacks;
+    }
+
+    // Protects both of the above.
+    std::mutex& GetFinalizedCallbacksMutex() {
+        static std::mutex finalized_callbacks_mutex;
+        return finalized_callbacks_mutex;
+    }
+
+    // Lets DestroyFinalizedCallbacks skip the lock when there is
+    // nothing to destroy, which is almost always.
+    std::atomic<bool> has_finalized_callbacks { false };
+}
+
 JSFunction::JSFunction(const JSContext& js_context, const JSString& body, const std::vector<JSString>& parameter_names, const JSString& function_name, const JSString& source_url, int starting_line_number)
         : JSObject(js_context, MakeFunction(js_context, body, parameter_names, function_name, source_url, starting_line_number)) {
 }
 
 JSFunction::JSFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionCallback& callback)
+        : JSObject(js_context, MakeFunction(js_context, function_name, ToArgumentsCallback(callback))) {
+}
+
+JSFunction::JSFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionArgumentsCallback& callback)
         : JSObject(js_context, MakeFunction(js_context, function_name, callback)) {
 }
 
 JSObjectRef JSFunction::MakeFunction(const JSContext& js_context, const JSString& body, const std::vector<JSString>& parameter_names, const JSString& func_name, const JSString& source_url, int starting_line_number) {
 
     JSString function_name = func_name;
-    if (function_name == "") {
-        function_name = JSString("anonymous");
+    if (function_name.empty()) {
+        static const auto& anonymous = JSString::Intern("anonymous");
+        function_name = anonymous;
     }
 
     JSValueRef exception { nullptr };
@@ -53,67 +108,161 @@ JSObjectRef JSFunction::MakeFunction(const JSContext& js_context, const JSString
     return js_object_ref;
 }
 
-std::unordered_map<std::intptr_t, JSFunctionCallback> JSFunction::js_object_ref_to_js_function__;
+JSClassRef JSFunction::GetNativeFunctionClass() HAL_NOEXCEPT {
+    // Like an interned string, the class lives as long as the process.
+    static const JSClassRef js_class_ref = [] {
+        JSClassDefinition js_class_definition = kJSClassDefinitionEmpty;
+        js_class_definition.attributes     = kJSClassAttributeNoAutomaticPrototype;
+        js_class_definition.className      = "Function";
+        js_class_definition.finalize       = JSFunction::JSObjectFinalizeCallback;
+        js_class_definition.callAsFunction = JSFunction::JSObjectCallAsFunctionCallback;
+        return JSClassCreate(&js_class_definition);
+    }();
+    return js_class_ref;
+}
+
+bool JSFunction::IsNativeFunction(JSContextRef context_ref, JSObjectRef object_ref) HAL_NOEXCEPT {
+    return JSValueIsObjectOfClass(context_ref, object_ref, GetNativeFunctionClass());
+}
 
-void JSFunction::RegisterJSFunctionCallback(JSObjectRef js_object_ref, JSFunctionCallback callback) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key   = reinterpret_cast<std::intptr_t>(js_object_ref);
-    const auto value = callback;
-    const auto position = js_object_ref_to_js_function__.find(key);
-    const bool found    = position != js_object_ref_to_js_function__.end();
+JSValueRef JSFunction::JSObjectCallAsFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) {
+    DestroyFinalizedCallbacks();
+    const auto native_function = static_cast<const NativeFunction*>(JSObjectGetPrivate(function_ref));
+    if (native_function == nullptr) {
+        return JSValueMakeUndefined(context_ref);
+    }
+    JSHandleScope handle_scope;
+    const auto js_context = JSContext(context_ref);
+    auto this_object = JSObject(js_context, this_object_ref);
     
-    if (found) {
-      HAL_LOG_DEBUG("JSFunction::RegisterJSFunctionCallback: JSObjectRef ", js_object_ref, " already registered");
-    } else {
-      const auto insert_result = js_object_ref_to_js_function__.emplace(key, value);
-      const bool inserted      = insert_result.second;
-      
-      assert(inserted);
+    // A C++ exception must not unwind through JavaScriptCore, so throw
+    // it as a JavaScript exception instead.
+    try {
+        return static_cast<JSValueRef>(native_function -> callback(JSArguments(context_ref, argument_count, arguments_array), this_object));
+    } catch (const detail::js_runtime_error& e) {
+        *exception = static_cast<JSValueRef>(e.js_error());
+    } catch (const std::exception& e) {
+        HAL_LOG_ERROR("JSFunction: ", e.what());
+        *exception = static_cast<JSValueRef>(js_context.CreateError({ js_context.CreateString(e.what()) }));
+    } catch (...) {
+        HAL_LOG_ERROR("JSFunction: unknown exception");
+        *exception = static_cast<JSValueRef>(js_context.CreateError({ js_context.CreateString("unknown exception") }));
     }
+    return nullptr;
 }
 
-void JSFunction::UnRegisterJSFunctionCallback(JSObjectRef js_object_ref) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key = reinterpret_cast<std::intptr_t>(js_object_ref);
-    js_object_ref_to_js_function__.erase(key);
+JSFunctionArgumentsCallback JSFunction::ToArgumentsCallback(const JSFunctionCallback& callback) {
+    if (!callback) {
+        return nullptr;
+    }
+    return [callback](const JSArguments& arguments, JSObject& this_object) {
+        return callback(arguments.ToVector(), this_object);
+    };
 }
 
-JSFunctionCallback JSFunction::FindJSFunctionCallback(JSObjectRef js_object_ref) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key      = reinterpret_cast<std::intptr_t>(js_object_ref);
-    const auto position = js_object_ref_to_js_function__.find(key);
-    const bool found    = position != js_object_ref_to_js_function__.end();
-    
-    if (found) {
-      return position->second;
-    } else {
-        return nullptr;
+void JSFunction::JSObjectFinalizeCallback(JSObjectRef function_ref) {
+    std::lock_guard<std::mutex> lock(GetFinalizedCallbacksMutex());
+    const auto native_function = static_cast<NativeFunction*>(JSObjectGetPrivate(function_ref));
+    if (native_function == nullptr) {
+        return;
     }
+    if (native_function -> js_context_lifetime) {
+        GetNativeFunctions()[native_function -> js_context_lifetime].erase(native_function);
+        native_function -> js_context_lifetime -> RemoveCallbackReferences(native_function -> reference_count);
+        native_function -> js_context_lifetime = nullptr;
+    }
+    GetFinalizedCallbacks().push_back(native_function);
+    has_finalized_callbacks.store(true, std::memory_order_release);
 }
 
-JSValueRef JSFunction::JSObjectCallAsFunctionCallback(JSContextRef context_ref, JSObjectRef function_ref, JSObjectRef this_object_ref, size_t argument_count, const JSValueRef arguments_array[], JSValueRef* exception) {
-    const auto callback = FindJSFunctionCallback(function_ref);
-    if (callback == nullptr) {
-        return JSValueMakeUndefined(context_ref);
+void JSFunction::DetachCallbacks(detail::JSContextLifetime* js_context_lifetime) HAL_NOEXCEPT {
+    {
+        std::lock_guard<std::mutex> lock(GetFinalizedCallbacksMutex());
+        auto& native_functions = GetNativeFunctions();
+        const auto position = native_functions.find(js_context_lifetime);
+        if (position == native_functions.end()) {
+            return;
+        }
+        
+        // JavaScript may still call the functions from another context
+        // in the same group, which then does nothing.
+        auto& finalized_callbacks = GetFinalizedCallbacks();
+        for (const auto native_function : position -> second) {
+            JSObjectSetPrivate(native_function -> js_object_ref, nullptr);
+            js_context_lifetime -> RemoveCallbackReferences(native_function -> reference_count);
+            native_function -> js_context_lifetime = nullptr;
+            finalized_callbacks.push_back(native_function);
+        }
+        native_functions.erase(position);
+        has_finalized_callbacks.store(true, std::memory_order_release);
     }
-    const auto ctx = JSContext(context_ref);
-    std::vector<JSValue> arguments;
-    arguments.reserve(argument_count);
-    for (size_t i = 0; i < argument_count; i++) {
-        arguments.push_back(JSValue(ctx, arguments_array[i]));
+    
+    DestroyFinalizedCallbacks();
+}
+
+void JSFunction::ForgetCallbacks(detail::JSContextLifetime* js_context_lifetime) HAL_NOEXCEPT {
+    std::lock_guard<std::mutex> lock(GetFinalizedCallbacksMutex());
+    auto& native_functions = GetNativeFunctions();
+    const auto position = native_functions.find(js_context_lifetime);
+    if (position == native_functions.end()) {
+        return;
     }
-    auto this_object = JSObject(ctx, this_object_ref);
-    return static_cast<JSValueRef>(callback(arguments, this_object));
+    for (const auto native_function : position -> second) {
+        native_function -> js_context_lifetime = nullptr;
+    }
+    native_functions.erase(position);
 }
 
-JSObjectRef JSFunction::MakeFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionCallback& callback) {
-    JSObjectRef js_object_ref = JSObjectMakeFunctionWithCallback(static_cast<JSContextRef>(js_context), static_cast<JSStringRef>(function_name), JSFunction::JSObjectCallAsFunctionCallback);
-    JSFunction::RegisterJSFunctionCallback(js_object_ref, callback);
-    return js_object_ref;
+void JSFunction::DestroyFinalizedCallbacks() HAL_NOEXCEPT {
+    if (!has_finalized_callbacks.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::vector<NativeFunction*> finalized_callbacks;
+    {
+        std::lock_guard<std::mutex> lock(GetFinalizedCallbacksMutex());
+        finalized_callbacks.swap(GetFinalizedCallbacks());
+        has_finalized_callbacks.store(false, std::memory_order_relaxed);
+    }
+    
+    // Destroying a callback may release the last reference to a global
+    // context, so it must happen outside the lock.
+    for (const auto native_function : finalized_callbacks) {
+        delete native_function;
+    }
 }
 
-JSFunction::~JSFunction() HAL_NOEXCEPT {
-    JSFunction::UnRegisterJSFunctionCallback(js_object_ref__);
+JSObjectRef JSFunction::MakeFunction(const JSContext& js_context, const JSString& function_name, const JSFunctionArgumentsCallback& callback) {
+    DestroyFinalizedCallbacks();
+    const auto js_context_ref = static_cast<JSContextRef>(js_context);
+    JSObjectRef js_object_ref = JSObjectMake(js_context_ref, GetNativeFunctionClass(), nullptr);
+    if (callback) {
+        // Copying the callback retains whatever it captured, so this
+        // counts the references to the context it holds. Capturing a
+        // handle of another context still keeps that context alive.
+        const auto js_context_lifetime = js_context.get_context_lifetime();
+        const auto reference_count     = js_context_lifetime -> get_reference_count();
+        const auto native_function     = new NativeFunction(callback, js_object_ref);
+        native_function -> reference_count     = js_context_lifetime -> get_reference_count() - reference_count;
+        native_function -> js_context_lifetime = js_context_lifetime;
+        
+        std::lock_guard<std::mutex> lock(GetFinalizedCallbacksMutex());
+        GetNativeFunctions()[js_context_lifetime].insert(native_function);
+        js_context_lifetime -> AddCallbackReferences(native_function -> reference_count);
+        JSObjectSetPrivate(js_object_ref, native_function);
+    }
+
+    // Look like a function made by JSObjectMakeFunctionWithCallback.
+    // Define the name before inheriting the read-only name of
+    // Function.prototype.
+    static const auto& name_property_name = JSString::Intern("name");
+    JSObjectSetProperty(js_context_ref, js_object_ref, static_cast<JSStringRef>(name_property_name), JSValueMakeString(js_context_ref, static_cast<JSStringRef>(function_name)), kJSPropertyAttributeReadOnly | kJSPropertyAttributeDontEnum, nullptr);
+
+    const JSObjectRef function_prototype = js_context.get_context_lifetime() -> GetFunctionPrototype();
+    if (function_prototype) {
+        JSObjectSetPrototype(js_context_ref, js_object_ref, function_prototype);
+    }
+
+    return js_object_ref;
 }
     
 } // namespace HAL {
@@ -0,0 +1,40 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSHandleScope.hpp"
+
+#include <cassert>
+
+namespace HAL {
+
+  namespace {
+    // The number of nested JSHandleScopes open on this thread.
+    HAL_THREAD_LOCAL std::size_t js_handle_scope_depth { 0 };
+  }
+
+  JSHandleScope::JSHandleScope() HAL_NOEXCEPT {
+    HAL_LOG_TRACE("JSHandleScope:: ctor ", this);
+    ++js_handle_scope_depth;
+  }
+
+  JSHandleScope::~JSHandleScope() HAL_NOEXCEPT {
+    HAL_LOG_TRACE("JSHandleScope:: dtor ", this);
+    // precondition
+    assert(js_handle_scope_depth > 0);
+    --js_handle_scope_depth;
+  }
+
+  bool JSHandleScope::IsOpen() HAL_NOEXCEPT {
+    return js_handle_scope_depth > 0;
+  }
+
+  std::size_t JSHandleScope::GetDepth() HAL_NOEXCEPT {
+    return js_handle_scope_depth;
+  }
+
+} // namespace HAL {
@@ -0,0 +1,123 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSLocal.hpp"
+
+#include "HAL/JSHandleScope.hpp"
+#include "HAL/JSContext.hpp"
+#include "HAL/JSString.hpp"
+#include "HAL/JSObject.hpp"
+
+#include "HAL/detail/JSUtil.hpp"
+#include "HAL/detail/JSValueUtil.hpp"
+
+#include <cassert>
+
+namespace HAL {
+
+  JSLocal::JSLocal(JSContextRef js_context_ref, JSValueRef js_value_ref) HAL_NOEXCEPT
+  : js_context_ref__(js_context_ref)
+  , js_value_ref__(js_value_ref) {
+    // preconditions
+    assert(js_context_ref__);
+    assert(js_value_ref__);
+    assert(JSHandleScope::IsOpen());
+  }
+
+  JSValue JSLocal::ToPersistent() const {
+    return JSValue(get_context(), js_value_ref__);
+  }
+
+  JSLocal::operator JSObject() const {
+    JSValueRef exception { nullptr };
+    JSObjectRef js_object_ref = JSValueToObject(js_context_ref__, js_value_ref__, &exception);
+
+    if (exception) {
+      // If this assert fails then we need to JSValueUnprotect
+      // js_object_ref.
+      assert(!js_object_ref);
+      detail::ThrowRuntimeError("JSLocal", JSValue(get_context(), exception));
+    }
+
+    assert(js_object_ref);
+    return JSObject(get_context(), js_object_ref);
+  }
+
+  JSLocal::operator JSString() const {
+    JSValueRef exception { nullptr };
+    JSStringRef js_string_ref = JSValueToStringCopy(js_context_ref__, js_value_ref__, &exception);
+    if (exception) {
+      // If this assert fails then we need to JSStringRelease
+      // js_string_ref.
+      assert(!js_string_ref);
+      detail::ThrowRuntimeError("JSLocal", JSValue(get_context(), exception));
+    }
+
+    assert(js_string_ref);
+    JSString js_string(js_string_ref);
+    JSStringRelease(js_string_ref);
+
+    return js_string;
+  }
+
+  JSLocal::operator std::string() const {
+    return operator JSString();
+  }
+
+  JSLocal::operator bool() const HAL_NOEXCEPT {
+    return JSValueToBoolean(js_context_ref__, js_value_ref__);
+  }
+
+  JSLocal::operator double() const {
+    JSValueRef exception { nullptr };
+    const double result = JSValueToNumber(js_context_ref__, js_value_ref__, &exception);
+
+    if (exception) {
+      detail::ThrowRuntimeError("JSLocal", JSValue(get_context(), exception));
+    }
+
+    return result;
+  }
+
+  JSLocal::operator int32_t() const {
+    return detail::to_int32_t(operator double());
+  }
+
+  JSValue::Type JSLocal::GetType() const HAL_NOEXCEPT {
+    return detail::ToJSValueType(JSValueGetType(js_context_ref__, js_value_ref__));
+  }
+
+  bool JSLocal::IsUndefined() const HAL_NOEXCEPT {
+    return JSValueIsUndefined(js_context_ref__, js_value_ref__);
+  }
+
+  bool JSLocal::IsNull() const HAL_NOEXCEPT {
+    return JSValueIsNull(js_context_ref__, js_value_ref__);
+  }
+
+  bool JSLocal::IsBoolean() const HAL_NOEXCEPT {
+    return JSValueIsBoolean(js_context_ref__, js_value_ref__);
+  }
+
+  bool JSLocal::IsNumber() const HAL_NOEXCEPT {
+    return JSValueIsNumber(js_context_ref__, js_value_ref__);
+  }
+
+  bool JSLocal::IsString() const HAL_NOEXCEPT {
+    return JSValueIsString(js_context_ref__, js_value_ref__);
+  }
+
+  bool JSLocal::IsObject() const HAL_NOEXCEPT {
+    return JSValueIsObject(js_context_ref__, js_value_ref__);
+  }
+
+  JSContext JSLocal::get_context() const HAL_NOEXCEPT {
+    return JSContext(js_context_ref__);
+  }
+
+} // namespace HAL {
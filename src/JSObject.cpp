@@ -17,6 +17,9 @@
 #include "HAL/JSNumber.hpp"
 #include "HAL/JSError.hpp"
 #include "HAL/JSArray.hpp"
+#include "HAL/JSFunction.hpp"
+#include "HAL/JSExportObject.hpp"
+#include "HAL/JSExpected.hpp"
 
 #include "HAL/detail/JSPropertyNameAccumulator.hpp"
 #include "HAL/detail/JSUtil.hpp"
@@ -28,11 +31,32 @@
 
 namespace HAL {
   
+  namespace {
+    // Return a JavaScript exception for an Error with the given
+    // message, for failures detected by HAL rather than JavaScript.
+    JSException CreateErrorException(const JSContext& js_context, const JSString& message) {
+      const JSContextRef js_context_ref = static_cast<JSContextRef>(js_context);
+      const JSValueRef arguments[] = { JSValueMakeString(js_context_ref, static_cast<JSStringRef>(message)) };
+      const JSObjectRef js_error_ref = JSObjectMakeError(js_context_ref, 1, arguments, nullptr);
+      assert(js_error_ref);
+      return JSException(JSValue(js_context, js_error_ref));
+    }
+  } // namespace {
+  
   bool JSObject::HasProperty(const JSString& property_name) const HAL_NOEXCEPT {
     return JSObjectHasProperty(static_cast<JSContextRef>(js_context__), js_object_ref__, static_cast<JSStringRef>(property_name));
   }
   
   JSValue JSObject::GetProperty(const JSString& property_name) const {
+    auto result = TryGetProperty(property_name);
+    if (!result) {
+      detail::ThrowRuntimeError("JSObject", result.error().get_value());
+    }
+    
+    return *result;
+  }
+  
+  JSExpected<JSValue> JSObject::TryGetProperty(const JSString& property_name) const {
     HAL_JSOBJECT_LOCK_GUARD;
     JSValueRef exception { nullptr };
     JSValueRef js_value_ref = JSObjectGetProperty(static_cast<JSContextRef>(js_context__), js_object_ref__, static_cast<JSStringRef>(property_name), &exception);
@@ -40,14 +64,35 @@ namespace HAL {
       // If this assert fails then we need to JSValueUnprotect
       // js_value_ref.
       assert(!js_value_ref);
-      detail::ThrowRuntimeError("JSObject", JSValue(js_context__, exception));
+      return JSException(JSValue(js_context__, exception));
     }
     
     assert(js_value_ref);
     return JSValue(js_context__, js_value_ref);
   }
   
+  bool JSObject::HasProperty(const JSPropertyKey& property_key) const HAL_NOEXCEPT {
+    return HasProperty(property_key.get_js_string());
+  }
+  
+  JSValue JSObject::GetProperty(const JSPropertyKey& property_key) const {
+    return GetProperty(property_key.get_js_string());
+  }
+  
+  JSExpected<JSValue> JSObject::TryGetProperty(const JSPropertyKey& property_key) const {
+    return TryGetProperty(property_key.get_js_string());
+  }
+  
   JSValue JSObject::GetProperty(unsigned property_index) const {
+    auto result = TryGetProperty(property_index);
+    if (!result) {
+      detail::ThrowRuntimeError("JSObject", result.error().get_value());
+    }
+    
+    return *result;
+  }
+  
+  JSExpected<JSValue> JSObject::TryGetProperty(unsigned property_index) const {
     HAL_JSOBJECT_LOCK_GUARD;
     JSValueRef exception { nullptr };
     JSValueRef js_value_ref = JSObjectGetPropertyAtIndex(static_cast<JSContextRef>(js_context__), js_object_ref__, property_index, &exception);
@@ -55,7 +100,7 @@ namespace HAL {
       // If this assert fails then we need to JSValueUnprotect
       // js_value_ref.
       assert(!js_value_ref);
-      detail::ThrowRuntimeError("JSObject", JSValue(js_context__, exception));
+      return JSException(JSValue(js_context__, exception));
     }
     
     assert(js_value_ref);
@@ -63,13 +108,26 @@ namespace HAL {
   }
   
   void JSObject::SetProperty(const JSString& property_name, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes) {
+    const auto result = TrySetProperty(property_name, property_value, attributes);
+    if (!result) {
+      detail::ThrowRuntimeError("JSObject", result.error().get_value());
+    }
+  }
+  
+  JSExpected<void> JSObject::TrySetProperty(const JSString& property_name, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes) {
     HAL_JSOBJECT_LOCK_GUARD;
     
     JSValueRef exception { nullptr };
     JSObjectSetProperty(static_cast<JSContextRef>(js_context__), js_object_ref__, static_cast<JSStringRef>(property_name), static_cast<JSValueRef>(property_value), detail::ToJSPropertyAttributes(attributes), &exception);
     if (exception) {
-      detail::ThrowRuntimeError("JSObject", JSValue(js_context__, exception));
+      return JSException(JSValue(js_context__, exception));
     }
+    
+    return JSExpected<void>();
+  }
+  
+  void JSObject::SetProperty(const JSPropertyKey& property_key, const JSValue& property_value, const std::unordered_set<JSPropertyAttribute>& attributes) {
+    SetProperty(property_key.get_js_string(), property_value, attributes);
   }
   
   void JSObject::SetProperty(unsigned property_index, const JSValue& property_value) {
@@ -94,6 +152,10 @@ namespace HAL {
     return result;
   }
   
+  bool JSObject::DeleteProperty(const JSPropertyKey& property_key) {
+    return DeleteProperty(property_key.get_js_string());
+  }
+  
   JSPropertyNameArray JSObject::GetPropertyNames() const HAL_NOEXCEPT {
     HAL_JSOBJECT_LOCK_GUARD;
     return JSPropertyNameArray(*this);
@@ -114,42 +176,41 @@ namespace HAL {
 
   bool JSObject::IsArray() const HAL_NOEXCEPT {
     HAL_JSOBJECT_LOCK_GUARD;
-
-    JSObject global_object = js_context__.get_global_object();
-    JSValue array_value = global_object.GetProperty("Array");
-    if (!array_value.IsObject()) {
+#if HAL_JSVALUEISARRAY_ENABLE
+    return JSValueIsArray(static_cast<JSContextRef>(js_context__), js_object_ref__);
+#else
+    const JSObjectRef array_is_array = js_context__.js_context_lifetime__ -> GetArrayIsArray();
+    if (!array_is_array) {
       return false;
     }
     
-    JSObject array = static_cast<JSObject>(array_value);
-    JSValue isArray_value = array.GetProperty("isArray");
-    if (!isArray_value.IsObject()) {
-      return false;
-    }
-    JSObject isArray = static_cast<JSObject>(isArray_value);
-    if (!isArray.IsFunction()) {
+    const JSValueRef arguments_array[] = { js_object_ref__ };
+    JSValueRef exception { nullptr };
+    const JSValueRef result = JSObjectCallAsFunction(static_cast<JSContextRef>(js_context__), array_is_array, nullptr, 1, arguments_array, &exception);
+    if (exception || !JSValueIsBoolean(static_cast<JSContextRef>(js_context__), result)) {
       return false;
     }
-
-    JSValue self = static_cast<JSValue>(*this);
-    JSValue result = isArray(self, global_object);
-    if (result.IsBoolean()) {
-        return static_cast<bool>(result);
-    }
     
-    return false;
+    return JSValueToBoolean(static_cast<JSContextRef>(js_context__), result);
+#endif
   }
   
   bool JSObject::IsError() const HAL_NOEXCEPT {
     HAL_JSOBJECT_LOCK_GUARD;
-    const auto global_object = js_context__.get_global_object();
-    const auto error_value = global_object.GetProperty("Error");
-    if (!error_value.IsObject()) {
+    const JSObjectRef error_constructor = js_context__.js_context_lifetime__ -> GetErrorConstructor();
+    if (!error_constructor) {
       return false;
     }
-    const auto error = static_cast<JSObject>(error_value);
-    const auto self  = static_cast<JSValue>(*this);
-    return static_cast<std::string>(self) == "[object Error]" || self.IsInstanceOfConstructor(error);
+    
+    JSValueRef exception { nullptr };
+    if (JSValueIsInstanceOfConstructor(static_cast<JSContextRef>(js_context__), js_object_ref__, error_constructor, &exception)) {
+      return true;
+    }
+    
+    // Fall back to the string conversion for errors that don't inherit
+    // from this context's Error, e.g. ones from another context.
+    const auto self = static_cast<JSValue>(*this);
+    return static_cast<std::string>(self) == "[object Error]";
   }
   
   JSValue JSObject::operator()(                                        JSObject this_object) { return CallAsFunction(std::vector<JSValue>()                      , this_object); }
@@ -167,10 +228,20 @@ namespace HAL {
   JSObject JSObject::CallAsConstructor(const JSString&              argument ) { return CallAsConstructor(std::vector<JSString> {argument}); }
   JSObject JSObject::CallAsConstructor(const std::vector<JSString>& arguments) { return CallAsConstructor(detail::to_vector(js_context__, arguments)); }
   JSObject JSObject::CallAsConstructor(const std::vector<JSValue>&  arguments) {
+    auto result = TryCallAsConstructor(arguments);
+    if (!result) {
+      detail::ThrowRuntimeError("JSObject", result.error().get_value());
+    }
+    
+    return *result;
+  }
+  
+  JSExpected<JSObject> JSObject::TryCallAsConstructor(const std::vector<JSValue>& arguments) {
     HAL_JSOBJECT_LOCK_GUARD;
     
     if (!IsConstructor()) {
-      detail::ThrowRuntimeError("JSObject", "This JavaScript object is not a constructor.");
+      static const auto& message = JSString::Intern("This JavaScript object is not a constructor.");
+      return CreateErrorException(js_context__, message);
     }
     
     JSValueRef exception { nullptr };
@@ -186,7 +257,7 @@ namespace HAL {
       // If this assert fails then we need to JSValueUnprotect
       // js_object_ref.
       assert(!js_object_ref);
-      detail::ThrowRuntimeError("JSObject", JSValue(js_context__, exception));
+      return JSException(JSValue(js_context__, exception));
     }
     
     // postcondition
@@ -202,47 +273,67 @@ namespace HAL {
     JSObjectSetPrototype(static_cast<JSContextRef>(js_context__), js_object_ref__, static_cast<JSValueRef>(js_value));
   }
   
+  // A native function's private data is its callback, which belongs
+  // to JSFunction.
   void* JSObject::GetPrivate() const HAL_NOEXCEPT {
-    return JSObjectGetPrivate(js_object_ref__);
+    if (JSFunction::IsNativeFunction(static_cast<JSContextRef>(js_context__), js_object_ref__)) {
+      return nullptr;
+    }
+    return GetJSExportPrivate();
   }
   
   bool JSObject::SetPrivate(void* data) const HAL_NOEXCEPT {
-    UnRegisterPrivateData(GetPrivate());
-    RegisterPrivateData(js_object_ref__, data);
+    if (JSFunction::IsNativeFunction(static_cast<JSContextRef>(js_context__), js_object_ref__)) {
+      return false;
+    }
+    return SetJSExportPrivate(data);
+  }
+  
+  void* JSObject::GetJSExportPrivate() const HAL_NOEXCEPT {
+    return JSObjectGetPrivate(js_object_ref__);
+  }
+  
+  bool JSObject::SetJSExportPrivate(void* data) const HAL_NOEXCEPT {
     return JSObjectSetPrivate(js_object_ref__, data);
   }
   
   JSObject::~JSObject() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSObject:: dtor ", this);
-    HAL_LOG_TRACE("JSObject:: release ", js_object_ref__, " for ", this);
-    JSValueUnprotect(static_cast<JSContextRef>(js_context__), js_object_ref__);
-    UnRegisterJSContext(js_object_ref__);
+    // A moved-from JSObject no longer protects a JSObjectRef.
+    if (js_object_ref__) {
+      HAL_LOG_TRACE("JSObject:: release ", js_object_ref__, " for ", this);
+      JSValueUnprotect(static_cast<JSContextRef>(js_context__), js_object_ref__);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSObject);
+    }
   }
   
   JSObject::JSObject(const JSObject& rhs) HAL_NOEXCEPT
   : js_context__(rhs.js_context__)
   , js_object_ref__(rhs.js_object_ref__) {
     HAL_LOG_TRACE("JSObject:: copy ctor ", this);
-    HAL_LOG_TRACE("JSObject:: retain ", js_object_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_object_ref__);
-    RegisterJSContext(static_cast<JSContextRef>(js_context__), js_object_ref__);
+    if (js_object_ref__) {
+      HAL_LOG_TRACE("JSObject:: retain ", js_object_ref__, " for ", this);
+      JSValueProtect(static_cast<JSContextRef>(js_context__), js_object_ref__);
+      HAL_PERFORMANCE_COUNTER_RETAIN(JSObject);
+    }
   }
   
   JSObject::JSObject(JSObject&& rhs) HAL_NOEXCEPT
   : js_context__(std::move(rhs.js_context__))
   , js_object_ref__(rhs.js_object_ref__) {
     HAL_LOG_TRACE("JSObject:: move ctor ", this);
-    HAL_LOG_TRACE("JSObject:: retain ", js_object_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_object_ref__);
-    RegisterJSContext(static_cast<JSContextRef>(js_context__), js_object_ref__);
+    // Take over rhs's protection of its JSObjectRef instead of
+    // protecting it again.
+    rhs.js_object_ref__ = nullptr;
   }
   
   JSObject& JSObject::operator=(JSObject rhs) {
     HAL_JSOBJECT_LOCK_GUARD;
     HAL_LOG_TRACE("JSObject:: assignment ", this);
     // JSValues can only be copied between contexts within the same
-    // context group.
-    if (js_context__.get_context_group() != rhs.js_context__.get_context_group()) {
+    // context group, but a moved-from JSObject may be assigned anything
+    // and be assigned to anything.
+    if (js_object_ref__ && rhs.js_object_ref__ && js_context__.get_context_group_ref() != rhs.js_context__.get_context_group_ref()) {
       detail::ThrowRuntimeError("JSObject", "JSObjects must belong to JSContexts within the same JSContextGroup to be shared and exchanged.");
     }
     
@@ -267,7 +358,7 @@ namespace HAL {
     HAL_LOG_TRACE("JSObject:: ctor 1 ", this);
     HAL_LOG_TRACE("JSObject:: retain ", js_object_ref__, " (implicit) for ", this);
     JSValueProtect(static_cast<JSContextRef>(js_context__), js_object_ref__);
-    RegisterJSContext(static_cast<JSContextRef>(js_context__), js_object_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSObject);
   }
 
   // For interoperability with the JavaScriptCore C API.
@@ -277,7 +368,7 @@ namespace HAL {
     HAL_LOG_TRACE("JSObject:: ctor 2 ", this);
     HAL_LOG_TRACE("JSObject:: retain ", js_object_ref__, " for ", this);
     JSValueProtect(static_cast<JSContextRef>(js_context__), js_object_ref__);
-    RegisterJSContext(static_cast<JSContextRef>(js_context__), js_object_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSObject);
   }
   
   JSObject::operator JSValue() const {
@@ -293,10 +384,20 @@ namespace HAL {
   }
   
   JSValue JSObject::CallAsFunction(const std::vector<JSValue>&  arguments, JSObject this_object) {
+    auto result = TryCallAsFunction(arguments, this_object);
+    if (!result) {
+      detail::ThrowRuntimeError("JSObject", result.error().get_value());
+    }
+    
+    return *result;
+  }
+  
+  JSExpected<JSValue> JSObject::TryCallAsFunction(const std::vector<JSValue>& arguments, JSObject this_object) {
     HAL_JSOBJECT_LOCK_GUARD;
     
     if (!IsFunction()) {
-      detail::ThrowRuntimeError("JSObject", "This JavaScript object is not a function.");
+      static const auto& message = JSString::Intern("This JavaScript object is not a function.");
+      return CreateErrorException(js_context__, message);
     }
     
     JSValueRef exception { nullptr };
@@ -312,7 +413,7 @@ namespace HAL {
       // If this assert fails then we need to JSValueUnprotect
       // js_value_ref.
       assert(!js_value_ref);
-      detail::ThrowRuntimeError("JSObject", JSValue(js_context__, exception));
+      return JSException(JSValue(js_context__, exception));
     }
     
     assert(js_value_ref);
@@ -326,135 +427,24 @@ namespace HAL {
     }
   }
   
-  std::unordered_map<std::intptr_t, std::tuple<std::intptr_t, std::size_t>> JSObject::js_object_ref_to_js_context_ref_map__;
-  
-  void JSObject::RegisterJSContext(JSContextRef js_context_ref, JSObjectRef js_object_ref) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key   = reinterpret_cast<std::intptr_t>(js_object_ref);
-    const auto value = reinterpret_cast<std::intptr_t>(js_context_ref);
-    
-    const auto position = js_object_ref_to_js_context_ref_map__.find(key);
-    const bool found    = position != js_object_ref_to_js_context_ref_map__.end();
-    
-    if (found) {
-      auto tuple = position -> second;
-      ++std::get<1>(tuple);
-      js_object_ref_to_js_context_ref_map__[key] = tuple;
-      
-      HAL_LOG_DEBUG("JSObject::RegisterJSContext: JSObjectRef = ", js_object_ref, ", JSContextRef = ", js_context_ref, " count = ", std::get<1>(tuple));
-    } else {
-      const auto insert_result = js_object_ref_to_js_context_ref_map__.emplace(key, std::make_tuple(value, 1));
-      const bool inserted      = insert_result.second;
-      
-      // postcondition
-      assert(inserted);
-      HAL_LOG_DEBUG("JSObject::RegisterJSContext: JSObjectRef = ", js_object_ref, ", JSContextRef = ", js_context_ref, " count = 1");
-    }
-  }
-  
-  void JSObject::UnRegisterJSContext(JSObjectRef js_object_ref) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key      = reinterpret_cast<std::intptr_t>(js_object_ref);
-    const auto position = js_object_ref_to_js_context_ref_map__.find(key);
-    const bool found    = position != js_object_ref_to_js_context_ref_map__.end();
-    
-    // precondition
-    if (found) {
-      auto tuple = position -> second;
-      JSContextRef js_context_ref = reinterpret_cast<JSContextRef>(std::get<0>(tuple));
-      static_cast<void>(js_context_ref); // just meant to suppress "unused" compiler warning
-      --std::get<1>(tuple);
-      if (std::get<1>(tuple) == 0) {
-        js_object_ref_to_js_context_ref_map__.erase(key);
-      } else {
-        js_object_ref_to_js_context_ref_map__[key] = tuple;
-      }
-      HAL_LOG_DEBUG("JSObject::UnRegisterJSContext: JSObjectRef = ", js_object_ref, ", JSContextRef = ", js_context_ref, " count = ", std::get<1>(tuple));
-    } else {
-      HAL_LOG_DEBUG("JSObject::UnRegisterJSContext: JSObjectRef = ", js_object_ref, " not registered");
-    }
-  }
-
   JSObject JSObject::FindJSObject(JSContextRef js_context_ref, JSObjectRef js_object_ref) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key      = reinterpret_cast<std::intptr_t>(js_object_ref);
-    const auto position = js_object_ref_to_js_context_ref_map__.find(key);
-    const bool found    = position != js_object_ref_to_js_context_ref_map__.end();
-    
-    // precondition
-    if (found) {
-      js_context_ref = reinterpret_cast<JSContextRef>(std::get<0>(position -> second));
-    }
-    
-    HAL_LOG_TRACE("JSObject::FindJSObject: found = ", found, " for JSObjectRef ", js_object_ref, ", JSContextRef = ", js_context_ref);
-    
+    HAL_LOG_TRACE("JSObject::FindJSObject: JSObjectRef = ", js_object_ref, ", JSContextRef = ", js_context_ref);
     return JSObject(JSContext(js_context_ref), js_object_ref);
   }
 
-  std::unordered_map<std::intptr_t, std::intptr_t> JSObject::js_private_data_to_js_object_ref_map__;
-  
-  void JSObject::RegisterPrivateData(JSObjectRef js_object_ref, void* private_data) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    // we won't store nullptr
+  JSObject JSObject::FindJSObjectFromPrivateData(JSContext js_context, JSExportObject* private_data) {
+    // This could happen when owner object is gargabe collected while executing async operation.
+    // This Error object will be only used internally to see if object is found or not.
     if (private_data == nullptr) {
-      return;
+      return js_context.CreateError();
     }
-    const auto key   = reinterpret_cast<std::intptr_t>(private_data);
-    const auto value = reinterpret_cast<std::intptr_t>(js_object_ref);
-    
-    const auto position = js_private_data_to_js_object_ref_map__.find(key);
-    const bool found    = position != js_private_data_to_js_object_ref_map__.end();
     
-    if (found) {
-      // private data should not be shared by multiple JSObjectRef
-      assert((reinterpret_cast<JSObjectRef>(position -> second) == js_object_ref));
-    } else {
-      const auto insert_result = js_private_data_to_js_object_ref_map__.emplace(key, value);
-      const bool inserted      = insert_result.second;
-      
-      // postcondition
-      assert(inserted);
-      
-      HAL_LOG_DEBUG("JSObject::RegisterPrivateData: JSObjectRef = ", js_object_ref, ", data = ", private_data);
-    }
+    return private_data -> get_object();
   }
   
-  void JSObject::UnRegisterPrivateData(void* private_data) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    // we won't store nullptr
-    if (private_data == nullptr) {
-      return;
-    }
-    const auto key      = reinterpret_cast<std::intptr_t>(private_data);
-    const auto position = js_private_data_to_js_object_ref_map__.find(key);
-    const bool found    = position != js_private_data_to_js_object_ref_map__.end();
-    
-    if (found) {
-      JSObjectRef js_object_ref = reinterpret_cast<JSObjectRef>(position -> second);
-      static_cast<void>(js_object_ref); // just meant to suppress "unused" compiler warning
-      js_private_data_to_js_object_ref_map__.erase(key);
-      HAL_LOG_DEBUG("JSObject::UnRegisterPrivateData: data = ", private_data, ", JSObjectRef = ", js_object_ref);
-    } else {
-      HAL_LOG_DEBUG("JSObject::UnRegisterPrivateData: data = ", private_data, " not registered");
-    }
-  }
-
   JSObject JSObject::FindJSObjectFromPrivateData(JSContext js_context, void* private_data) {
-    HAL_JSOBJECT_LOCK_GUARD_STATIC;
-    const auto key      = reinterpret_cast<std::intptr_t>(private_data);
-    const auto position = js_private_data_to_js_object_ref_map__.find(key);
-    const bool found    = position != js_private_data_to_js_object_ref_map__.end();
-
-    // This could happen when owner object is gargabe collected while executing async operation.
-    // This Error object will be only used internally to see if object is found or not.
-    if (!found) {
-      return js_context.CreateError();
-    }
-
-    JSObjectRef js_object_ref = reinterpret_cast<JSObjectRef>(position -> second);
-    HAL_LOG_TRACE("JSObject::FindJSObjectFromPrivateData: found = ", found, " for data = ", key, ", JSObjectRef = ", js_object_ref);
-
-    return FindJSObject(static_cast<JSContextRef>(js_context), js_object_ref);
+    // The private data of a JSExport object is its JSExportObject.
+    return FindJSObjectFromPrivateData(js_context, static_cast<JSExportObject*>(private_data));
   }
 
 } // namespace HAL {
@@ -0,0 +1,27 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSPropertyKey.hpp"
+
+#include <string>
+
+namespace HAL {
+  
+  const JSString& JSPropertyKey::get_js_string() const {
+    auto js_string = js_string__.load(std::memory_order_acquire);
+    if (!js_string) {
+      // Racing threads intern the same JSString, so whichever store
+      // lands last is as good as any other.
+      js_string = &JSString::Intern(std::string(string__, length__));
+      js_string__.store(js_string, std::memory_order_release);
+    }
+    
+    return *js_string;
+  }
+  
+} // namespace HAL {
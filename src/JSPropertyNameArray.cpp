@@ -38,8 +38,13 @@ namespace HAL {
   
   JSPropertyNameArray::~JSPropertyNameArray() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSPropertyNameArray:: dtor ", this);
-    HAL_LOG_TRACE("JSPropertyNameArray:: release ", js_property_name_array_ref__, " for ", this);
-    JSPropertyNameArrayRelease(js_property_name_array_ref__);
+    // A moved-from JSPropertyNameArray no longer owns a
+    // JSPropertyNameArrayRef.
+    if (js_property_name_array_ref__) {
+      HAL_LOG_TRACE("JSPropertyNameArray:: release ", js_property_name_array_ref__, " for ", this);
+      JSPropertyNameArrayRelease(js_property_name_array_ref__);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSPropertyNameArray);
+    }
   }
   
   JSPropertyNameArray::JSPropertyNameArray(const JSPropertyNameArray& rhs) HAL_NOEXCEPT
@@ -47,18 +52,20 @@ namespace HAL {
     HAL_LOG_TRACE("JSPropertyNameArray:: copy ctor ", this);
     HAL_LOG_TRACE("JSPropertyNameArray:: retain ", js_property_name_array_ref__, " for ", this);
     JSPropertyNameArrayRetain(js_property_name_array_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSPropertyNameArray);
   }
   
   JSPropertyNameArray::JSPropertyNameArray(JSPropertyNameArray&& rhs) HAL_NOEXCEPT
   : js_property_name_array_ref__(rhs.js_property_name_array_ref__) {
-    HAL_LOG_TRACE("JSValue:: move ctor ", this);
-    HAL_LOG_TRACE("JSPropertyNameArray:: retain ", js_property_name_array_ref__, " for ", this);
-    JSPropertyNameArrayRetain(js_property_name_array_ref__);
+    HAL_LOG_TRACE("JSPropertyNameArray:: move ctor ", this);
+    // Take ownership of rhs's JSPropertyNameArrayRef instead of
+    // retaining it.
+    rhs.js_property_name_array_ref__ = nullptr;
   }
   
   JSPropertyNameArray& JSPropertyNameArray::operator=(JSPropertyNameArray rhs) HAL_NOEXCEPT {
     HAL_JSPROPERTYNAMEARRAY_LOCK_GUARD;
-    HAL_LOG_TRACE("JSValue:: assignment ", this);
+    HAL_LOG_TRACE("JSPropertyNameArray:: assignment ", this);
     swap(rhs);
     return *this;
   }
@@ -77,6 +84,7 @@ namespace HAL {
   : js_property_name_array_ref__(JSObjectCopyPropertyNames(static_cast<JSContextRef>(js_object.get_context()), static_cast<JSObjectRef>(js_object))) {
     HAL_LOG_TRACE("JSPropertyNameArray:: ctor ", this);
     HAL_LOG_TRACE("JSPropertyNameArray:: retain ", js_property_name_array_ref__, " for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSPropertyNameArray);
   }
   
 } // namespace HAL {
@@ -7,41 +7,132 @@
  */
 
 #include "HAL/JSString.hpp"
+#include "HAL/detail/HashUtilities.hpp"
+#include "HAL/detail/UTFUtilities.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace HAL {
   
+  namespace {
+    
+    std::size_t HashUTF16(const JSChar* characters, std::size_t length) HAL_NOEXCEPT {
+      std::size_t hash_value = detail::fnv1a<sizeof(std::size_t)>::offset_basis();
+      for (std::size_t i = 0; i < length; ++i) {
+        hash_value = detail::fnv1a_utf16_step(hash_value, characters[i]);
+      }
+      
+      return detail::fnv1a_utf16_finish(hash_value);
+    }
+    
+    JSStringRef CreateJSStringRef(const char* string, std::size_t length) HAL_NOEXCEPT {
+      // A UTF-16 string never has more code units than its UTF-8
+      // equivalent has bytes, so short strings fit on the stack.
+      JSChar stack_buffer[256];
+      std::vector<JSChar> heap_buffer;
+      JSChar* buffer = stack_buffer;
+      if (length > sizeof(stack_buffer) / sizeof(stack_buffer[0])) {
+        heap_buffer.resize(length);
+        buffer = heap_buffer.data();
+      }
+      
+      std::size_t utf16_length = 0;
+      if (detail::UTF8ToUTF16(string, length, buffer, utf16_length)) {
+        return JSStringCreateWithCharacters(buffer, utf16_length);
+      }
+      
+      // Let JavaScriptCore decide what malformed UTF-8 means.
+      return JSStringCreateWithUTF8CString(std::string(string, length).c_str());
+    }
+    
+    // Return the length of the longest prefix of the given UTF-8 string
+    // that fits in the given number of bytes without splitting a
+    // character.
+    std::size_t TruncateUTF8(const char* string, std::size_t length, std::size_t max_length) HAL_NOEXCEPT {
+      if (length <= max_length) {
+        return length;
+      }
+      
+      while (max_length > 0 && (static_cast<unsigned char>(string[max_length]) & 0xC0) == 0x80) {
+        --max_length;
+      }
+      
+      return max_length;
+    }
+    
+    // The interned JSStrings. They are never destroyed so that they
+    // remain usable from other static destructors.
+    std::unordered_map<std::string, const JSString*>& GetInternedJSStringMap() {
+      static auto interned_js_string_map = new std::unordered_map<std::string, const JSString*>();
+      return *interned_js_string_map;
+    }
+    
+    std::mutex& GetInternedJSStringMapMutex() {
+      static auto interned_js_string_map_mutex = new std::mutex();
+      return *interned_js_string_map_mutex;
+    }
+    
+  } // namespace {
+  
   JSString::JSString() HAL_NOEXCEPT
   : JSString("") {
     //HAL_LOG_TRACE("JSString::JSString()");
   }
   
   JSString::JSString(const char* string) HAL_NOEXCEPT
-  : js_string_ref__(JSStringCreateWithUTF8CString(string))
-  , string__(string) {
+  : js_string_ref__(CreateJSStringRef(string, std::strlen(string))) {
     HAL_LOG_TRACE("JSString:: ctor 1 ", this);
     HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " (implicit) for ", this);
-    
-    std::hash<std::string> hash_function = std::hash<std::string>();
-    hash_value__ = hash_function(static_cast<std::string>(string__));
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
     //HAL_LOG_TRACE("JSString::JSString(const char*)");
   }
   
   JSString::JSString(const std::string& string) HAL_NOEXCEPT
-  : js_string_ref__(JSStringCreateWithUTF8CString(string.c_str()))
-  , string__(string) {
+  : js_string_ref__(CreateJSStringRef(string.c_str(), std::strlen(string.c_str()))) {
+    // Like the const char* constructor, stop at the first null
+    // character.
     HAL_LOG_TRACE("JSString:: ctor 2 ", this);
     HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " (implicit) for ", this);
-
-    std::hash<std::string> hash_function = std::hash<std::string>();
-    hash_value__ = hash_function(static_cast<std::string>(string__));
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
     //HAL_LOG_TRACE("JSString::JSString(const std::string&)");
   }
   
+  JSString::JSString(const char* string, std::size_t length) HAL_NOEXCEPT
+  : js_string_ref__(CreateJSStringRef(string, length)) {
+    HAL_LOG_TRACE("JSString:: ctor 4 ", this);
+    HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " (implicit) for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
+  }
+  
+  JSString::JSString(const JSChar* string, std::size_t length) HAL_NOEXCEPT
+  : js_string_ref__(JSStringCreateWithCharacters(string, length)) {
+    HAL_LOG_TRACE("JSString:: ctor 5 ", this);
+    HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " (implicit) for ", this);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
+  }
+  
+  const JSString& JSString::Intern(const std::string& string) {
+    auto& interned_js_string_map = GetInternedJSStringMap();
+    std::lock_guard<std::mutex> lock(GetInternedJSStringMapMutex());
+    const auto position = interned_js_string_map.find(string);
+    if (position != interned_js_string_map.end()) {
+      return *position -> second;
+    }
+    
+    const auto js_string = new JSString(string);
+    interned_js_string_map.emplace(string, js_string);
+    return *js_string;
+  }
+  
   const std::size_t JSString::length() const  HAL_NOEXCEPT{
     HAL_JSSTRING_LOCK_GUARD;
-    return JSStringGetLength(js_string_ref__);
+    return js_string_ref__ ? JSStringGetLength(js_string_ref__) : 0;
   }
   
   const std::size_t JSString::size() const HAL_NOEXCEPT {
@@ -53,35 +144,129 @@ namespace HAL {
   }
   
   JSString::operator std::string() const HAL_NOEXCEPT {
-    return string__;
+    return GetUTF8();
+  }
+  
+  std::size_t JSString::CopyUTF8To(char* buffer, std::size_t buffer_size) const HAL_NOEXCEPT {
+    if (buffer_size == 0) {
+      return 0;
+    }
+    
+    // A moved-from JSString reads as the empty string.
+    if (!js_string_ref__) {
+      buffer[0] = '\0';
+      return 0;
+    }
+    
+    // Reuse the UTF-8 conversion if it has already been paid for.
+    const auto string = string__.load(std::memory_order_acquire);
+    if (string) {
+      const auto length = TruncateUTF8(string -> data(), string -> size(), buffer_size - 1);
+      std::copy(string -> data(), string -> data() + length, buffer);
+      buffer[length] = '\0';
+      return length;
+    }
+    
+    const JSChar* characters = JSStringGetCharactersPtr(js_string_ref__);
+    const std::size_t length = JSStringGetLength(js_string_ref__);
+    std::size_t utf8_length = 0;
+    if (detail::GetUTF8Length(characters, length, utf8_length) && utf8_length < buffer_size) {
+      detail::UTF16ToUTF8(characters, length, buffer);
+      buffer[utf8_length] = '\0';
+      return utf8_length;
+    }
+    
+    // Either the buffer is too small or the string has unpaired
+    // surrogates, both of which JavaScriptCore already handles.
+    const auto size_with_null = JSStringGetUTF8CString(js_string_ref__, buffer, buffer_size);
+    return size_with_null > 0 ? size_with_null - 1 : 0;
   }
   
-  std::size_t JSString::hash_value() const {
-    return hash_value__;
+  std::size_t JSString::hash_value() const HAL_NOEXCEPT {
+    auto hash_value = hash_value__.load(std::memory_order_relaxed);
+    if (hash_value == 0 && js_string_ref__) {
+      // Racing threads compute the same value, so whichever store
+      // lands last is as good as any other.
+      hash_value = HashUTF16(JSStringGetCharactersPtr(js_string_ref__), JSStringGetLength(js_string_ref__));
+      hash_value__.store(hash_value, std::memory_order_relaxed);
+    }
+    
+    return hash_value;
+  }
+  
+  const std::string& JSString::GetUTF8() const HAL_NOEXCEPT {
+    auto string = string__.load(std::memory_order_acquire);
+    if (string) {
+      return *string;
+    }
+    
+    if (!js_string_ref__) {
+      static const std::string empty_string;
+      return empty_string;
+    }
+    
+    const JSChar* characters = JSStringGetCharactersPtr(js_string_ref__);
+    const std::size_t length = JSStringGetLength(js_string_ref__);
+    std::size_t utf8_length = 0;
+    std::string* new_string { nullptr };
+    if (detail::GetUTF8Length(characters, length, utf8_length)) {
+      new_string = new std::string(utf8_length, '\0');
+      if (utf8_length > 0) {
+        detail::UTF16ToUTF8(characters, length, &(*new_string)[0]);
+      }
+    } else {
+      // Let JavaScriptCore decide what unpaired surrogates mean.
+      const auto size = JSStringGetMaximumUTF8CStringSize(js_string_ref__);
+      new_string = new std::string(size, '\0');
+      const auto size_with_null = JSStringGetUTF8CString(js_string_ref__, &(*new_string)[0], size);
+      new_string -> resize(size_with_null > 0 ? size_with_null - 1 : 0);
+    }
+    
+    // If another thread installed its copy first then use that one.
+    if (string__.compare_exchange_strong(string, new_string, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return *new_string;
+    }
+    
+    delete new_string;
+    return *string;
   }
   
   JSString::~JSString() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSString:: dtor ", this);
-    HAL_LOG_TRACE("JSString:: release ", js_string_ref__, " for ", this);
-    JSStringRelease(js_string_ref__);
+    delete string__.load(std::memory_order_relaxed);
+    
+    // A moved-from JSString no longer owns a JSStringRef.
+    if (js_string_ref__) {
+      HAL_LOG_TRACE("JSString:: release ", js_string_ref__, " for ", this);
+      JSStringRelease(js_string_ref__);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSString);
+    }
   }
   
   JSString::JSString(const JSString& rhs) HAL_NOEXCEPT
   : js_string_ref__(rhs.js_string_ref__)
-  , string__(rhs.string__)
-  , hash_value__(rhs.hash_value__) {
+  , hash_value__(rhs.hash_value__.load(std::memory_order_relaxed)) {
     HAL_LOG_TRACE("JSString:: copy ctor ", this);
-    HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " for ", this);
-    JSStringRetain(js_string_ref__);
+    if (js_string_ref__) {
+      HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " for ", this);
+      JSStringRetain(js_string_ref__);
+      HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
+    }
+    
+    // Keep rhs's UTF-8 conversion if it has already paid for one.
+    const auto string = rhs.string__.load(std::memory_order_acquire);
+    if (string) {
+      string__.store(new std::string(*string), std::memory_order_relaxed);
+    }
   }
   
   JSString::JSString(JSString&& rhs) HAL_NOEXCEPT
   : js_string_ref__(rhs.js_string_ref__)
-  , string__(std::move(rhs.string__))
-  , hash_value__(std::move(rhs.hash_value__)) {
+  , string__(rhs.string__.exchange(nullptr))
+  , hash_value__(rhs.hash_value__.exchange(0)) {
     HAL_LOG_TRACE("JSString:: move ctor ", this);
-    HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " for ", this);
-    JSStringRetain(js_string_ref__);
+    // Take ownership of rhs's JSStringRef instead of retaining it.
+    rhs.js_string_ref__ = nullptr;
   }
   
   JSString& JSString::operator=(JSString rhs) HAL_NOEXCEPT {
@@ -99,8 +284,8 @@ namespace HAL {
     // By swapping the members of two classes, the two classes are
     // effectively swapped.
     swap(js_string_ref__, other.js_string_ref__);
-    swap(string__       , other.string__);
-    swap(hash_value__   , other.hash_value__);
+    string__     = other.string__.exchange(string__.load());
+    hash_value__ = other.hash_value__.exchange(hash_value__.load());
   }
   
   // For interoperability with the JavaScriptCore C API.
@@ -108,17 +293,9 @@ namespace HAL {
   : js_string_ref__(js_string_ref) {
     assert(js_string_ref__);
     JSStringRetain(js_string_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSString);
     HAL_LOG_TRACE("JSString:: ctor 3 ", this);
     HAL_LOG_TRACE("JSString:: retain ", js_string_ref__, " for ", this);
-
-    const auto size = JSStringGetMaximumUTF8CStringSize(js_string_ref__);
-    auto buffer = new char[size];
-    JSStringGetUTF8CString(js_string_ref__, buffer, size);
-    string__ = std::string(buffer);
-    delete[] buffer;
-    
-    std::hash<std::string> hash_function = std::hash<std::string>();
-    hash_value__ = hash_function(static_cast<std::string>(string__));
   }
   
   bool operator==(const JSString& lhs, const JSString& rhs) {
@@ -0,0 +1,73 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/JSStringBuilder.hpp"
+#include "HAL/JSContext.hpp"
+#include "HAL/JSValue.hpp"
+
+#include "HAL/detail/UTFUtilities.hpp"
+
+#include <cstring>
+
+namespace HAL {
+  
+  JSStringBuilder::JSStringBuilder(std::size_t capacity) {
+    buffer__.reserve(capacity);
+  }
+  
+  JSStringBuilder& JSStringBuilder::Append(const char* string) {
+    return Append(string, std::strlen(string));
+  }
+  
+  JSStringBuilder& JSStringBuilder::Append(const char* string, std::size_t length) {
+    // A UTF-16 string never has more code units than its UTF-8
+    // equivalent has bytes.
+    const auto size = buffer__.size();
+    buffer__.resize(size + length);
+    std::size_t utf16_length = 0;
+    if (detail::UTF8ToUTF16(string, length, buffer__.data() + size, utf16_length)) {
+      buffer__.resize(size + utf16_length);
+      return *this;
+    }
+    
+    // Let JavaScriptCore decide what malformed UTF-8 means.
+    buffer__.resize(size);
+    return Append(JSString(string, length));
+  }
+  
+  JSStringBuilder& JSStringBuilder::Append(const std::string& string) {
+    return Append(string.data(), string.size());
+  }
+  
+  JSStringBuilder& JSStringBuilder::Append(const JSChar* string, std::size_t length) {
+    buffer__.insert(buffer__.end(), string, string + length);
+    return *this;
+  }
+  
+  JSStringBuilder& JSStringBuilder::Append(const JSString& js_string) {
+    // A moved-from JSString is empty.
+    const auto js_string_ref = static_cast<JSStringRef>(js_string);
+    if (!js_string_ref) {
+      return *this;
+    }
+    return Append(JSStringGetCharactersPtr(js_string_ref), JSStringGetLength(js_string_ref));
+  }
+  
+  JSString JSStringBuilder::ToJSString() const HAL_NOEXCEPT {
+    if (buffer__.empty()) {
+      return JSString();
+    }
+    
+    return JSString(buffer__.data(), buffer__.size());
+  }
+  
+  JSValue JSStringBuilder::ToJSValue(const JSContext& js_context) const HAL_NOEXCEPT {
+    return js_context.CreateString(ToJSString());
+  }
+  
+} // namespace HAL {
@@ -26,17 +26,87 @@
 #include "HAL/JSClass.hpp"
 
 #include "HAL/detail/JSUtil.hpp"
+#include "HAL/detail/UTFUtilities.hpp"
 
 #include <sstream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
 
 namespace HAL {
   
+  namespace {
+    
+    // The buffer size FormatPrimitive needs, which is enough for
+    // "undefined", "-Infinity" and any integer below 2^53.
+    const std::size_t kPrimitiveBufferSize = 32;
+    
+    std::size_t CopyLiteral(const char* literal, char* buffer) HAL_NOEXCEPT {
+      const auto length = std::strlen(literal);
+      std::memcpy(buffer, literal, length);
+      return length;
+    }
+    
+    // Format the given number the way JavaScript's String() would, if
+    // its formatting is unambiguous. Return false otherwise.
+    bool FormatNumber(double number, char* buffer, std::size_t& length) HAL_NOEXCEPT {
+      if (std::isnan(number)) {
+        length = CopyLiteral("NaN", buffer);
+        return true;
+      }
+      
+      if (std::isinf(number)) {
+        length = CopyLiteral(number > 0 ? "Infinity" : "-Infinity", buffer);
+        return true;
+      }
+      
+      // Integers below 2^53 are exact, so their shortest
+      // representation is all of their digits. This also turns -0 into
+      // "0", as JavaScript does.
+      if (number == std::floor(number) && std::fabs(number) < 9007199254740992.0) {
+        length = static_cast<std::size_t>(std::snprintf(buffer, kPrimitiveBufferSize, "%lld", static_cast<long long>(number)));
+        return true;
+      }
+      
+      return false;
+    }
+    
+    // Format the given value the way JavaScript's String() would,
+    // without asking JavaScriptCore for a string, if it is a primitive
+    // whose formatting is unambiguous. Return false otherwise, e.g.
+    // for 0.1, whose shortest round-trip representation HAL doesn't
+    // compute.
+    bool FormatPrimitive(JSContextRef js_context_ref, JSValueRef js_value_ref, char* buffer, std::size_t& length) HAL_NOEXCEPT {
+      switch (JSValueGetType(js_context_ref, js_value_ref)) {
+        case kJSTypeUndefined:
+          length = CopyLiteral("undefined", buffer);
+          return true;
+          
+        case kJSTypeNull:
+          length = CopyLiteral("null", buffer);
+          return true;
+          
+        case kJSTypeBoolean:
+          length = CopyLiteral(JSValueToBoolean(js_context_ref, js_value_ref) ? "true" : "false", buffer);
+          return true;
+          
+        case kJSTypeNumber:
+          return FormatNumber(JSValueToNumber(js_context_ref, js_value_ref, nullptr), buffer, length);
+          
+        default:
+          return false;
+      }
+    }
+    
+  } // namespace {
+  
   
   JSString JSValue::ToJSONString(unsigned indent) {
     HAL_JSVALUE_LOCK_GUARD;
     JSValueRef exception { nullptr };
-    JSStringRef js_string_ref = JSValueCreateJSONString(static_cast<JSContextRef>(js_context__), js_value_ref__, indent, &exception);
+    JSStringRef js_string_ref = JSValueCreateJSONString(static_cast<JSContextRef>(js_context__), GetJSValueRef(), indent, &exception);
     if (exception) {
       // If this assert fails then we need to JSStringRelease
       // js_string_ref.
@@ -56,7 +126,7 @@ namespace HAL {
   JSValue::operator JSString() const {
     HAL_JSVALUE_LOCK_GUARD;
     JSValueRef exception { nullptr };
-    JSStringRef js_string_ref = JSValueToStringCopy(static_cast<JSContextRef>(js_context__), js_value_ref__, &exception);
+    JSStringRef js_string_ref = JSValueToStringCopy(static_cast<JSContextRef>(js_context__), GetJSValueRef(), &exception);
     if (exception) {
       // If this assert fails then we need to JSStringRelease
       // js_string_ref.
@@ -72,18 +142,98 @@ namespace HAL {
   }
   
   JSValue::operator std::string() const {
-    return operator JSString();
+    std::string string;
+    AppendUTF8To(string);
+    return string;
+  }
+  
+  std::size_t JSValue::ToUTF8(char* buffer, std::size_t buffer_size) const {
+    HAL_JSVALUE_LOCK_GUARD;
+    if (buffer_size == 0) {
+      return 0;
+    }
+    
+    char primitive_buffer[kPrimitiveBufferSize];
+    std::size_t length = 0;
+    double number = 0;
+    const bool is_formatted = LoadDeferredNumber(number) ? FormatNumber(number, primitive_buffer, length) : FormatPrimitive(static_cast<JSContextRef>(js_context__), GetJSValueRef(), primitive_buffer, length);
+    if (is_formatted) {
+      // The result is ASCII so it can be truncated anywhere.
+      length = std::min(length, buffer_size - 1);
+      std::memcpy(buffer, primitive_buffer, length);
+      buffer[length] = '\0';
+      return length;
+    }
+    
+    return operator JSString().CopyUTF8To(buffer, buffer_size);
+  }
+  
+  void JSValue::AppendUTF8To(std::string& string) const {
+    WriteUTF8([](void* context, const char* data, std::size_t size) {
+      static_cast<std::string*>(context) -> append(data, size);
+    }, &string);
+  }
+  
+  void JSValue::WriteUTF8(void (*write)(void* context, const char* data, std::size_t size), void* context) const {
+    HAL_JSVALUE_LOCK_GUARD;
+    char buffer[1024];
+    std::size_t length = 0;
+    double number = 0;
+    const bool is_formatted = LoadDeferredNumber(number) ? FormatNumber(number, buffer, length) : FormatPrimitive(static_cast<JSContextRef>(js_context__), GetJSValueRef(), buffer, length);
+    if (is_formatted) {
+      write(context, buffer, length);
+      return;
+    }
+    
+    const auto js_string = operator JSString();
+    const auto js_string_ref = static_cast<JSStringRef>(js_string);
+    const JSChar* characters = JSStringGetCharactersPtr(js_string_ref);
+    const std::size_t characters_length = JSStringGetLength(js_string_ref);
+    std::size_t utf8_length = 0;
+    if (!detail::GetUTF8Length(characters, characters_length, utf8_length)) {
+      // Let JavaScriptCore decide what unpaired surrogates mean.
+      const auto string = static_cast<std::string>(js_string);
+      write(context, string.data(), string.size());
+      return;
+    }
+    
+    // Convert in pieces that fit in buffer, without splitting
+    // surrogate pairs. No UTF-16 code unit takes more than three UTF-8
+    // bytes.
+    const std::size_t max_chunk_length = sizeof(buffer) / 3;
+    std::size_t position = 0;
+    while (position < characters_length) {
+      std::size_t chunk_length = std::min(max_chunk_length, characters_length - position);
+      if (position + chunk_length < characters_length && characters[position + chunk_length - 1] >= 0xD800 && characters[position + chunk_length - 1] <= 0xDBFF) {
+        --chunk_length;
+      }
+      
+      detail::GetUTF8Length(characters + position, chunk_length, utf8_length);
+      detail::UTF16ToUTF8(characters + position, chunk_length, buffer);
+      write(context, buffer, utf8_length);
+      position += chunk_length;
+    }
   }
   
   JSValue::operator bool() const HAL_NOEXCEPT {
     HAL_JSVALUE_LOCK_GUARD;
-    return JSValueToBoolean(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    double number = 0;
+    if (LoadDeferredNumber(number)) {
+      return number != 0 && !std::isnan(number);
+    }
+    
+    return JSValueToBoolean(static_cast<JSContextRef>(js_context__), GetJSValueRef());
   }
   
   JSValue::operator double() const {
     HAL_JSVALUE_LOCK_GUARD;
+    double number = 0;
+    if (LoadDeferredNumber(number)) {
+      return number;
+    }
+    
     JSValueRef exception { nullptr };
-    const double result = JSValueToNumber(static_cast<JSContextRef>(js_context__), js_value_ref__, &exception);
+    const double result = JSValueToNumber(static_cast<JSContextRef>(js_context__), GetJSValueRef(), &exception);
     
     if (exception) {
       detail::ThrowRuntimeError("JSValue", JSValue(js_context__, exception));
@@ -99,7 +249,7 @@ namespace HAL {
   JSValue::operator JSObject() const {
     HAL_JSVALUE_LOCK_GUARD;
     JSValueRef exception { nullptr };
-    JSObjectRef js_object_ref = JSValueToObject(static_cast<JSContextRef>(js_context__), js_value_ref__, &exception);
+    JSObjectRef js_object_ref = JSValueToObject(static_cast<JSContextRef>(js_context__), GetJSValueRef(), &exception);
     
     if (exception) {
       // If this assert fails then we need to JSValueUnprotect
@@ -112,10 +262,10 @@ namespace HAL {
     return JSObject(js_context__, js_object_ref);
   }
   
-  JSValue::Type JSValue::GetType() const HAL_NOEXCEPT {
+  JSValue::Type JSValue::QueryType() const HAL_NOEXCEPT {
     HAL_JSVALUE_LOCK_GUARD;
     auto type = Type::Undefined;
-    const JSType js_type = JSValueGetType(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    const JSType js_type = JSValueGetType(static_cast<JSContextRef>(js_context__), GetJSValueRef());
     switch (js_type) {
       case kJSTypeUndefined:
         type = Type::Undefined;
@@ -142,53 +292,24 @@ namespace HAL {
         break;
     }
 
+    type__.store(static_cast<std::uint8_t>(type), std::memory_order_relaxed);
     return type;
   }
   
-  bool JSValue::IsUndefined() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsUndefined(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-  
-  bool JSValue::IsNull() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsNull(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-	
   bool JSValue::IsNativeNull() const HAL_NOEXCEPT {
     HAL_JSVALUE_LOCK_GUARD;
     return is_native_nullptr__;
   }
 	
-  bool JSValue::IsBoolean() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsBoolean(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-
-  bool JSValue::IsNumber() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsNumber(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-  
-  bool JSValue::IsString() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsString(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-  
-  bool JSValue::IsObject() const HAL_NOEXCEPT {
-    HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsObject(static_cast<JSContextRef>(js_context__), js_value_ref__);
-  }
-  
   bool JSValue::IsObjectOfClass(const JSClass& js_class) const HAL_NOEXCEPT {
     HAL_JSVALUE_LOCK_GUARD;
-    return JSValueIsObjectOfClass(static_cast<JSContextRef>(js_context__), js_value_ref__, static_cast<JSClassRef>(js_class));
+    return JSValueIsObjectOfClass(static_cast<JSContextRef>(js_context__), GetJSValueRef(), static_cast<JSClassRef>(js_class));
   }
   
   bool JSValue::IsInstanceOfConstructor(const JSObject& constructor) const {
     HAL_JSVALUE_LOCK_GUARD;
     JSValueRef exception { nullptr };
-    const bool result = JSValueIsInstanceOfConstructor(static_cast<JSContextRef>(js_context__), js_value_ref__, static_cast<JSObjectRef>(constructor), &exception);
+    const bool result = JSValueIsInstanceOfConstructor(static_cast<JSContextRef>(js_context__), GetJSValueRef(), static_cast<JSObjectRef>(constructor), &exception);
     if (exception) {
       detail::ThrowRuntimeError("JSValue", JSValue(js_context__, exception));
     }
@@ -199,7 +320,7 @@ namespace HAL {
   bool JSValue::IsEqualWithTypeCoercion(const JSValue& rhs) const {
     HAL_JSVALUE_LOCK_GUARD;
     JSValueRef exception { nullptr };
-    const bool result = JSValueIsEqual(static_cast<JSContextRef>(js_context__), js_value_ref__, rhs.js_value_ref__, &exception);
+    const bool result = JSValueIsEqual(static_cast<JSContextRef>(js_context__), GetJSValueRef(), rhs.GetJSValueRef(), &exception);
     if (exception) {
       detail::ThrowRuntimeError("JSValue", JSValue(js_context__, exception));
     }
@@ -213,34 +334,71 @@ namespace HAL {
   
   JSValue::~JSValue() HAL_NOEXCEPT {
     HAL_LOG_TRACE("JSValue:: dtor ", this);
-    HAL_LOG_TRACE("JSValue:: release ", js_value_ref__, " for ", this);
-    JSValueUnprotect(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    // A moved-from JSValue no longer protects a JSValueRef, a cached
+    // one never did, and a deferred one only does once it made one.
+    if (deferred_state__.load(std::memory_order_acquire) != kNotDeferred) {
+      return;
+    }
+    
+    const JSValueRef js_value_ref = js_value_ref__.load(std::memory_order_relaxed);
+    if (js_value_ref && !is_cached__) {
+      HAL_LOG_TRACE("JSValue:: release ", js_value_ref, " for ", this);
+      JSValueUnprotect(static_cast<JSContextRef>(js_context__), js_value_ref);
+      HAL_PERFORMANCE_COUNTER_RELEASE(JSValue);
+    }
   }
   
   JSValue::JSValue(const JSValue& rhs) HAL_NOEXCEPT
   : js_context__(rhs.js_context__)
-  , js_value_ref__(rhs.js_value_ref__)
-  , is_native_nullptr__(rhs.is_native_nullptr__) {
+  , is_native_nullptr__(rhs.is_native_nullptr__)
+  , is_cached__(rhs.is_cached__)
+  , type__(rhs.type__.load(std::memory_order_relaxed)) {
     HAL_LOG_TRACE("JSValue:: copy ctor ", this);
-    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    // A copy of a deferred JSValue makes its own JSValueRef if it
+    // needs one.
+    double number = 0;
+    if (rhs.LoadDeferredNumber(number)) {
+      number__.store(number, std::memory_order_relaxed);
+      deferred_state__.store(kDeferred, std::memory_order_relaxed);
+      return;
+    }
+    
+    const JSValueRef js_value_ref = rhs.js_value_ref__.load(std::memory_order_relaxed);
+    js_value_ref__.store(js_value_ref, std::memory_order_relaxed);
+    if (js_value_ref && !is_cached__) {
+      HAL_LOG_TRACE("JSValue:: retain ", js_value_ref, " for ", this);
+      JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref);
+      HAL_PERFORMANCE_COUNTER_RETAIN(JSValue);
+    }
   }
   
   JSValue::JSValue(JSValue&& rhs) HAL_NOEXCEPT
   : js_context__(std::move(rhs.js_context__))
-  , js_value_ref__(rhs.js_value_ref__)
-  , is_native_nullptr__(rhs.is_native_nullptr__){
+  , is_native_nullptr__(rhs.is_native_nullptr__)
+  , is_cached__(rhs.is_cached__)
+  , deferred_state__(rhs.deferred_state__.load(std::memory_order_acquire))
+  , type__(rhs.type__.load(std::memory_order_relaxed)) {
     HAL_LOG_TRACE("JSValue:: move ctor ", this);
-    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    // Take over rhs's protection of its JSValueRef instead of
+    // protecting it again. No other thread may use rhs while it is
+    // moved from, so it can't be publishing a JSValueRef.
+    if (deferred_state__ == kDeferred) {
+      number__.store(rhs.number__.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    } else {
+      js_value_ref__.store(rhs.js_value_ref__.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    
+    rhs.deferred_state__.store(kNotDeferred, std::memory_order_relaxed);
+    rhs.js_value_ref__.store(nullptr, std::memory_order_relaxed);
   }
   
   JSValue& JSValue::operator=(JSValue rhs) {
     HAL_JSVALUE_LOCK_GUARD;
     HAL_LOG_TRACE("JSValue:: copy assignment ", this);
     // JSValues can only be copied between contexts within the same
-    // context group.
-    if (js_context__.get_context_group() != rhs.js_context__.get_context_group()) {
+    // context group, but a moved-from JSValue may be assigned anything
+    // and be assigned to anything.
+    if (js_context__.get_context_group_ref() && rhs.js_context__.get_context_group_ref() && js_context__.get_context_group_ref() != rhs.js_context__.get_context_group_ref()) {
       detail::ThrowRuntimeError("JSValue", "JSValues must belong to JSContexts within the same JSContextGroup to be shared and exchanged.");
     }
     
@@ -256,24 +414,49 @@ namespace HAL {
     // By swapping the members of two classes, the two classes are
     // effectively swapped.
     swap(js_context__  , other.js_context__);
-    swap(js_value_ref__, other.js_value_ref__);
+    
+    // Like moving, swapping must not race with publishing a deferred
+    // number's JSValueRef.
+    const auto deferred_state       = deferred_state__.load(std::memory_order_acquire);
+    const auto other_deferred_state = other.deferred_state__.load(std::memory_order_acquire);
+    const double     number             = number__.load(std::memory_order_relaxed);
+    const JSValueRef js_value_ref       = js_value_ref__.load(std::memory_order_relaxed);
+    if (other_deferred_state == kDeferred) {
+      number__.store(other.number__.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    } else {
+      js_value_ref__.store(other.js_value_ref__.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    if (deferred_state == kDeferred) {
+      other.number__.store(number, std::memory_order_relaxed);
+    } else {
+      other.js_value_ref__.store(js_value_ref, std::memory_order_relaxed);
+    }
+    deferred_state__.store(other_deferred_state, std::memory_order_release);
+    other.deferred_state__.store(deferred_state, std::memory_order_release);
+    
     swap(is_native_nullptr__, other.is_native_nullptr__);
+    swap(is_cached__, other.is_cached__);
+    type__ = other.type__.exchange(type__.load(std::memory_order_relaxed), std::memory_order_relaxed);
   }
   
   JSValue::JSValue(const JSContext& js_context, const JSString& js_string, bool parse_as_json)
   : js_context__(js_context) {
     HAL_LOG_TRACE("JSValue:: ctor 1 ", this);
+    JSValueRef js_value_ref { nullptr };
     if (parse_as_json) {
-      js_value_ref__ = JSValueMakeFromJSONString(static_cast<JSContextRef>(js_context), static_cast<JSStringRef>(js_string));
-      if (!js_value_ref__) {
+      js_value_ref = JSValueMakeFromJSONString(static_cast<JSContextRef>(js_context), static_cast<JSStringRef>(js_string));
+      if (!js_value_ref) {
         const std::string message = "Input is not a valid JSON string: " + to_string(js_string);
         detail::ThrowRuntimeError("JSValue", message);
       }
     } else {
-      js_value_ref__ = JSValueMakeString(static_cast<JSContextRef>(js_context__), static_cast<JSStringRef>(js_string));
+      js_value_ref = JSValueMakeString(static_cast<JSContextRef>(js_context__), static_cast<JSStringRef>(js_string));
+      type__ = static_cast<std::uint8_t>(Type::String);
     }
-    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref, " for ", this);
+    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSValue);
+    js_value_ref__.store(js_value_ref, std::memory_order_relaxed);
   }
 	
   // For interoperability with the JavaScriptCore C API.
@@ -281,9 +464,78 @@ namespace HAL {
   : js_context__(js_context)
   , js_value_ref__(js_value_ref)  {
     HAL_LOG_TRACE("JSValue:: ctor 2 ", this);
-    assert(js_value_ref__);
-    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref__, " for ", this);
-    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref__);
+    assert(js_value_ref);
+    HAL_LOG_TRACE("JSValue:: retain ", js_value_ref, " for ", this);
+    JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSValue);
+  }
+  
+  JSValue::JSValue(const JSContext& js_context, JSValueRef cached_js_value_ref, Type type) HAL_NOEXCEPT
+  : js_context__(js_context)
+  , is_cached__(true)
+  , type__(static_cast<std::uint8_t>(type))
+  , js_value_ref__(cached_js_value_ref) {
+    HAL_LOG_TRACE("JSValue:: ctor 3 ", this);
+    assert(cached_js_value_ref);
+  }
+  
+  JSValue::JSValue(const JSContext& js_context, double number, Deferred) HAL_NOEXCEPT
+  : js_context__(js_context)
+  , deferred_state__(kDeferred)
+  , type__(static_cast<std::uint8_t>(Type::Number)) {
+    HAL_LOG_TRACE("JSValue:: ctor 4 ", this);
+    number__.store(number, std::memory_order_relaxed);
+  }
+  
+  bool JSValue::LoadDeferredNumber(double& number) const HAL_NOEXCEPT {
+    while (true) {
+      const auto deferred_state = deferred_state__.load(std::memory_order_acquire);
+      if (deferred_state == kNotDeferred) {
+        return false;
+      }
+      
+      if (deferred_state == kDeferred) {
+        number = number__.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (deferred_state__.load(std::memory_order_relaxed) == kDeferred) {
+          return true;
+        }
+      }
+      
+      // Another thread is replacing the number with its JSValueRef,
+      // which only takes two stores.
+      std::this_thread::yield();
+    }
+  }
+  
+  JSValueRef JSValue::MakeDeferredJSValueRef() const HAL_NOEXCEPT {
+    double number = 0;
+    if (LoadDeferredNumber(number)) {
+      const JSValueRef js_value_ref = JSValueMakeNumber(static_cast<JSContextRef>(js_context__), number);
+      HAL_LOG_TRACE("JSValue:: retain ", js_value_ref, " for ", this);
+      JSValueProtect(static_cast<JSContextRef>(js_context__), js_value_ref);
+      
+      std::uint8_t expected = kDeferred;
+      if (deferred_state__.compare_exchange_strong(expected, kPublishing, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        // Order the state change before overwriting the number, for
+        // the threads reading the number.
+        std::atomic_thread_fence(std::memory_order_release);
+        js_value_ref__.store(js_value_ref, std::memory_order_relaxed);
+        deferred_state__.store(kNotDeferred, std::memory_order_release);
+        HAL_PERFORMANCE_COUNTER_RETAIN(JSValue);
+        return js_value_ref;
+      }
+      
+      // Another thread made one first, so use its JSValueRef and drop
+      // this one.
+      HAL_LOG_TRACE("JSValue:: release ", js_value_ref, " for ", this);
+      JSValueUnprotect(static_cast<JSContextRef>(js_context__), js_value_ref);
+      while (LoadDeferredNumber(number)) {
+        std::this_thread::yield();
+      }
+    }
+    
+    return js_value_ref__.load(std::memory_order_relaxed);
   }
   
   std::string to_string(const JSValue::Type& js_value_type) HAL_NOEXCEPT {
@@ -312,6 +564,13 @@ namespace HAL {
   }
   
   bool operator==(const JSValue& lhs, const JSValue& rhs) HAL_NOEXCEPT {
+    // Two numbers are strict equal if they are equal as doubles.
+    double lhs_number = 0;
+    double rhs_number = 0;
+    if (lhs.LoadDeferredNumber(lhs_number) && rhs.LoadDeferredNumber(rhs_number)) {
+      return lhs_number == rhs_number;
+    }
+    
     return JSValueIsStrictEqual(static_cast<JSContextRef>(lhs.get_context()), static_cast<JSValueRef>(lhs), static_cast<JSValueRef>(rhs));
   }
   
@@ -0,0 +1,390 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/detail/JSContextLifetime.hpp"
+#include "HAL/detail/JSExportConstantsCache.hpp"
+#include "HAL/JSString.hpp"
+#include "HAL/JSFunction.hpp"
+
+#include <cassert>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HAL {
+  class JSContext;
+}
+
+namespace HAL { namespace detail {
+
+  namespace {
+    // The JSContextLifetime of every global context HAL refers to.
+    //
+    // Unlike the per-object mutexes this one is not conditional on
+    // HAL_THREAD_SAFE: contexts living on different threads share this
+    // map even when none of their objects are shared.
+    std::unordered_map<JSGlobalContextRef, JSContextLifetime*>& GetJSContextLifetimeMap() {
+      static std::unordered_map<JSGlobalContextRef, JSContextLifetime*> js_context_lifetime_map;
+      return js_context_lifetime_map;
+    }
+
+    // The JSContextLifetimes that no longer refer to a global context,
+    // ready for reuse. Also protected by the map mutex.
+    std::vector<JSContextLifetime*>& GetFreeJSContextLifetimes() {
+      static std::vector<JSContextLifetime*> free_js_context_lifetimes;
+      return free_js_context_lifetimes;
+    }
+
+    std::mutex& GetJSContextLifetimeMapMutex() {
+      static std::mutex js_context_lifetime_map_mutex;
+      return js_context_lifetime_map_mutex;
+    }
+
+    // The global context and JSContextLifetime this thread acquired
+    // last. The entry doesn't own a reference, and the
+    // JSContextLifetime may have been reused for another global context
+    // since, so it must be checked with TryRetain.
+    struct JSContextLifetimeCacheEntry {
+      JSGlobalContextRef js_global_context_ref;
+      JSContextLifetime* js_context_lifetime;
+    };
+
+    HAL_THREAD_LOCAL JSContextLifetimeCacheEntry js_context_lifetime_cache_entry { nullptr, nullptr };
+
+    const std::int64_t kSmallIntegerCount = (HAL_JSNUMBER_CACHE_MAX >= HAL_JSNUMBER_CACHE_MIN) ? (static_cast<std::int64_t>(HAL_JSNUMBER_CACHE_MAX) - HAL_JSNUMBER_CACHE_MIN + 1) : 0;
+  }
+
+  JSContextLifetime* JSContextLifetime::Acquire(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT {
+    // precondition
+    assert(js_global_context_ref);
+
+    // Callbacks keep wrapping the same global context, so this is
+    // almost always a hit.
+    auto& cache_entry = js_context_lifetime_cache_entry;
+    if (cache_entry.js_global_context_ref == js_global_context_ref && cache_entry.js_context_lifetime -> TryRetain(js_global_context_ref)) {
+      return cache_entry.js_context_lifetime;
+    }
+
+    const auto js_context_lifetime = AcquireLocked(js_global_context_ref);
+    cache_entry.js_global_context_ref = js_global_context_ref;
+    cache_entry.js_context_lifetime   = js_context_lifetime;
+    return js_context_lifetime;
+  }
+
+  JSContextLifetime* JSContextLifetime::AcquireLocked(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT {
+    auto& js_context_lifetime_map   = GetJSContextLifetimeMap();
+    auto& free_js_context_lifetimes = GetFreeJSContextLifetimes();
+    JSContextLifetime* js_context_lifetime { nullptr };
+    {
+      std::lock_guard<std::mutex> lock(GetJSContextLifetimeMapMutex());
+      const auto position = js_context_lifetime_map.find(js_global_context_ref);
+      if (position != js_context_lifetime_map.end()) {
+        position -> second -> Retain();
+        return position -> second;
+      }
+
+      if (!free_js_context_lifetimes.empty()) {
+        js_context_lifetime = free_js_context_lifetimes.back();
+        free_js_context_lifetimes.pop_back();
+      }
+    }
+
+    // Never call into JavaScriptCore while holding the lock, since
+    // JavaScriptCore may be running a callback on another thread that
+    // is waiting for it.
+    if (!js_context_lifetime) {
+      js_context_lifetime = new JSContextLifetime();
+    }
+
+    js_context_lifetime -> Initialize(js_global_context_ref);
+
+    JSContextLifetime* existing_js_context_lifetime { nullptr };
+    {
+      std::lock_guard<std::mutex> lock(GetJSContextLifetimeMapMutex());
+      const auto result = js_context_lifetime_map.emplace(js_global_context_ref, js_context_lifetime);
+      if (result.second) {
+        // Only now may another thread's TryRetain succeed.
+        js_context_lifetime -> reference_count__.store(1, std::memory_order_release);
+        return js_context_lifetime;
+      }
+
+      // Another thread got here first.
+      existing_js_context_lifetime = result.first -> second;
+      existing_js_context_lifetime -> Retain();
+    }
+
+    js_context_lifetime -> Finalize();
+    {
+      std::lock_guard<std::mutex> lock(GetJSContextLifetimeMapMutex());
+      free_js_context_lifetimes.push_back(js_context_lifetime);
+    }
+
+    return existing_js_context_lifetime;
+  }
+
+  bool JSContextLifetime::TryRetain(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT {
+    // A JSContextLifetime whose count dropped to zero is being
+    // finalized or waiting for reuse, so it must not be revived.
+    auto reference_count = reference_count__.load(std::memory_order_relaxed);
+    do {
+      if (reference_count == 0) {
+        return false;
+      }
+    } while (!reference_count__.compare_exchange_weak(reference_count, reference_count + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+    // It may have been reused for another global context since this
+    // thread last saw it.
+    if (js_global_context_ref__ != js_global_context_ref) {
+      Release();
+      return false;
+    }
+
+    return true;
+  }
+
+  void JSContextLifetime::Release() HAL_NOEXCEPT {
+    // Dropping a reference other than the last one doesn't need the
+    // lock.
+    auto reference_count = reference_count__.load(std::memory_order_relaxed);
+    while (reference_count > 1) {
+      if (reference_count__.compare_exchange_weak(reference_count, reference_count - 1, std::memory_order_release, std::memory_order_relaxed)) {
+        ReleaseCallbacks(reference_count - 1);
+        return;
+      }
+    }
+
+    // This may be the last reference, so synchronize with Acquire,
+    // which may be about to hand out another one.
+    {
+      std::lock_guard<std::mutex> lock(GetJSContextLifetimeMapMutex());
+      reference_count = --reference_count__;
+      if (reference_count == 0) {
+        GetJSContextLifetimeMap().erase(js_global_context_ref__);
+      }
+    }
+
+    if (reference_count != 0) {
+      ReleaseCallbacks(reference_count);
+      return;
+    }
+
+    // Releasing the global context may run finalizers that release
+    // other JSContextLifetimes, so it must happen outside the lock.
+    Finalize();
+
+    {
+      std::lock_guard<std::mutex> lock(GetJSContextLifetimeMapMutex());
+      GetFreeJSContextLifetimes().push_back(this);
+    }
+
+    // Releasing the global context may have finalized native
+    // functions.
+    JSFunction::DestroyFinalizedCallbacks();
+  }
+
+  void JSContextLifetime::ReleaseCallbacks(std::size_t reference_count) HAL_NOEXCEPT {
+    // If only native function callbacks still refer to this context
+    // then nothing else can call them.
+    if (reference_count == callback_reference_count__.load(std::memory_order_acquire)) {
+      JSFunction::DetachCallbacks(this);
+    }
+
+    JSFunction::DestroyFinalizedCallbacks();
+  }
+
+  JSObjectRef JSContextLifetime::GetArrayIsArray() HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!array_is_array__) {
+      static const auto& array_property_name    = JSString::Intern("Array");
+      static const auto& is_array_property_name = JSString::Intern("isArray");
+      const JSObjectRef array = GetIntrinsic(JSContextGetGlobalObject(js_global_context_ref__), array_property_name);
+      if (array) {
+        array_is_array__ = GetIntrinsic(array, is_array_property_name);
+        JSValueUnprotect(js_global_context_ref__, array);
+      }
+    }
+
+    return array_is_array__;
+  }
+
+  JSObjectRef JSContextLifetime::GetErrorConstructor() HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!error_constructor__) {
+      static const auto& error_property_name = JSString::Intern("Error");
+      error_constructor__ = GetIntrinsic(JSContextGetGlobalObject(js_global_context_ref__), error_property_name);
+    }
+
+    return error_constructor__;
+  }
+
+  JSObjectRef JSContextLifetime::GetFunctionPrototype() HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!function_prototype__) {
+      static const auto& function_property_name  = JSString::Intern("Function");
+      static const auto& prototype_property_name = JSString::Intern("prototype");
+      const JSObjectRef function = GetIntrinsic(JSContextGetGlobalObject(js_global_context_ref__), function_property_name);
+      if (function) {
+        function_prototype__ = GetIntrinsic(function, prototype_property_name);
+        JSValueUnprotect(js_global_context_ref__, function);
+      }
+    }
+
+    return function_prototype__;
+  }
+
+  JSValueRef JSContextLifetime::GetUndefined() HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!undefined__) {
+      undefined__ = Protect(JSValueMakeUndefined(js_global_context_ref__));
+    }
+
+    return undefined__;
+  }
+
+  JSValueRef JSContextLifetime::GetNull() HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!null__) {
+      null__ = Protect(JSValueMakeNull(js_global_context_ref__));
+    }
+
+    return null__;
+  }
+
+  JSValueRef JSContextLifetime::GetBoolean(bool boolean) HAL_NOEXCEPT {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    auto& js_value_ref = boolean ? true__ : false__;
+    if (!js_value_ref) {
+      js_value_ref = Protect(JSValueMakeBoolean(js_global_context_ref__, boolean));
+    }
+
+    return js_value_ref;
+  }
+
+  JSValueRef JSContextLifetime::GetSmallInteger(std::int64_t number) HAL_NOEXCEPT {
+    if (number < HAL_JSNUMBER_CACHE_MIN || number > HAL_JSNUMBER_CACHE_MAX) {
+      return nullptr;
+    }
+
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    if (!small_integers__) {
+      small_integers__.reset(new JSValueRef[kSmallIntegerCount]());
+    }
+
+    auto& js_value_ref = small_integers__[number - HAL_JSNUMBER_CACHE_MIN];
+    if (!js_value_ref) {
+      js_value_ref = Protect(JSValueMakeNumber(js_global_context_ref__, static_cast<double>(number)));
+    }
+
+    return js_value_ref;
+  }
+
+  JSExportConstantsCache& JSContextLifetime::GetJSExportConstantsCache(std::type_index type_index, std::uint32_t capacity) {
+    HAL_DETAIL_JSCONTEXTLIFETIME_LOCK_GUARD;
+    auto& js_export_constants_cache = js_export_constants_caches__[type_index];
+    if (!js_export_constants_cache) {
+      js_export_constants_cache.reset(new JSExportConstantsCache(js_global_context_ref__, capacity));
+    }
+
+    return *js_export_constants_cache;
+  }
+
+  JSObjectRef JSContextLifetime::GetIntrinsic(JSObjectRef js_object_ref, const JSString& property_name) HAL_NOEXCEPT {
+    JSValueRef exception { nullptr };
+    JSValueRef js_value_ref = JSObjectGetProperty(js_global_context_ref__, js_object_ref, static_cast<JSStringRef>(property_name), &exception);
+
+    if (exception || !JSValueIsObject(js_global_context_ref__, js_value_ref)) {
+      return nullptr;
+    }
+
+    JSObjectRef intrinsic_ref = JSValueToObject(js_global_context_ref__, js_value_ref, nullptr);
+    JSValueProtect(js_global_context_ref__, intrinsic_ref);
+    return intrinsic_ref;
+  }
+
+  JSValueRef JSContextLifetime::Protect(JSValueRef js_value_ref) HAL_NOEXCEPT {
+    JSValueProtect(js_global_context_ref__, js_value_ref);
+    return js_value_ref;
+  }
+
+  JSContextLifetime::JSContextLifetime() HAL_NOEXCEPT {
+    HAL_LOG_TRACE("JSContextLifetime:: ctor ", this);
+  }
+
+  // Never called, since JSContextLifetimes are reused instead of
+  // deleted.
+  JSContextLifetime::~JSContextLifetime() HAL_NOEXCEPT {
+    HAL_LOG_TRACE("JSContextLifetime:: dtor ", this);
+  }
+
+  void JSContextLifetime::Initialize(JSGlobalContextRef js_global_context_ref) HAL_NOEXCEPT {
+    // precondition
+    assert(reference_count__ == 0);
+
+    js_global_context_ref__ = js_global_context_ref;
+    js_context_group_ref__  = JSContextGetGroup(js_global_context_ref);
+    HAL_LOG_TRACE("JSContextLifetime:: retain ", js_global_context_ref__, " for ", this);
+    JSGlobalContextRetain(js_global_context_ref__);
+    HAL_PERFORMANCE_COUNTER_RETAIN(JSContext);
+  }
+
+  void JSContextLifetime::Finalize() HAL_NOEXCEPT {
+    // precondition
+    assert(reference_count__ == 0);
+
+    // The callbacks still registered captured no reference to this
+    // context, so they may keep running while JavaScript refers to
+    // their functions, but they must not be counted against whichever
+    // context reuses this JSContextLifetime.
+    JSFunction::ForgetCallbacks(this);
+    callback_reference_count__ = 0;
+
+    if (array_is_array__) {
+      JSValueUnprotect(js_global_context_ref__, array_is_array__);
+      array_is_array__ = nullptr;
+    }
+
+    if (error_constructor__) {
+      JSValueUnprotect(js_global_context_ref__, error_constructor__);
+      error_constructor__ = nullptr;
+    }
+
+    if (function_prototype__) {
+      JSValueUnprotect(js_global_context_ref__, function_prototype__);
+      function_prototype__ = nullptr;
+    }
+
+    // The caches unprotect their values, which requires the global
+    // context.
+    js_export_constants_caches__.clear();
+
+    for (auto js_value_ref : { &undefined__, &null__, &true__, &false__ }) {
+      if (*js_value_ref) {
+        JSValueUnprotect(js_global_context_ref__, *js_value_ref);
+        *js_value_ref = nullptr;
+      }
+    }
+
+    if (small_integers__) {
+      for (std::int64_t i = 0; i < kSmallIntegerCount; ++i) {
+        if (small_integers__[i]) {
+          JSValueUnprotect(js_global_context_ref__, small_integers__[i]);
+          small_integers__[i] = nullptr;
+        }
+      }
+    }
+
+    HAL_LOG_TRACE("JSContextLifetime:: release ", js_global_context_ref__, " for ", this);
+    JSGlobalContextRelease(js_global_context_ref__);
+    HAL_PERFORMANCE_COUNTER_RELEASE(JSContext);
+
+    js_global_context_ref__ = nullptr;
+    js_context_group_ref__  = nullptr;
+  }
+
+}} // namespace HAL { namespace detail {
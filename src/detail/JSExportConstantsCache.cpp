@@ -0,0 +1,102 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/detail/JSExportConstantsCache.hpp"
+
+#include <algorithm>
+
+namespace HAL { namespace detail {
+
+  JSExportConstantsCache::JSExportConstantsCache(JSGlobalContextRef js_global_context_ref, std::uint32_t capacity) HAL_NOEXCEPT
+  : js_global_context_ref__(js_global_context_ref)
+  , capacity__(capacity) {
+  }
+
+  JSExportConstantsCache::~JSExportConstantsCache() HAL_NOEXCEPT {
+    Clear();
+    for (const auto prototype_ref : prototypes__) {
+      JSValueUnprotect(js_global_context_ref__, prototype_ref);
+    }
+  }
+
+  JSValueRef JSExportConstantsCache::Find(const std::string& property_name) HAL_NOEXCEPT {
+    const auto position = index__.find(property_name);
+    if (position == index__.end()) {
+      ++statistics__.misses;
+      return nullptr;
+    }
+
+    ++statistics__.hits;
+    entries__.splice(entries__.begin(), entries__, position -> second);
+    return position -> second -> second;
+  }
+
+  void JSExportConstantsCache::Insert(const std::string& property_name, JSValueRef js_value_ref) {
+    // A constant's getter may itself have cached it, in which case the
+    // first value wins.
+    if (capacity__ == 0 || index__.find(property_name) != index__.end()) {
+      return;
+    }
+
+    if (entries__.size() >= capacity__) {
+      EvictLeastRecentlyUsed();
+    }
+
+    JSValueProtect(js_global_context_ref__, js_value_ref);
+    entries__.emplace_front(property_name, js_value_ref);
+    index__.emplace(property_name, entries__.begin());
+  }
+
+  void JSExportConstantsCache::EvictLeastRecentlyUsed() HAL_NOEXCEPT {
+    if (entries__.empty()) {
+      return;
+    }
+
+    ++statistics__.evictions;
+    const auto& entry = entries__.back();
+    JSValueUnprotect(js_global_context_ref__, entry.second);
+    index__.erase(entry.first);
+    entries__.pop_back();
+  }
+
+  void JSExportConstantsCache::Clear() HAL_NOEXCEPT {
+    for (const auto& entry : entries__) {
+      JSValueUnprotect(js_global_context_ref__, entry.second);
+    }
+
+    index__.clear();
+    entries__.clear();
+  }
+
+  void JSExportConstantsCache::Resize(std::uint32_t capacity) HAL_NOEXCEPT {
+    Clear();
+    capacity__ = capacity;
+  }
+
+  bool JSExportConstantsCache::IsInstalledOn(JSObjectRef prototype_ref) const HAL_NOEXCEPT {
+    return std::find(prototypes__.begin(), prototypes__.end(), prototype_ref) != prototypes__.end();
+  }
+
+  void JSExportConstantsCache::SetInstalledOn(JSObjectRef prototype_ref) {
+    if (!IsInstalledOn(prototype_ref)) {
+      JSValueProtect(js_global_context_ref__, prototype_ref);
+      prototypes__.push_back(prototype_ref);
+    }
+  }
+
+  std::vector<std::string> JSExportConstantsCache::GetKeys() const {
+    std::vector<std::string> keys;
+    keys.reserve(entries__.size());
+    for (const auto& entry : entries__) {
+      keys.push_back(entry.first);
+    }
+
+    return keys;
+  }
+
+}} // namespace HAL { namespace detail {
@@ -17,20 +17,91 @@
 #include <sstream>
 #include <stdexcept>
 #include <iterator>
+#include <mutex>
 
 #include <JavaScriptCore/JavaScript.h>
 
 
 namespace HAL { namespace detail {
 
-  js_runtime_error::js_runtime_error(const JSError& js_error) : std::runtime_error(js_error.message()) {
-    js_name__       = js_error.name();
-    js_filename__   = js_error.filename();
-    js_linenumber__ = js_error.linenumber();
-    js_stack__      = js_error.stack();
-    js_message__    = js_error.message();
+  namespace {
+    // Read the Error's message, or an empty string if its message
+    // getter throws.
+    std::string GetMessage(const JSError& js_error) HAL_NOEXCEPT {
+      try {
+        return js_error.message();
+      } catch (...) {
+        return "";
+      }
+    }
   }
-
+  
+  struct js_runtime_error::Fields {
+    Fields(const JSError& js_error_, const std::string& source_url_, int line_number_)
+    : js_error(js_error_)
+    , source_url(source_url_)
+    , line_number(line_number_) {
+    }
+    
+    const JSError     js_error;
+    const std::string source_url;
+    const int         line_number;
+    
+    // Each property is read at most once, even if the exception is
+    // inspected from several threads.
+    std::once_flag       name_flag;
+    std::string          name;
+    std::once_flag       filename_flag;
+    std::string          filename;
+    std::once_flag       linenumber_flag;
+    std::uint32_t        linenumber { 0 };
+    std::once_flag       stack_flag;
+    std::vector<JSValue> stack;
+  };
+  
+  js_runtime_error::js_runtime_error(const JSError& js_error, const std::string& source_url, int line_number)
+  : std::runtime_error(GetMessage(js_error))
+  , fields__(std::make_shared<Fields>(js_error, source_url, line_number)) {
+  }
+  
+  JSValue js_runtime_error::js_error() const HAL_NOEXCEPT {
+    return fields__ -> js_error;
+  }
+  
+  std::string js_runtime_error::js_name() const {
+    std::call_once(fields__ -> name_flag, [this] { fields__ -> name = fields__ -> js_error.name(); });
+    return fields__ -> name;
+  }
+  
+  std::string js_runtime_error::js_message() const {
+    return what();
+  }
+  
+  std::string js_runtime_error::js_filename() const {
+    std::call_once(fields__ -> filename_flag, [this] {
+      // Mozilla-like detailed property to help debug.
+      static const auto& filename_property_name = JSString::Intern("fileName");
+      const auto js_value = fields__ -> js_error.GetProperty(filename_property_name);
+      fields__ -> filename = js_value.IsUndefined() ? fields__ -> source_url : static_cast<std::string>(js_value);
+    });
+    return fields__ -> filename;
+  }
+  
+  std::uint32_t js_runtime_error::js_linenumber() const {
+    std::call_once(fields__ -> linenumber_flag, [this] {
+      // Mozilla-like detailed property to help debug.
+      static const auto& linenumber_property_name = JSString::Intern("lineNumber");
+      const auto js_value = fields__ -> js_error.GetProperty(linenumber_property_name);
+      fields__ -> linenumber = js_value.IsUndefined() ? static_cast<std::uint32_t>(fields__ -> line_number) : static_cast<std::uint32_t>(js_value);
+    });
+    return fields__ -> linenumber;
+  }
+  
+  std::vector<JSValue> js_runtime_error::js_stack() const {
+    std::call_once(fields__ -> stack_flag, [this] { fields__ -> stack = fields__ -> js_error.stack(); });
+    return fields__ -> stack;
+  }
+  
   void ThrowRuntimeError(const std::string& internal_component_name, const std::string& message) {
     HAL_LOG_ERROR(internal_component_name, ": ", message);
     throw std::runtime_error(message);
@@ -41,18 +112,9 @@ namespace HAL { namespace detail {
     if (exception.IsObject()) {
       const auto js_exception = static_cast<JSObject>(exception);
       if (js_exception.IsError()) {
-        const auto js_context = js_exception.get_context();
-        auto js_error = static_cast<JSError>(js_exception);
-				
-        // Mozilla-like detailed properties to help debug
-        if (!js_error.HasProperty("fileName")) {
-            js_error.SetProperty("fileName", js_context.CreateString(source_url));
-        }
-        if (!js_error.HasProperty("lineNumber")) {
-          js_error.SetProperty("lineNumber", js_context.CreateNumber(line_number));
-        }	
-	
-        throw js_runtime_error(js_error);
+        // Only the Error's message is read now. Its other properties
+        // are read if the catcher asks for them.
+        throw js_runtime_error(static_cast<JSError>(js_exception), source_url, line_number);
       }
     }
 
@@ -0,0 +1,263 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/detail/UTFUtilities.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAL_DETAIL_UTF_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAL_DETAIL_UTF_NEON
+#include <arm_neon.h>
+#endif
+
+namespace HAL { namespace detail {
+
+  namespace {
+
+    static_assert(sizeof(JSChar) == sizeof(std::uint16_t), "JSChar must be a UTF-16 code unit");
+
+    const std::size_t kBlockSize = 16;
+
+    // If the block of kBlockSize bytes at utf8 is all ASCII then widen
+    // it into utf16 and return true.
+    inline bool WidenASCIIBlock(const char* utf8, JSChar* utf16) HAL_NOEXCEPT {
+#if defined(HAL_DETAIL_UTF_SSE2)
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8));
+      if (_mm_movemask_epi8(bytes) != 0) {
+        return false;
+      }
+      const __m128i zero = _mm_setzero_si128();
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16)    , _mm_unpacklo_epi8(bytes, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16 + 8), _mm_unpackhi_epi8(bytes, zero));
+      return true;
+#elif defined(HAL_DETAIL_UTF_NEON)
+      const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const std::uint8_t*>(utf8));
+      const uint64x2_t high_bits = vreinterpretq_u64_u8(vandq_u8(bytes, vdupq_n_u8(0x80)));
+      if ((vgetq_lane_u64(high_bits, 0) | vgetq_lane_u64(high_bits, 1)) != 0) {
+        return false;
+      }
+      vst1q_u16(reinterpret_cast<std::uint16_t*>(utf16)    , vmovl_u8(vget_low_u8(bytes)));
+      vst1q_u16(reinterpret_cast<std::uint16_t*>(utf16 + 8), vmovl_u8(vget_high_u8(bytes)));
+      return true;
+#else
+      for (std::size_t i = 0; i < kBlockSize; ++i) {
+        if (static_cast<unsigned char>(utf8[i]) >= 0x80) {
+          return false;
+        }
+      }
+      for (std::size_t i = 0; i < kBlockSize; ++i) {
+        utf16[i] = static_cast<unsigned char>(utf8[i]);
+      }
+      return true;
+#endif
+    }
+
+    // If the block of kBlockSize code units at utf16 is all ASCII then
+    // return true, narrowing it into utf8 if utf8 is not null.
+    inline bool NarrowASCIIBlock(const JSChar* utf16, char* utf8) HAL_NOEXCEPT {
+#if defined(HAL_DETAIL_UTF_SSE2)
+      const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16));
+      const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16 + 8));
+      const __m128i non_ascii = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(static_cast<short>(0xFF80)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+      }
+      if (utf8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(utf8), _mm_packus_epi16(low, high));
+      }
+      return true;
+#elif defined(HAL_DETAIL_UTF_NEON)
+      const uint16x8_t low  = vld1q_u16(reinterpret_cast<const std::uint16_t*>(utf16));
+      const uint16x8_t high = vld1q_u16(reinterpret_cast<const std::uint16_t*>(utf16 + 8));
+      const uint64x2_t non_ascii = vreinterpretq_u64_u16(vandq_u16(vorrq_u16(low, high), vdupq_n_u16(0xFF80)));
+      if ((vgetq_lane_u64(non_ascii, 0) | vgetq_lane_u64(non_ascii, 1)) != 0) {
+        return false;
+      }
+      if (utf8) {
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(utf8), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+      }
+      return true;
+#else
+      for (std::size_t i = 0; i < kBlockSize; ++i) {
+        if (utf16[i] >= 0x80) {
+          return false;
+        }
+      }
+      if (utf8) {
+        for (std::size_t i = 0; i < kBlockSize; ++i) {
+          utf8[i] = static_cast<char>(utf16[i]);
+        }
+      }
+      return true;
+#endif
+    }
+
+    inline bool IsContinuationByte(unsigned char byte) HAL_NOEXCEPT {
+      return (byte & 0xC0) == 0x80;
+    }
+
+    inline bool IsHighSurrogate(std::uint32_t code_unit) HAL_NOEXCEPT {
+      return code_unit >= 0xD800 && code_unit <= 0xDBFF;
+    }
+
+    inline bool IsLowSurrogate(std::uint32_t code_unit) HAL_NOEXCEPT {
+      return code_unit >= 0xDC00 && code_unit <= 0xDFFF;
+    }
+
+    // Decode the multi-byte sequence starting at utf8[i], following
+    // Table 3-7 "Well-Formed UTF-8 Byte Sequences" of the Unicode
+    // Standard. Return the number of bytes consumed, or 0 if the
+    // sequence is malformed.
+    std::size_t DecodeUTF8Sequence(const unsigned char* utf8, std::size_t i, std::size_t length, std::uint32_t& code_point) HAL_NOEXCEPT {
+      const unsigned char lead = utf8[i];
+      std::size_t sequence_length = 0;
+      unsigned char lower = 0x80;
+      unsigned char upper = 0xBF;
+      if (lead >= 0xC2 && lead <= 0xDF) {
+        sequence_length = 2;
+        code_point = lead & 0x1F;
+      } else if (lead >= 0xE0 && lead <= 0xEF) {
+        sequence_length = 3;
+        code_point = lead & 0x0F;
+        lower = (lead == 0xE0) ? 0xA0 : 0x80;
+        upper = (lead == 0xED) ? 0x9F : 0xBF;
+      } else if (lead >= 0xF0 && lead <= 0xF4) {
+        sequence_length = 4;
+        code_point = lead & 0x07;
+        lower = (lead == 0xF0) ? 0x90 : 0x80;
+        upper = (lead == 0xF4) ? 0x8F : 0xBF;
+      } else {
+        return 0;
+      }
+
+      if (length - i < sequence_length) {
+        return 0;
+      }
+
+      const unsigned char second = utf8[i + 1];
+      if (second < lower || second > upper) {
+        return 0;
+      }
+      code_point = (code_point << 6) | (second & 0x3F);
+
+      for (std::size_t j = 2; j < sequence_length; ++j) {
+        const unsigned char byte = utf8[i + j];
+        if (!IsContinuationByte(byte)) {
+          return 0;
+        }
+        code_point = (code_point << 6) | (byte & 0x3F);
+      }
+
+      return sequence_length;
+    }
+
+  } // namespace {
+
+  bool UTF8ToUTF16(const char* utf8, std::size_t length, JSChar* utf16, std::size_t& utf16_length) HAL_NOEXCEPT {
+    const auto bytes = reinterpret_cast<const unsigned char*>(utf8);
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < length) {
+      if (length - i >= kBlockSize && WidenASCIIBlock(utf8 + i, utf16 + j)) {
+        i += kBlockSize;
+        j += kBlockSize;
+        continue;
+      }
+
+      if (bytes[i] < 0x80) {
+        utf16[j++] = bytes[i++];
+        continue;
+      }
+
+      std::uint32_t code_point = 0;
+      const auto sequence_length = DecodeUTF8Sequence(bytes, i, length, code_point);
+      if (sequence_length == 0) {
+        return false;
+      }
+      i += sequence_length;
+
+      if (code_point < 0x10000) {
+        utf16[j++] = static_cast<JSChar>(code_point);
+      } else {
+        code_point -= 0x10000;
+        utf16[j++] = static_cast<JSChar>(0xD800 + (code_point >> 10));
+        utf16[j++] = static_cast<JSChar>(0xDC00 + (code_point & 0x3FF));
+      }
+    }
+
+    utf16_length = j;
+    return true;
+  }
+
+  bool GetUTF8Length(const JSChar* utf16, std::size_t length, std::size_t& utf8_length) HAL_NOEXCEPT {
+    std::size_t result = 0;
+    std::size_t i = 0;
+    while (i < length) {
+      if (length - i >= kBlockSize && NarrowASCIIBlock(utf16 + i, nullptr)) {
+        i      += kBlockSize;
+        result += kBlockSize;
+        continue;
+      }
+
+      const std::uint32_t code_unit = utf16[i];
+      if (code_unit < 0x80) {
+        result += 1;
+      } else if (code_unit < 0x800) {
+        result += 2;
+      } else if (IsHighSurrogate(code_unit)) {
+        if (i + 1 == length || !IsLowSurrogate(utf16[i + 1])) {
+          return false;
+        }
+        result += 4;
+        ++i;
+      } else if (IsLowSurrogate(code_unit)) {
+        return false;
+      } else {
+        result += 3;
+      }
+      ++i;
+    }
+
+    utf8_length = result;
+    return true;
+  }
+
+  void UTF16ToUTF8(const JSChar* utf16, std::size_t length, char* utf8) HAL_NOEXCEPT {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < length) {
+      if (length - i >= kBlockSize && NarrowASCIIBlock(utf16 + i, utf8 + j)) {
+        i += kBlockSize;
+        j += kBlockSize;
+        continue;
+      }
+
+      std::uint32_t code_point = utf16[i++];
+      if (code_point < 0x80) {
+        utf8[j++] = static_cast<char>(code_point);
+      } else if (code_point < 0x800) {
+        utf8[j++] = static_cast<char>(0xC0 | (code_point >> 6));
+        utf8[j++] = static_cast<char>(0x80 | (code_point & 0x3F));
+      } else if (IsHighSurrogate(code_point)) {
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (utf16[i++] - 0xDC00);
+        utf8[j++] = static_cast<char>(0xF0 | (code_point >> 18));
+        utf8[j++] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        utf8[j++] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        utf8[j++] = static_cast<char>(0x80 | (code_point & 0x3F));
+      } else {
+        utf8[j++] = static_cast<char>(0xE0 | (code_point >> 12));
+        utf8[j++] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        utf8[j++] = static_cast<char>(0x80 | (code_point & 0x3F));
+      }
+    }
+  }
+
+}} // namespace HAL { namespace detail {
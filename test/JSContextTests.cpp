@@ -9,8 +9,10 @@
 #include "HAL/HAL.hpp"
 
 #include "gtest/gtest.h"
+#include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #define XCTAssertEqual    ASSERT_EQ
 #define XCTAssertNotEqual ASSERT_NE
@@ -77,6 +79,35 @@ TEST_F(JSContextTests, JSEvaluateScriptWithError) {
   }
 }
 
+TEST_F(JSContextTests, JSRuntimeErrorIsLazy) {
+  JSContext js_context = js_context_group.CreateContext();
+  js_context.JSEvaluateScript("var reads = 0; var error = new Error('boom'); Object.defineProperty(error, 'name', { get: function() { ++reads; return 'CustomError'; } }); var message_reads = 0; Object.defineProperty(error, 'message', { get: function() { ++message_reads; return 'boom'; } });");
+  try {
+    js_context.JSEvaluateScript("throw error;", "app.js", 7);
+    XCTAssertTrue(false);
+  } catch (const HAL::detail::js_runtime_error& e) {
+    // Only the message is read up front. Nothing else is read from the
+    // Error until it is asked for, and then only once.
+    XCTAssertEqual(1, static_cast<std::int32_t>(js_context.JSEvaluateScript("message_reads")));
+    XCTAssertEqual(0, static_cast<std::int32_t>(js_context.JSEvaluateScript("reads")));
+    XCTAssertEqual("CustomError", e.js_name());
+    XCTAssertEqual("CustomError", e.js_name());
+    XCTAssertEqual(1, static_cast<std::int32_t>(js_context.JSEvaluateScript("reads")));
+    
+    XCTAssertEqual("boom", std::string(e.what()));
+    XCTAssertEqual("boom", e.js_message());
+    XCTAssertEqual(1, static_cast<std::int32_t>(js_context.JSEvaluateScript("message_reads")));
+    XCTAssertEqual("app.js", e.js_filename());
+    XCTAssertEqual(7, e.js_linenumber());
+    XCTAssertTrue(e.js_error() == js_context.JSEvaluateScript("error"));
+    
+    // The Error itself is left untouched.
+    XCTAssertFalse(static_cast<bool>(js_context.JSEvaluateScript("error.hasOwnProperty('fileName') || error.hasOwnProperty('lineNumber')")));
+  } catch (...) {
+    XCTAssertTrue(false);
+  }
+}
+
 TEST_F(JSContextTests, JSContext) {
   JSContext js_context_1 = js_context_group.CreateContext();
   JSContext js_context_2 = js_context_group.CreateContext();
@@ -117,3 +148,106 @@ TEST_F(JSContextTests, JSContext) {
   JSContext js_context_12 = js_context_7;
   XCTAssertEqual(js_context_7, js_context_12);
 }
+
+TEST_F(JSContextTests, Move) {
+  JSContextGroup js_context_group_1;
+  JSContext js_context_1 = js_context_group_1.CreateContext();
+  JSClass   js_class_1;
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_context_group_refs_retained = detail::JSPerformanceCounter<JSContextGroup>::get_refs_retained();
+  const auto js_context_group_refs_released = detail::JSPerformanceCounter<JSContextGroup>::get_refs_released();
+  const auto js_context_refs_retained       = detail::JSPerformanceCounter<JSContext>::get_refs_retained();
+  const auto js_context_refs_released       = detail::JSPerformanceCounter<JSContext>::get_refs_released();
+  const auto js_class_refs_retained         = detail::JSPerformanceCounter<JSClass>::get_refs_retained();
+  const auto js_class_refs_released         = detail::JSPerformanceCounter<JSClass>::get_refs_released();
+#endif
+  
+  JSContextGroup js_context_group_2(std::move(js_context_group_1));
+  js_context_group_1 = std::move(js_context_group_2);
+  
+  JSContext js_context_2(std::move(js_context_1));
+  js_context_1 = std::move(js_context_2);
+  
+  JSClass js_class_2(std::move(js_class_1));
+  js_class_1 = std::move(js_class_2);
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(js_context_group_refs_retained, detail::JSPerformanceCounter<JSContextGroup>::get_refs_retained());
+  XCTAssertEqual(js_context_group_refs_released, detail::JSPerformanceCounter<JSContextGroup>::get_refs_released());
+  XCTAssertEqual(js_context_refs_retained      , detail::JSPerformanceCounter<JSContext>::get_refs_retained());
+  XCTAssertEqual(js_context_refs_released      , detail::JSPerformanceCounter<JSContext>::get_refs_released());
+  XCTAssertEqual(js_class_refs_retained        , detail::JSPerformanceCounter<JSClass>::get_refs_retained());
+  XCTAssertEqual(js_class_refs_released        , detail::JSPerformanceCounter<JSClass>::get_refs_released());
+#endif
+  
+  XCTAssertEqual(js_context_group_1, js_context_1.get_context_group());
+  XCTAssertEqual(3, static_cast<int32_t>(js_context_1.JSEvaluateScript("1 + 2")));
+  XCTAssertEqual("Empty", js_class_1.get_name());
+}
+
+TEST_F(JSContextTests, JSContextLifetime) {
+  JSContext js_context = js_context_group.CreateContext();
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto refs_retained = detail::JSPerformanceCounter<JSContext>::get_refs_retained();
+  const auto refs_released = detail::JSPerformanceCounter<JSContext>::get_refs_released();
+#endif
+  
+  {
+    // Copying a JSValue, or wrapping a JSContextRef from JavaScriptCore,
+    // shares the existing JSContextLifetime instead of retaining the
+    // global context again.
+    JSValue js_value = js_context.CreateNumber(42);
+    JSValue js_value_copy = js_value;
+    JSContext js_context_copy(static_cast<JSContextRef>(js_context));
+    XCTAssertEqual(js_context, js_context_copy);
+    XCTAssertEqual(js_context, js_value_copy.get_context());
+  }
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(refs_retained, detail::JSPerformanceCounter<JSContext>::get_refs_retained());
+  XCTAssertEqual(refs_released, detail::JSPerformanceCounter<JSContext>::get_refs_released());
+#endif
+  
+  // The global context outlives the JSContext that created a value.
+  JSValue js_value = js_context_group.CreateContext().CreateString("hello");
+  XCTAssertEqual("hello", static_cast<std::string>(js_value));
+}
+
+TEST_F(JSContextTests, JSContextLifetimeReuse) {
+  JSContextRef js_context_ref_1 = nullptr;
+  {
+    JSContext js_context_1 = js_context_group.CreateContext();
+    js_context_ref_1 = static_cast<JSContextRef>(js_context_1);
+    JSContext js_context_copy(js_context_ref_1);
+    XCTAssertEqual(js_context_1, js_context_copy);
+  }
+  
+  // This thread still remembers the released context's
+  // JSContextLifetime, which may now belong to the new context.
+  JSContext js_context_2 = js_context_group.CreateContext();
+  JSContext js_context_copy(static_cast<JSContextRef>(js_context_2));
+  XCTAssertEqual(js_context_2, js_context_copy);
+  XCTAssertEqual(3, static_cast<int32_t>(js_context_copy.JSEvaluateScript("1 + 2")));
+  
+  // Wrapping the same JSContextRef on several threads at once yields
+  // the same JSContext on each of them.
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches { 0 };
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&js_context_2, &mismatches] {
+      for (int j = 0; j < 1000; ++j) {
+        if (JSContext(static_cast<JSContextRef>(js_context_2)) != js_context_2) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  
+  XCTAssertEqual(0, mismatches);
+}
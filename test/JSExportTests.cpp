@@ -10,6 +10,7 @@
 #include "Widget.hpp"
 #include "ChildWidget.hpp"
 #include "OtherWidget.hpp"
+#include "ConstantWidget.hpp"
 #include <functional>
 
 #include "gtest/gtest.h"
@@ -72,6 +73,12 @@ TEST_F(JSExportTests, JSExportClassDefinitionBuilder) {
   ;
   
   auto native_class = builder.build();
+  
+  // Properties named at compile time share the names of the others.
+  ASSERT_THROW(builder.AddValueProperty("name", HAL_EXPORT_METHOD(&Widget::js_get_name)), std::invalid_argument);
+  ASSERT_THROW(builder.AddFunctionProperty("sayhello", HAL_EXPORT_METHOD(&Widget::js_sayHello)), std::invalid_argument);
+  builder.AddFunctionProperty("testArguments", HAL_EXPORT_METHOD(&Widget::js_testArguments));
+  ASSERT_THROW(builder.AddFunctionProperty("testArguments", std::mem_fn(&Widget::js_testArguments)), std::invalid_argument);
 }
 
 TEST_F(JSExportTests, JSExport) {
@@ -205,6 +212,46 @@ TEST_F(JSExportTests, JSExportPrototypeChain) {
   result = js_context.JSEvaluateScript("ChildWidget.my_name;");
   XCTAssertTrue(result.IsString());
   XCTAssertEqual("child widget", static_cast<std::string>(result));
+
+  // my_name is bound with HAL_EXPORT_METHOD.
+  result = js_context.JSEvaluateScript("ChildWidget.my_name = 'renamed'; ChildWidget.my_name = 42; ChildWidget.my_name;");
+  XCTAssertEqual("renamed", static_cast<std::string>(result));
+  result = js_context.JSEvaluateScript("delete ChildWidget.my_name; ChildWidget.my_name;");
+  XCTAssertEqual("renamed", static_cast<std::string>(result));
+}
+
+TEST_F(JSExportTests, JSExportTypedMethod) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject global_object = js_context.get_global_object();
+  
+  JSObject widget = js_context.CreateObject(JSExport<ChildWidget>::Class());
+  global_object.SetProperty("ChildWidget", widget);
+  
+  // scale_factor is a double, and scale takes (double, int32_t, const std::string&).
+  auto result = js_context.JSEvaluateScript("ChildWidget.scale_factor;");
+  XCTAssertTrue(result.IsNumber());
+  XCTAssertEqual(1, static_cast<double>(result));
+  
+  result = js_context.JSEvaluateScript("ChildWidget.scale_factor = 2.5; ChildWidget.scale_factor;");
+  XCTAssertEqual(2.5, static_cast<double>(result));
+  
+  result = js_context.JSEvaluateScript("ChildWidget.scale(4, 3, 'px');");
+  XCTAssertTrue(result.IsNumber());
+  XCTAssertEqual(30, static_cast<double>(result));
+  
+  result = js_context.JSEvaluateScript("ChildWidget.scale(4, 3.9, '%', 'ignored');");
+  XCTAssertEqual(0.3, static_cast<double>(result));
+  
+  // Arity and type errors are thrown as JavaScript exceptions.
+  result = js_context.JSEvaluateScript("try { ChildWidget.scale(4, 3); 'no exception'; } catch (e) { e.message; }");
+  XCTAssertEqual("expected 3 arguments but got 2", static_cast<std::string>(result));
+  
+  result = js_context.JSEvaluateScript("try { ChildWidget.scale(4, '3', 'px'); 'no exception'; } catch (e) { e.message; }");
+  XCTAssertEqual("argument 1 is not a number", static_cast<std::string>(result));
+  
+  result = js_context.JSEvaluateScript("try { ChildWidget.scale_factor = 'big'; 'no exception'; } catch (e) { e.message; }");
+  XCTAssertEqual("value is not a number", static_cast<std::string>(result));
+  XCTAssertEqual(2.5, static_cast<double>(js_context.JSEvaluateScript("ChildWidget.scale_factor;")));
 }
 
 TEST_F(JSExportTests, JSExportGetPrivate) {
@@ -293,6 +340,19 @@ TEST_F(JSExportTests, CallAsFunction) {
   XCTAssertEqual("Hello, bar. Your number is 42.", static_cast<std::string>(hello));
 }
 
+TEST_F(JSExportTests, JSArguments) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject global_object = js_context.get_global_object();
+  
+  JSObject widget = js_context.CreateObject(JSExport<Widget>::Class());
+  global_object.SetProperty("widget", widget);
+  
+  XCTAssertEqual("0:none:42:true", static_cast<std::string>(js_context.JSEvaluateScript("widget.testArguments();")));
+  XCTAssertEqual("1:foo:42:true", static_cast<std::string>(js_context.JSEvaluateScript("widget.testArguments('foo');")));
+  XCTAssertEqual("3:none:7:false", static_cast<std::string>(js_context.JSEvaluateScript("widget.testArguments(undefined, '7.5', 0);")));
+  XCTAssertEqual("4:null:-1:true", static_cast<std::string>(js_context.JSEvaluateScript("widget.testArguments(null, -1, 'true', 'extra');")));
+}
+
 /*
  * Call new Widget('baz', 999).sayHello() through operator()
  */
@@ -1176,6 +1236,10 @@ TEST_F(JSExportTests, JSExportFindObjectFromPrivateData) {
   auto result = js_context.JSEvaluateScript("Widget === jsobject;");
   XCTAssertTrue(result.IsBoolean());
   XCTAssertTrue(static_cast<bool>(result));
+
+  // Untyped private data still finds its JavaScript object.
+  void* private_data = static_cast<JSExportObject*>(widget_ptr.get());
+  XCTAssertEqual(widget, JSObject::FindJSObjectFromPrivateData(js_context, private_data));
 }
 
 TEST_F(JSExportTests, JSExportFindObjectFromPrivateDataForCallAsConstructor) {
@@ -1231,6 +1295,22 @@ TEST_F(JSExportTests, JSExportFindObjectFromPrivateDataGetObject) {
 
 }
 
+TEST_F(JSExportTests, JSExportGetObject) {
+  JSContext js_context = js_context_group.CreateContext();
+  
+  JSObject widget = js_context.CreateObject(JSExport<Widget>::Class());
+  auto widget_ptr = widget.GetPrivate<Widget>();
+  XCTAssertNotEqual(nullptr, widget_ptr);
+  XCTAssertTrue(widget_ptr->get_object() == widget);
+  
+  // A copy of a native object is not owned by the JavaScript object.
+  Widget widget_copy(*widget_ptr);
+  XCTAssertTrue(widget_copy.get_object().IsError());
+  
+  Widget native_widget(js_context);
+  XCTAssertTrue(native_widget.get_object().IsError());
+}
+
 TEST_F(JSExportTests, JSExportPostConstruct) {
   JSContext js_context = js_context_group.CreateContext();
   JSObject global_object = js_context.get_global_object();
@@ -1351,7 +1431,7 @@ TEST_F(JSExportTests, LRUCache) {
   
   // Cache only 3 entries for testing. Note that this also cleans cache
   HAL::detail::JSExportClass<OtherWidget>::ResizeCache(3);
-  auto keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  auto keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
 
   XCTAssertTrue(keys.empty());
 
@@ -1361,7 +1441,7 @@ TEST_F(JSExportTests, LRUCache) {
   XCTAssertTrue(result.IsNumber());
   XCTAssertEqual(1, static_cast<std::uint32_t>(result));
 
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(1, keys.size());
   XCTAssertEqual("CONST1", keys.at(0));
 
@@ -1369,7 +1449,7 @@ TEST_F(JSExportTests, LRUCache) {
   XCTAssertTrue(result.IsNumber());
   XCTAssertEqual(2, static_cast<std::uint32_t>(result));
 
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(2, keys.size());
   XCTAssertEqual("CONST2", keys.at(0));
   XCTAssertEqual("CONST1", keys.at(1));
@@ -1378,7 +1458,7 @@ TEST_F(JSExportTests, LRUCache) {
   XCTAssertTrue(result.IsNumber());
   XCTAssertEqual(3, static_cast<std::uint32_t>(result));
 
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(3, keys.size());
   XCTAssertEqual("CONST3", keys.at(0));
   XCTAssertEqual("CONST2", keys.at(1));
@@ -1389,7 +1469,7 @@ TEST_F(JSExportTests, LRUCache) {
   XCTAssertEqual(4, static_cast<std::uint32_t>(result));
 
   // Make sure least-recently-used key is evicted.
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(3, keys.size());
   XCTAssertEqual("CONST4", keys.at(0));
   XCTAssertEqual("CONST3", keys.at(1));
@@ -1399,22 +1479,84 @@ TEST_F(JSExportTests, LRUCache) {
   XCTAssertTrue(result.IsNumber());
   XCTAssertEqual(3, static_cast<std::uint32_t>(result));
 
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(3, keys.size());
   XCTAssertEqual("CONST3", keys.at(0));
   XCTAssertEqual("CONST4", keys.at(1));
   XCTAssertEqual("CONST2", keys.at(2));
 
   // evict least-recently used one
-  HAL::detail::JSExportClass<OtherWidget>::EvictCache();
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  HAL::detail::JSExportClass<OtherWidget>::EvictCache(js_context);
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertEqual(2, keys.size());
   XCTAssertEqual("CONST3", keys.at(0));
   XCTAssertEqual("CONST4", keys.at(1));
 
+  auto statistics = HAL::detail::JSExportClass<OtherWidget>::GetCacheStatistics(js_context);
+  XCTAssertEqual(1, statistics.hits);
+  XCTAssertEqual(4, statistics.misses);
+  XCTAssertEqual(2, statistics.evictions);
+
+  // Every context has its own cache.
+  auto other_js_context = js_context_group.CreateContext();
+  other_js_context.get_global_object().SetProperty("Widget", other_js_context.CreateObject(widgetClass));
+  result = other_js_context.JSEvaluateScript("Widget.CONST1;");
+  XCTAssertEqual(1, static_cast<std::uint32_t>(result));
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(other_js_context);
+  XCTAssertEqual(1, keys.size());
+  XCTAssertEqual("CONST1", keys.at(0));
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
+  XCTAssertEqual(2, keys.size());
+
+  // evict all of one context
+  JSExport<OtherWidget>::EvictAllCache(other_js_context);
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(other_js_context);
+  XCTAssertTrue(keys.empty());
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
+  XCTAssertEqual(2, keys.size());
+
   // evict all
   JSExport<OtherWidget>::EvictAllCache();
-  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys();
+  keys = HAL::detail::JSExportClass<OtherWidget>::GetCachedKeys(js_context);
   XCTAssertTrue(keys.empty());
 }
 
+TEST_F(JSExportTests, ConstantsInPrototype) {
+  auto js_context = js_context_group.CreateContext();
+  auto global_object = js_context.get_global_object();
+  const auto count = ConstantWidget::get_count_for_constants();
+
+  // The constants are read once, when the first object is created.
+  global_object.SetProperty("Widget", js_context.CreateObject(JSExport<ConstantWidget>::Class()));
+  XCTAssertEqual(count + 2, ConstantWidget::get_count_for_constants());
+
+  auto result = js_context.JSEvaluateScript("Widget.ANSWER + Widget.ANSWER;");
+  XCTAssertEqual(84, static_cast<std::int32_t>(result));
+  result = js_context.JSEvaluateScript("Widget.NAME;");
+  XCTAssertEqual("constant widget", static_cast<std::string>(result));
+  XCTAssertEqual(count + 2, ConstantWidget::get_count_for_constants());
+  XCTAssertTrue(HAL::detail::JSExportClass<ConstantWidget>::GetCachedKeys(js_context).empty());
+
+  // They are plain data properties of the prototype, with the
+  // attributes of the constant properties.
+  result = js_context.JSEvaluateScript("Widget.hasOwnProperty('ANSWER');");
+  XCTAssertFalse(static_cast<bool>(result));
+  result = js_context.JSEvaluateScript("var d = Object.getOwnPropertyDescriptor(Object.getPrototypeOf(Widget), 'ANSWER'); d.value === 42 && !d.writable && !d.configurable && d.enumerable;");
+  XCTAssertTrue(static_cast<bool>(result));
+  result = js_context.JSEvaluateScript("Object.getOwnPropertyDescriptor(Object.getPrototypeOf(Widget), 'NAME').enumerable;");
+  XCTAssertFalse(static_cast<bool>(result));
+  result = js_context.JSEvaluateScript("Widget.ANSWER = 0; delete Object.getPrototypeOf(Widget).ANSWER; Widget.ANSWER;");
+  XCTAssertEqual(42, static_cast<std::int32_t>(result));
+
+  // Objects created later in the same context share them.
+  auto other_widget = js_context.CreateObject(JSExport<ConstantWidget>::Class());
+  XCTAssertEqual(42, static_cast<std::int32_t>(other_widget.GetProperty("ANSWER")));
+  XCTAssertEqual(count + 2, ConstantWidget::get_count_for_constants());
+
+  // Every context installs its own.
+  auto other_js_context = js_context_group.CreateContext();
+  auto another_widget = other_js_context.CreateObject(JSExport<ConstantWidget>::Class());
+  XCTAssertEqual(count + 4, ConstantWidget::get_count_for_constants());
+  XCTAssertEqual("constant widget", static_cast<std::string>(another_widget.GetProperty("NAME")));
+}
+
@@ -34,7 +34,10 @@ class JSObjectTests : public testing::Test {
 
 TEST_F(JSObjectTests, ObjectSizes) {
   XCTAssertEqual(sizeof(std::intptr_t)  + sizeof(std::intptr_t), sizeof(JSContextGroup));
-  XCTAssertEqual(sizeof(JSContextGroup) + sizeof(std::intptr_t), sizeof(JSContext));
+  
+  // A JSContext is only a pointer to its global context's
+  // JSContextLifetime.
+  XCTAssertEqual(sizeof(std::intptr_t), sizeof(JSContext));
   
   // JSValue and JSObject are base classes, so have an extra pointer for the
   // virtual function table.
@@ -474,6 +477,35 @@ TEST_F(JSObjectTests, JSError) {
   JSError js_error = js_context.CreateError();
   XCTAssertFalse(js_error.IsArray());
   XCTAssertTrue(js_error.IsError());
+  XCTAssertEqual("Error", js_error.name());
+  XCTAssertEqual("", js_error.filename());
+  
+  // A property that exists but holds undefined converts like any
+  // other value, while a missing one reads as empty.
+  js_error.SetProperty("message", js_context.CreateUndefined());
+  XCTAssertEqual("undefined", js_error.message());
+  js_error.SetProperty("fileName", js_context.CreateUndefined());
+  XCTAssertEqual("undefined", js_error.filename());
+}
+
+TEST_F(JSObjectTests, Intrinsics) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSArray js_array = js_context.CreateArray();
+  JSError js_error = js_context.CreateError();
+  XCTAssertTrue(js_array.IsArray());
+  XCTAssertTrue(js_error.IsError());
+  
+  // IsArray and IsError use the intrinsics cached by the context, so
+  // scripts replacing the globals don't affect them.
+  js_context.JSEvaluateScript("Array.isArray = function() { return false; }; Error = null;");
+  XCTAssertTrue(js_array.IsArray());
+  XCTAssertTrue(js_error.IsError());
+  XCTAssertFalse(js_context.CreateObject().IsArray());
+  XCTAssertFalse(js_context.CreateObject().IsError());
+  
+  // A script evaluated without a this object runs with the global
+  // object as "this".
+  XCTAssertTrue(static_cast<bool>(js_context.JSEvaluateScript("this === (function() { return this; })()")));
 }
 
 TEST_F(JSObjectTests, JSRegExp) {
@@ -517,6 +549,152 @@ TEST_F(JSObjectTests, JSFunctionCallback) {
   
 }
 
+TEST_F(JSObjectTests, JSFunctionArgumentsCallback) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSFunctionArgumentsCallback callback = [](const JSArguments& arguments, JSObject& this_object) {
+    return this_object.get_context().CreateString("Hello, " + arguments.GetString(0, "nobody"));
+  };
+
+  JSFunction js_function = js_context.CreateFunction(callback);
+  XCTAssertTrue(js_function.IsFunction());
+  XCTAssertEqual("Hello, world", static_cast<std::string>(js_function("world", js_function)));
+
+  auto global_object = js_context.get_global_object();
+  global_object.SetProperty("testJSFunctionArgumentsCallback", js_function);
+
+  XCTAssertEqual("Hello, JavaScript", static_cast<std::string>(js_context.JSEvaluateScript("testJSFunctionArgumentsCallback('JavaScript');")));
+  XCTAssertEqual("Hello, nobody", static_cast<std::string>(js_context.JSEvaluateScript("testJSFunctionArgumentsCallback();")));
+}
+
+TEST_F(JSObjectTests, JSFunctionCallbackLifetime) {
+  JSContext js_context = js_context_group.CreateContext();
+  auto global_object = js_context.get_global_object();
+  
+  {
+    JSFunctionArgumentsCallback callback = [](const JSArguments& arguments, JSObject& this_object) {
+      return this_object.get_context().CreateString("Hello, " + arguments.GetString(0, "nobody"));
+    };
+    JSFunction js_function = js_context.CreateFunction("hello", callback);
+    global_object.SetProperty("hello", js_function);
+    
+    // The function's private data is its callback, not a JSExportObject.
+    XCTAssertEqual(nullptr, js_function.GetPrivate<JSExportObject>());
+  }
+  
+  // The callback outlives the JSFunction that created it.
+  XCTAssertEqual("Hello, world", static_cast<std::string>(js_context.JSEvaluateScript("hello('world');")));
+  
+  // It is still a function as far as JavaScript is concerned.
+  XCTAssertEqual("function", static_cast<std::string>(js_context.JSEvaluateScript("typeof hello;")));
+  XCTAssertEqual("hello", static_cast<std::string>(js_context.JSEvaluateScript("hello.name;")));
+  XCTAssertTrue(static_cast<bool>(js_context.JSEvaluateScript("hello instanceof Function;")));
+  XCTAssertEqual("Hello, JavaScript", static_cast<std::string>(js_context.JSEvaluateScript("hello.call(null, 'JavaScript');")));
+  XCTAssertEqual("Hello, nobody", static_cast<std::string>(js_context.JSEvaluateScript("hello.bind(null)();")));
+}
+
+TEST_F(JSObjectTests, JSFunctionCallbackReleasesContext) {
+  std::weak_ptr<int> weak_answer;
+  {
+    JSContextGroup js_context_group;
+    JSContext js_context = js_context_group.CreateContext();
+    
+    // The callback captures no HAL handles, so the global object
+    // referring to the function doesn't keep the context alive.
+    auto answer = std::make_shared<int>(42);
+    weak_answer = answer;
+    JSFunctionArgumentsCallback callback = [answer](const JSArguments& arguments, JSObject& this_object) {
+      return this_object.get_context().CreateNumber(*answer);
+    };
+    js_context.get_global_object().SetProperty("answer", js_context.CreateFunction("answer", callback));
+    XCTAssertEqual(42, static_cast<int32_t>(js_context.JSEvaluateScript("answer();")));
+    XCTAssertFalse(weak_answer.expired());
+  }
+  
+  // Releasing the context group finalized the function, and its
+  // callback was destroyed outside of garbage collection.
+  XCTAssertTrue(weak_answer.expired());
+  
+  std::weak_ptr<int> weak_question;
+  {
+    JSContext js_context = js_context_group.CreateContext();
+    
+    // The callback captures its own context, which by itself must not
+    // keep the context alive.
+    auto question = std::make_shared<int>(6 * 7);
+    weak_question = question;
+    JSValue js_prefix = js_context.CreateString("The answer is ");
+    JSFunctionArgumentsCallback callback = [js_context, js_prefix, question](const JSArguments& arguments, JSObject& this_object) {
+      return js_context.CreateString(static_cast<std::string>(js_prefix) + std::to_string(*question));
+    };
+    js_context.get_global_object().SetProperty("question", js_context.CreateFunction("question", callback));
+    XCTAssertEqual("The answer is 42", static_cast<std::string>(js_context.JSEvaluateScript("question();")));
+    XCTAssertFalse(weak_question.expired());
+  }
+  
+  // Releasing the last JSContext destroyed the callback even though
+  // the fixture's context group is still alive.
+  XCTAssertTrue(weak_question.expired());
+}
+
+TEST_F(JSObjectTests, JSFunctionNativeCallback) {
+  JSContext js_context = js_context_group.CreateContext();
+  auto global_object = js_context.get_global_object();
+  
+  JSFunction js_scale = js_context.CreateFunction("scale", +[](double value, int32_t steps, const std::string& unit) {
+    return unit == "%" ? value * steps / 100 : value * steps;
+  });
+  XCTAssertTrue(js_scale.IsFunction());
+  global_object.SetProperty("scale", js_scale);
+  
+  auto result = js_context.JSEvaluateScript("scale(4, 3, 'px');");
+  XCTAssertTrue(result.IsNumber());
+  XCTAssertEqual(12, static_cast<double>(result));
+  
+  result = js_context.JSEvaluateScript("try { scale(4); 'no exception'; } catch (e) { e.message; }");
+  XCTAssertEqual("expected 3 arguments but got 1", static_cast<std::string>(result));
+  
+  result = js_context.JSEvaluateScript("try { scale(4, 3, 5); 'no exception'; } catch (e) { e.message; }");
+  XCTAssertEqual("argument 2 is not a string", static_cast<std::string>(result));
+  
+  // A native function returning void returns undefined.
+  JSFunction js_noop = js_context.CreateFunction(+[](bool) {});
+  global_object.SetProperty("noop", js_noop);
+  XCTAssertTrue(js_context.JSEvaluateScript("noop(true);").IsUndefined());
+  XCTAssertEqual("argument 0 is not a boolean", static_cast<std::string>(js_context.JSEvaluateScript("try { noop(1); } catch (e) { e.message; }")));
+}
+
+TEST_F(JSObjectTests, JSArguments) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSValue js_string = js_context.CreateString("world");
+  JSValue js_number = js_context.CreateNumber(int32_t(42));
+  JSValue js_undefined = js_context.CreateUndefined();
+  const JSValueRef arguments_array[] = { static_cast<JSValueRef>(js_string), static_cast<JSValueRef>(js_number), static_cast<JSValueRef>(js_undefined) };
+
+  JSHandleScope handle_scope;
+  JSArguments arguments(static_cast<JSContextRef>(js_context), 3, arguments_array);
+  XCTAssertEqual(3u, arguments.size());
+  XCTAssertFalse(arguments.empty());
+
+  XCTAssertTrue(arguments[0].IsString());
+  XCTAssertEqual("world", static_cast<std::string>(arguments.at(0)));
+  XCTAssertEqual("world", arguments.GetString(0, "nobody"));
+  XCTAssertEqual(42, arguments.GetInt32(1));
+  XCTAssertEqual(42u, arguments.GetUInt32(1));
+  XCTAssertEqual(42.0, arguments.GetNumber(1));
+  XCTAssertTrue(arguments.GetBoolean(1));
+
+  // Undefined and missing arguments get the default value.
+  XCTAssertFalse(arguments.Has(2));
+  XCTAssertEqual(7, arguments.GetInt32(2, 7));
+  XCTAssertFalse(arguments.Has(3));
+  XCTAssertEqual("nobody", arguments.GetString(3, "nobody"));
+  ASSERT_THROW(arguments.at(3), std::invalid_argument);
+
+  const auto vector = arguments.ToVector();
+  XCTAssertEqual(3u, vector.size());
+  XCTAssertTrue(vector.at(1) == js_number);
+}
+
 TEST_F(JSObjectTests, JSON_stringify) {
   auto js_context = js_context_group.CreateContext();
   auto global_object = js_context.get_global_object();
@@ -546,3 +724,107 @@ TEST_F(JSObjectTests, JSON_stringify) {
   XCTAssertEqual("[\"Hello\",123,3.141592653589793,true,{}]", static_cast<std::string>(js_result));
 }
 
+
+TEST_F(JSObjectTests, Move) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject js_object = js_context.CreateObject();
+  js_object.SetProperty("foo", js_context.CreateNumber(42));
+  JSPropertyNameArray js_property_name_array = js_object.GetPropertyNames();
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_object_refs_retained = detail::JSPerformanceCounter<JSObject>::get_refs_retained();
+  const auto js_object_refs_released = detail::JSPerformanceCounter<JSObject>::get_refs_released();
+  const auto js_property_name_array_refs_retained = detail::JSPerformanceCounter<JSPropertyNameArray>::get_refs_retained();
+  const auto js_property_name_array_refs_released = detail::JSPerformanceCounter<JSPropertyNameArray>::get_refs_released();
+#endif
+  
+  {
+    std::vector<JSObject> js_objects;
+    js_objects.reserve(1);
+    js_objects.push_back(std::move(js_object));
+    js_object = std::move(js_objects.back());
+    
+    JSPropertyNameArray js_property_name_array_moved(std::move(js_property_name_array));
+    js_property_name_array = std::move(js_property_name_array_moved);
+  }
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(js_object_refs_retained, detail::JSPerformanceCounter<JSObject>::get_refs_retained());
+  XCTAssertEqual(js_object_refs_released, detail::JSPerformanceCounter<JSObject>::get_refs_released());
+  XCTAssertEqual(js_property_name_array_refs_retained, detail::JSPerformanceCounter<JSPropertyNameArray>::get_refs_retained());
+  XCTAssertEqual(js_property_name_array_refs_released, detail::JSPerformanceCounter<JSPropertyNameArray>::get_refs_released());
+#endif
+  
+  XCTAssertTrue(js_object.HasProperty("foo"));
+  XCTAssertEqual(42, static_cast<int32_t>(js_object.GetProperty("foo")));
+  XCTAssertEqual(1, js_property_name_array.GetCount());
+  XCTAssertEqual("foo", static_cast<std::string>(js_property_name_array.GetNameAtIndex(0)));
+}
+
+TEST_F(JSObjectTests, JSPropertyKey) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject js_object = js_context.CreateObject();
+  
+  js_object.SetProperty(HAL_KEY("foo"), js_context.CreateNumber(42));
+  XCTAssertTrue(js_object.HasProperty(HAL_KEY("foo")));
+  XCTAssertTrue(js_object.HasProperty("foo"));
+  XCTAssertEqual(42, static_cast<int32_t>(js_object.GetProperty(HAL_KEY("foo"))));
+  
+  // The hash value of an ASCII key is computed at compile time and
+  // matches the hash value of the equivalent JSString.
+  HAL_CONSTEXPR std::size_t hash_value = detail::fnv1a_utf16_ascii("foo", 3);
+  XCTAssertEqual(JSString("foo").hash_value(), hash_value);
+  XCTAssertEqual(JSString("foo").hash_value(), HAL_KEY("foo").hash_value());
+  XCTAssertEqual(JSString("spät").hash_value(), HAL_KEY("spät").hash_value());
+  XCTAssertEqual(JSString("foo"), HAL_KEY("foo").get_js_string());
+  
+  XCTAssertTrue(js_object.DeleteProperty(HAL_KEY("foo")));
+  XCTAssertFalse(js_object.HasProperty(HAL_KEY("foo")));
+}
+
+TEST_F(JSObjectTests, JSExpected) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject js_object = static_cast<JSObject>(js_context.JSEvaluateScript("({ foo: 42, get bar() { throw 'bar'; }, set baz(value) { throw value; } })"));
+  
+  auto foo = js_object.TryGetProperty("foo");
+  XCTAssertTrue(foo.has_value());
+  XCTAssertEqual(42, static_cast<int32_t>(*foo));
+  
+  // A missing property is JSUndefined, not an error.
+  auto missing = js_object.TryGetProperty("missing");
+  XCTAssertTrue(missing.has_value());
+  XCTAssertTrue(missing -> IsUndefined());
+  
+  auto bar = js_object.TryGetProperty("bar");
+  XCTAssertFalse(bar.has_value());
+  XCTAssertEqual("bar", static_cast<std::string>(bar.error().get_value()));
+  XCTAssertEqual(7, static_cast<int32_t>(bar.value_or(js_context.CreateNumber(7))));
+  ASSERT_THROW(bar.value(), std::runtime_error);
+  ASSERT_THROW(js_object.GetProperty("bar"), std::runtime_error);
+  
+  auto baz = js_object.TrySetProperty("baz", js_context.CreateNumber(1));
+  XCTAssertFalse(baz.has_value());
+  XCTAssertEqual(1, static_cast<int32_t>(baz.error().get_value()));
+  XCTAssertTrue(js_object.TrySetProperty("foo", js_context.CreateNumber(2)).has_value());
+  XCTAssertEqual(2, static_cast<int32_t>(js_object.GetProperty("foo")));
+  
+  JSObject js_function = static_cast<JSObject>(js_context.JSEvaluateScript("(function(value) { if (value) { throw value; } return 'ok'; })"));
+  auto ok = js_function.TryCallAsFunction({}, js_context.get_global_object());
+  XCTAssertTrue(ok.has_value());
+  XCTAssertEqual("ok", static_cast<std::string>(*ok));
+  auto thrown = js_function.TryCallAsFunction({js_context.CreateNumber(3)}, js_context.get_global_object());
+  XCTAssertFalse(thrown.has_value());
+  XCTAssertEqual(3, static_cast<int32_t>(thrown.error().get_value()));
+  
+  // Calling something that isn't a function is an Error, just as it
+  // would be in JavaScript.
+  auto not_a_function = js_object.TryCallAsFunction({}, js_context.get_global_object());
+  XCTAssertFalse(not_a_function.has_value());
+  XCTAssertTrue(static_cast<JSObject>(not_a_function.error().get_value()).IsError());
+  XCTAssertFalse(js_object.TryCallAsConstructor().has_value());
+  
+  auto evaluated = js_context.TryJSEvaluateScript("throw 42");
+  XCTAssertFalse(evaluated.has_value());
+  XCTAssertEqual(42, static_cast<int32_t>(evaluated.error().get_value()));
+  XCTAssertEqual(6, static_cast<int32_t>(js_context.TryJSEvaluateScript("2 * 3").value()));
+}
@@ -0,0 +1,203 @@
+/**
+ * HAL
+ *
+ * Copyright (c) 2014 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License.
+ * Please see the LICENSE included with this distribution for details.
+ */
+
+#include "HAL/HAL.hpp"
+#include "Widget.hpp"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define XCTAssertEqual    ASSERT_EQ
+#define XCTAssertNotEqual ASSERT_NE
+#define XCTAssertTrue     ASSERT_TRUE
+#define XCTAssertFalse    ASSERT_FALSE
+
+using namespace HAL;
+
+namespace UnitTestConstants {
+  static const std::uint32_t iterations { 100000 };
+}
+
+// Run the given function the given number of times and return the
+// average cost of one call in nanoseconds.
+template<typename F>
+double MeasureNanosecondsPerCall(std::uint32_t iterations, F&& function) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::uint32_t i = 0; i < iterations; ++i) {
+    function();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+void PrintNanosecondsPerCall(const std::string& name, double nanoseconds) {
+  std::clog << "JSPerformanceTests: " << name << " = " << nanoseconds << " ns/call" << std::endl;
+}
+
+class JSPerformanceTests : public testing::Test {
+ protected:
+  virtual void SetUp() {
+  }
+
+  virtual void TearDown() {
+  }
+
+  JSContextGroup js_context_group;
+};
+
+TEST_F(JSPerformanceTests, CallNamedFunction) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject global_object = js_context.get_global_object();
+
+  JSObject widget = js_context.CreateObject(JSExport<Widget>::Class());
+  global_object.SetProperty("widget", widget);
+
+  JSValue widget_sayHello_property = widget.GetProperty("sayHello");
+  XCTAssertTrue(widget_sayHello_property.IsObject());
+  JSObject widget_sayHello = static_cast<JSObject>(widget_sayHello_property);
+  XCTAssertTrue(widget_sayHello.IsFunction());
+
+  // The cost of calling an exported function, which is dispatched
+  // directly to its callback instead of recovering the function's
+  // name from its source text on every call.
+  const auto nanoseconds = MeasureNanosecondsPerCall(UnitTestConstants::iterations, [&widget_sayHello, &widget]() {
+    widget_sayHello(widget);
+  });
+
+  PrintNanosecondsPerCall("CallNamedFunction", nanoseconds);
+
+  XCTAssertEqual("Hello, world. Your number is 42.", static_cast<std::string>(widget_sayHello(widget)));
+}
+
+TEST_F(JSPerformanceTests, JSObjectWrapperThroughput) {
+  // Each thread runs its own context group, so the only thing the
+  // threads could contend on is HAL's own bookkeeping.
+  auto create_and_destroy_wrappers = []() {
+    JSContextGroup js_context_group;
+    JSContext js_context = js_context_group.CreateContext();
+    JSObject js_object   = js_context.CreateObject();
+    for (std::uint32_t i = 0; i < UnitTestConstants::iterations; ++i) {
+      JSObject copy = js_object;
+      static_cast<void>(copy);
+    }
+  };
+
+  const std::uint32_t max_thread_count = std::max(1u, std::thread::hardware_concurrency());
+  for (std::uint32_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::uint32_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back(create_and_destroy_wrappers);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>(stop - start).count();
+    const auto wrappers_per_second = thread_count * UnitTestConstants::iterations / seconds;
+    std::clog << "JSPerformanceTests: JSObjectWrapperThroughput (" << thread_count << " threads) = " << wrappers_per_second << " wrappers/s" << std::endl;
+  }
+}
+
+TEST_F(JSPerformanceTests, JSValueCopy) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSValue js_value = js_context.CreateNumber(42);
+
+  std::clog << "JSPerformanceTests: sizeof(JSValue) = " << sizeof(JSValue) << std::endl;
+
+  const auto nanoseconds = MeasureNanosecondsPerCall(UnitTestConstants::iterations, [&js_value]() {
+    JSValue copy = js_value;
+    static_cast<void>(copy);
+  });
+  PrintNanosecondsPerCall("JSValueCopy", nanoseconds);
+
+  XCTAssertEqual(42, static_cast<int32_t>(js_value));
+}
+
+TEST_F(JSPerformanceTests, PropertyNames) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject js_object = js_context.CreateObject();
+  for (int i = 0; i < 100; ++i) {
+    js_object.SetProperty("property" + std::to_string(i), js_context.CreateNumber(i));
+  }
+
+  // Walk every property name and check it for existence, which only
+  // ever hands the names back to JavaScriptCore.
+  const auto property_names = js_object.GetPropertyNames();
+  const auto count = property_names.GetCount();
+  const auto nanoseconds = MeasureNanosecondsPerCall(UnitTestConstants::iterations / 100, [&js_object, &property_names, count]() {
+    for (std::size_t i = 0; i < count; ++i) {
+      js_object.HasProperty(property_names.GetNameAtIndex(i));
+    }
+  });
+  PrintNanosecondsPerCall("PropertyNames", nanoseconds);
+
+  // Hashing must not depend on how the name was created.
+  const JSString property_name { "property42" };
+  XCTAssertEqual(property_name, property_names.GetNameAtIndex(42));
+  XCTAssertEqual(property_name.hash_value(), property_names.GetNameAtIndex(42).hash_value());
+}
+
+TEST_F(JSPerformanceTests, StringTranscoding) {
+  // A JSON payload of the kind that crosses the bridge all the time.
+  std::string payload = "[";
+  for (int i = 0; i < 100; ++i) {
+    payload += R"({"id":)" + std::to_string(i) + R"(,"name":"widget )" + std::to_string(i) + R"(","tags":["a","b","c"]},)";
+  }
+  payload.back() = ']';
+
+  const auto after = MeasureNanosecondsPerCall(UnitTestConstants::iterations / 100, [&payload]() {
+    const JSString js_string(payload);
+    static_cast<void>(static_cast<std::string>(JSString(static_cast<JSStringRef>(js_string))));
+  });
+
+  // The same round trip through JavaScriptCore's own conversion into a
+  // worst-case sized buffer.
+  const auto before = MeasureNanosecondsPerCall(UnitTestConstants::iterations / 100, [&payload]() {
+    JSStringRef js_string_ref = JSStringCreateWithUTF8CString(payload.c_str());
+    const auto size = JSStringGetMaximumUTF8CStringSize(js_string_ref);
+    std::string string(size, '\0');
+    string.resize(JSStringGetUTF8CString(js_string_ref, &string[0], size) - 1);
+    JSStringRelease(js_string_ref);
+  });
+
+  PrintNanosecondsPerCall("StringTranscoding (before)", before);
+  PrintNanosecondsPerCall("StringTranscoding (after) ", after);
+}
+
+TEST_F(JSPerformanceTests, JSValueToUTF8) {
+  JSContext js_context = js_context_group.CreateContext();
+  const std::vector<JSValue> js_values {
+    js_context.CreateNumber(42),
+    js_context.CreateBoolean(true),
+    js_context.CreateString("metrics.tag")
+  };
+
+  char buffer[64];
+  const auto after = MeasureNanosecondsPerCall(UnitTestConstants::iterations, [&js_values, &buffer]() {
+    for (const auto& js_value : js_values) {
+      js_value.ToUTF8(buffer, sizeof(buffer));
+    }
+  });
+
+  // Converting through a JSString and a std::string as before.
+  const auto before = MeasureNanosecondsPerCall(UnitTestConstants::iterations, [&js_values]() {
+    for (const auto& js_value : js_values) {
+      static_cast<void>(static_cast<std::string>(static_cast<JSString>(js_value)));
+    }
+  });
+
+  PrintNanosecondsPerCall("JSValueToUTF8 (before)", before);
+  PrintNanosecondsPerCall("JSValueToUTF8 (after) ", after);
+}
@@ -10,6 +10,8 @@
 
 #include <string>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -101,3 +103,205 @@ TEST(JSStringTests, UTF8) {
   XCTAssertEqual("spät", static_cast<std::string>(string2));
 }
 
+
+TEST(JSStringTests, Move) {
+  JSString string1 { "hello, JSString" };
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto refs_retained = detail::JSPerformanceCounter<JSString>::get_refs_retained();
+  const auto refs_released = detail::JSPerformanceCounter<JSString>::get_refs_released();
+#endif
+  
+  JSString string2(std::move(string1));
+  string1 = std::move(string2);
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(refs_retained, detail::JSPerformanceCounter<JSString>::get_refs_retained());
+  XCTAssertEqual(refs_released, detail::JSPerformanceCounter<JSString>::get_refs_released());
+#endif
+  
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string1));
+  XCTAssertEqual(JSString("hello, JSString"), string1);
+  
+  // A moved-from JSString reads as the empty string.
+  JSString string3(std::move(string1));
+  XCTAssertEqual(0, string1.hash_value());
+  XCTAssertEqual("", static_cast<std::string>(string1));
+  XCTAssertEqual(0, string1.length());
+  char buffer[4] = "abc";
+  XCTAssertEqual(0, string1.CopyUTF8To(buffer, sizeof(buffer)));
+  XCTAssertEqual(std::string(), buffer);
+  JSString string4 = string1;
+  XCTAssertEqual(0, string4.length());
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string3));
+}
+
+TEST(JSStringTests, LazyUTF8) {
+  JSString string1 { "hello, JSString" };
+  JSString string2 { std::string("hello, JSString") };
+  JSString string3 = JSString(static_cast<JSStringRef>(string1));
+  
+  // Hashing doesn't depend on how the JSString was created.
+  XCTAssertEqual(string1.hash_value(), string2.hash_value());
+  XCTAssertEqual(string1.hash_value(), string3.hash_value());
+  XCTAssertNotEqual(string1.hash_value(), JSString("hello, JSValue").hash_value());
+  
+  // Nor on whether its UTF-8 conversion has been cached.
+  const auto hash_value = string3.hash_value();
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string3));
+  XCTAssertEqual(hash_value, string3.hash_value());
+  
+  // Copies keep their value whether or not it has been converted yet.
+  JSString string4 = string3;
+  JSString string5 = string2;
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string4));
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string5));
+  
+  swap(string4, string1);
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string1));
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string4));
+  
+  XCTAssertEqual("", static_cast<std::string>(JSString()));
+  XCTAssertEqual("spät", static_cast<std::string>(JSString(static_cast<JSStringRef>(JSString("spät")))));
+}
+
+TEST(JSStringTests, LazyUTF8Threads) {
+  JSString string { "hello, JSString" };
+  
+  std::vector<std::thread> threads;
+  std::vector<std::string> results(4);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&string, &results, i]() {
+      results[i] = static_cast<std::string>(string);
+      static_cast<void>(string.hash_value());
+    });
+  }
+  
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  
+  for (const auto& result : results) {
+    XCTAssertEqual("hello, JSString", result);
+  }
+}
+
+TEST(JSStringTests, Intern) {
+  const auto& string1 = JSString::Intern("hello, JSString");
+  const auto& string2 = JSString::Intern(std::string("hello, JSString"));
+  XCTAssertEqual(&string1, &string2);
+  XCTAssertEqual(JSString("hello, JSString"), string1);
+  XCTAssertEqual("hello, JSString", static_cast<std::string>(string1));
+  
+  const auto& string3 = JSString::Intern("hello, JSValue");
+  XCTAssertNotEqual(&string1, &string3);
+  XCTAssertNotEqual(string1, string3);
+  
+  JSContextGroup js_context_group;
+  JSContext js_context = js_context_group.CreateContext();
+  JSObject js_object = js_context.CreateObject();
+  js_object.SetProperty(string1, js_context.CreateNumber(42));
+  XCTAssertTrue(js_object.HasProperty("hello, JSString"));
+  XCTAssertEqual(42, static_cast<int32_t>(js_object.GetProperty(string1)));
+}
+
+TEST(JSStringTests, Transcoding) {
+  // Long enough to take the vectorized ASCII path, with non-ASCII
+  // characters at and around block boundaries.
+  const std::string ascii = "The quick brown fox jumps over the lazy dog. 0123456789";
+  const std::string mixed = "spät " + ascii + " ü €uro 😀 " + ascii + "日本語";
+  for (const auto& string : { ascii, mixed, std::string("😀"), std::string("") }) {
+    JSString js_string(string);
+    XCTAssertEqual(string, static_cast<std::string>(js_string));
+    
+    // Agree with JavaScriptCore's own conversion both ways.
+    JSStringRef js_string_ref = JSStringCreateWithUTF8CString(string.c_str());
+    XCTAssertTrue(JSStringIsEqual(js_string_ref, static_cast<JSStringRef>(js_string)));
+    XCTAssertEqual(string, static_cast<std::string>(JSString(js_string_ref)));
+    JSStringRelease(js_string_ref);
+  }
+  
+  XCTAssertEqual(4, JSString("spät").length());
+  XCTAssertEqual(2, JSString("😀").length());
+  
+  // Malformed UTF-8 is handled exactly as JavaScriptCore handles it.
+  const char* malformed = "abc\xC0\x80 def";
+  JSStringRef js_string_ref = JSStringCreateWithUTF8CString(malformed);
+  XCTAssertTrue(JSStringIsEqual(js_string_ref, static_cast<JSStringRef>(JSString(malformed))));
+  JSStringRelease(js_string_ref);
+}
+
+TEST(JSStringTests, Slices) {
+  const char* buffer = "hello, JSString";
+  XCTAssertEqual(JSString("hello"), JSString(buffer, 5));
+  XCTAssertEqual(JSString(""), JSString(buffer, 0));
+  
+  const JSChar utf16[] = { 's', 'p', 0x00E4, 't' };
+  XCTAssertEqual(JSString("spät"), JSString(utf16, 4));
+  
+#if HAL_STRING_VIEW_ENABLE
+  const std::string_view string_view(buffer);
+  XCTAssertEqual(JSString("JSString"), JSString(string_view.substr(7)));
+  XCTAssertEqual(JSString("spät"), JSString(std::u16string_view(u"spät")));
+  
+  JSString string { "spät" };
+  XCTAssertEqual(std::u16string_view(u"spät"), string.u16view());
+  
+  // A moved-from JSString has an empty view.
+  JSString moved { std::move(string) };
+  XCTAssertTrue(string.u16view().empty());
+#endif
+}
+
+TEST(JSStringTests, CopyUTF8To) {
+  JSString string { "spät" };
+  char buffer[16];
+  XCTAssertEqual(5, string.CopyUTF8To(buffer, sizeof(buffer)));
+  XCTAssertEqual(std::string("spät"), buffer);
+  
+  // Never split a character.
+  XCTAssertEqual(2, string.CopyUTF8To(buffer, 4));
+  XCTAssertEqual(std::string("sp"), buffer);
+  XCTAssertEqual(0, string.CopyUTF8To(buffer, 0));
+  
+  // Whether or not the UTF-8 conversion has been cached.
+  XCTAssertEqual("spät", static_cast<std::string>(string));
+  XCTAssertEqual(2, string.CopyUTF8To(buffer, 4));
+  XCTAssertEqual(std::string("sp"), buffer);
+  XCTAssertEqual(5, string.CopyUTF8To(buffer, 6));
+  XCTAssertEqual(std::string("spät"), buffer);
+}
+
+TEST(JSStringTests, JSStringBuilder) {
+  JSStringBuilder builder;
+  XCTAssertTrue(builder.empty());
+  XCTAssertEqual(JSString(), builder.ToJSString());
+  
+  const JSChar utf16[] = { 0x00FC, 'r' };
+  builder.Append("<p>").Append(std::string("spät")).Append(utf16, 2).Append(JSString("😀")).Append("</p>", 4);
+  XCTAssertEqual(15, builder.size());
+  XCTAssertEqual("<p>spätür😀</p>", static_cast<std::string>(builder.ToJSString()));
+  
+  // A moved-from JSString appends nothing.
+  JSString moved_from { "spät" };
+  JSString moved_to { std::move(moved_from) };
+  builder.Append(moved_from);
+  XCTAssertEqual(15, builder.size());
+  
+  // Many small fragments.
+  JSStringBuilder json(16);
+  json.Append("[");
+  for (int i = 0; i < 1000; ++i) {
+    json.Append(i == 0 ? "" : ",").Append(std::to_string(i));
+  }
+  json.Append("]");
+  
+  JSContextGroup js_context_group;
+  JSContext js_context = js_context_group.CreateContext();
+  JSValue js_value = json.ToJSValue(js_context);
+  XCTAssertTrue(js_value.IsString());
+  XCTAssertEqual(1000, static_cast<JSArray>(static_cast<JSObject>(js_context.CreateValueFromJSON(json.ToJSString()))).GetLength());
+  
+  builder.clear();
+  XCTAssertTrue(builder.empty());
+}
@@ -8,6 +8,12 @@
 
 #include "HAL/HAL.hpp"
 
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #define XCTAssertEqual    ASSERT_EQ
@@ -300,3 +306,331 @@ TEST_F(JSValueTests, JSON_Stringify) {
   js_result = js_context.JSEvaluateScript("JSON.stringify(js_string);");
   XCTAssertEqual("\"Hello, World\"", static_cast<std::string>(js_result));
 }
+
+TEST_F(JSValueTests, JSLocal) {
+  auto js_context = js_context_group.CreateContext();
+  auto js_number  = js_context.CreateNumber(UnitTestConstants::pi);
+  auto js_string  = js_context.CreateString("Hello, World");
+
+  XCTAssertFalse(JSHandleScope::IsOpen());
+  {
+    JSHandleScope handle_scope;
+    XCTAssertTrue(JSHandleScope::IsOpen());
+    XCTAssertEqual(1u, JSHandleScope::GetDepth());
+
+    JSLocal js_local_number(static_cast<JSContextRef>(js_context), static_cast<JSValueRef>(js_number));
+    XCTAssertTrue(js_local_number.IsNumber());
+    XCTAssertEqual(JSValue::Type::Number, js_local_number.GetType());
+    XCTAssertEqual(UnitTestConstants::pi, static_cast<double>(js_local_number));
+    XCTAssertEqual(3, static_cast<int32_t>(js_local_number));
+
+    JSLocal js_local_string(static_cast<JSContextRef>(js_context), static_cast<JSValueRef>(js_string));
+    XCTAssertTrue(js_local_string.IsString());
+    XCTAssertFalse(js_local_string.IsObject());
+    XCTAssertEqual("Hello, World", static_cast<std::string>(js_local_string));
+    XCTAssertTrue(js_local_string.get_context() == js_context);
+
+    // Copying a JSLocal only copies the handle.
+    JSLocal js_local_copy = js_local_string;
+    XCTAssertEqual(static_cast<JSValueRef>(js_local_string), static_cast<JSValueRef>(js_local_copy));
+
+    // A JSLocal must be promoted to outlive its JSHandleScope.
+    JSValue js_value = js_local_string.ToPersistent();
+    XCTAssertTrue(js_value == js_string);
+  }
+  XCTAssertFalse(JSHandleScope::IsOpen());
+}
+
+TEST_F(JSValueTests, Move) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSValue js_value = js_context.CreateString("hello");
+  const auto js_value_ref = static_cast<JSValueRef>(js_value);
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_value_refs_retained   = detail::JSPerformanceCounter<JSValue>::get_refs_retained();
+  const auto js_value_refs_released   = detail::JSPerformanceCounter<JSValue>::get_refs_released();
+  const auto js_context_refs_retained = detail::JSPerformanceCounter<JSContext>::get_refs_retained();
+  const auto js_context_refs_released = detail::JSPerformanceCounter<JSContext>::get_refs_released();
+#endif
+  
+  {
+    std::vector<JSValue> js_values;
+    js_values.reserve(1);
+    
+    JSValue js_value_moved(std::move(js_value));
+    js_values.push_back(std::move(js_value_moved));
+    
+    // A moved-from JSValue may be assigned to.
+    js_value = std::move(js_values.back());
+  }
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  // Moving a JSValue neither protects nor unprotects it, and neither
+  // does moving the JSContext it holds.
+  XCTAssertEqual(js_value_refs_retained  , detail::JSPerformanceCounter<JSValue>::get_refs_retained());
+  XCTAssertEqual(js_value_refs_released  , detail::JSPerformanceCounter<JSValue>::get_refs_released());
+  XCTAssertEqual(js_context_refs_retained, detail::JSPerformanceCounter<JSContext>::get_refs_retained());
+  XCTAssertEqual(js_context_refs_released, detail::JSPerformanceCounter<JSContext>::get_refs_released());
+#endif
+  
+  // The JSValueRef itself was handed over rather than re-created.
+  XCTAssertEqual(js_value_ref, static_cast<JSValueRef>(js_value));
+  XCTAssertTrue(js_value.IsString());
+  XCTAssertEqual("hello", static_cast<std::string>(js_value));
+}
+
+TEST_F(JSValueTests, MovedFrom) {
+  JSContext js_context = js_context_group.CreateContext();
+  JSValue   js_value   = js_context.CreateString("hello");
+  JSObject  js_object  = js_context.CreateObject();
+  
+  JSContext js_context_moved(std::move(js_context));
+  JSValue   js_value_moved(std::move(js_value));
+  JSObject  js_object_moved(std::move(js_object));
+  
+  // A moved-from handle is empty, and copying it yields another empty
+  // handle.
+  JSContext js_context_copy = js_context;
+  JSValue   js_value_copy   = js_value;
+  JSObject  js_object_copy  = js_object;
+  static_cast<void>(js_value.get_context());
+  static_cast<void>(js_object.get_context());
+  
+  // An empty handle may be assigned to a live one and back.
+  JSValue js_live_value = js_context_moved.CreateNumber(42);
+  js_live_value = js_value_copy;
+  js_live_value = js_value_moved;
+  XCTAssertEqual("hello", static_cast<std::string>(js_live_value));
+  
+  JSObject js_live_object = js_context_moved.CreateObject();
+  js_live_object = js_object_copy;
+  js_live_object = js_object_moved;
+  XCTAssertTrue(js_live_object == js_object_moved);
+  
+  JSContext js_live_context = js_context_moved;
+  js_live_context = js_context_copy;
+  js_live_context = js_context_moved;
+  XCTAssertEqual(js_context_moved, js_live_context);
+  
+  js_value  = js_value_moved;
+  js_object = js_object_moved;
+  js_context = js_context_moved;
+  XCTAssertEqual("hello", static_cast<std::string>(js_value));
+  XCTAssertTrue(js_object == js_object_moved);
+  XCTAssertEqual(js_context_moved, js_context);
+}
+
+TEST_F(JSValueTests, ToUTF8) {
+  JSContext js_context = js_context_group.CreateContext();
+  const std::vector<JSValue> js_values {
+    js_context.CreateUndefined(),
+    js_context.CreateNull(),
+    js_context.CreateBoolean(true),
+    js_context.CreateBoolean(false),
+    js_context.CreateNumber(0),
+    js_context.CreateNumber(-0.0),
+    js_context.CreateNumber(42),
+    js_context.CreateNumber(-9007199254740991.0),
+    js_context.CreateNumber(9007199254740992.0),
+    js_context.CreateNumber(0.1),
+    js_context.CreateNumber(1e21),
+    js_context.CreateNumber(std::numeric_limits<double>::quiet_NaN()),
+    js_context.CreateNumber(std::numeric_limits<double>::infinity()),
+    js_context.CreateNumber(-std::numeric_limits<double>::infinity()),
+    js_context.CreateString("spät 😀"),
+    js_context.CreateObject(),
+    js_context.CreateArray({ js_context.CreateNumber(1), js_context.CreateString("two") })
+  };
+  
+  for (const auto& js_value : js_values) {
+    // Agree with JavaScriptCore's own conversion.
+    const auto expected = static_cast<std::string>(static_cast<JSString>(js_value));
+    XCTAssertEqual(expected, static_cast<std::string>(js_value));
+    
+    char buffer[64];
+    XCTAssertEqual(expected.size(), js_value.ToUTF8(buffer, sizeof(buffer)));
+    XCTAssertEqual(expected, std::string(buffer));
+    
+    std::string string = "value: ";
+    js_value.AppendUTF8To(string);
+    XCTAssertEqual("value: " + expected, string);
+    
+    std::vector<char> output;
+    js_value.ToUTF8(std::back_inserter(output));
+    XCTAssertEqual(expected, std::string(output.begin(), output.end()));
+  }
+  
+  // Truncation never splits a character.
+  char buffer[8];
+  XCTAssertEqual(3, js_context.CreateNumber(-42.0).ToUTF8(buffer, 4));
+  XCTAssertEqual(std::string("-42"), buffer);
+  XCTAssertEqual(2, js_context.CreateNumber(-42.0).ToUTF8(buffer, 3));
+  XCTAssertEqual(std::string("-4"), buffer);
+  XCTAssertEqual(2, js_context.CreateString("spät").ToUTF8(buffer, 4));
+  XCTAssertEqual(std::string("sp"), buffer);
+  
+  // Long strings are written in pieces.
+  const std::string long_string(5000, 'x');
+  std::string string;
+  js_context.CreateString(long_string + "😀").AppendUTF8To(string);
+  XCTAssertEqual(long_string + "😀", string);
+}
+
+TEST_F(JSValueTests, Visit) {
+  JSContext js_context = js_context_group.CreateContext();
+  
+  const auto describe = [](const JSValue& js_value) {
+    return js_value.Visit(overloaded(
+      [](JSValue::Undefined)     { return std::string("undefined"); },
+      [](JSValue::Null)          { return std::string("null"); },
+      [](bool boolean)           { return std::string(boolean ? "boolean true" : "boolean false"); },
+      [](double number)          { return "number " + std::to_string(static_cast<int>(number)); },
+      [](const JSString& string) { return "string " + static_cast<std::string>(string); },
+      [](const JSObject& object) { return std::string(object.IsArray() ? "array" : "object"); }));
+  };
+  
+  XCTAssertEqual("undefined"    , describe(js_context.CreateUndefined()));
+  XCTAssertEqual("null"         , describe(js_context.CreateNull()));
+  XCTAssertEqual("boolean true" , describe(js_context.CreateBoolean(true)));
+  XCTAssertEqual("number 42"    , describe(js_context.CreateNumber(42)));
+  XCTAssertEqual("string hello" , describe(js_context.CreateString("hello")));
+  XCTAssertEqual("object"       , describe(js_context.CreateObject()));
+  XCTAssertEqual("array"        , describe(js_context.CreateArray()));
+  
+  // The cached type survives copies, moves and swaps.
+  JSValue js_value_1 = js_context.CreateString("hello");
+  JSValue js_value_2 = js_context.CreateNumber(42);
+  XCTAssertTrue(js_value_1.IsString());
+  XCTAssertTrue(js_value_2.IsNumber());
+  swap(js_value_1, js_value_2);
+  XCTAssertTrue(js_value_1.IsNumber());
+  XCTAssertTrue(js_value_2.IsString());
+  JSValue js_value_3 = js_value_2;
+  XCTAssertEqual(JSValue::Type::String, js_value_3.GetType());
+  JSValue js_value_4 = std::move(js_value_3);
+  XCTAssertEqual(JSValue::Type::String, js_value_4.GetType());
+  js_value_4 = js_value_1;
+  XCTAssertEqual(JSValue::Type::Number, js_value_4.GetType());
+  XCTAssertFalse(js_value_4.IsObject());
+}
+
+TEST_F(JSValueTests, CachedPrimitives) {
+  JSValue js_number = js_context_group.CreateContext().CreateNumber(7);
+  
+  JSContext js_context = js_context_group.CreateContext();
+  XCTAssertTrue(static_cast<JSValueRef>(js_context.CreateUndefined()) == static_cast<JSValueRef>(js_context.CreateUndefined()));
+  XCTAssertTrue(static_cast<JSValueRef>(js_context.CreateNull()) == static_cast<JSValueRef>(js_context.CreateNull()));
+  XCTAssertTrue(static_cast<JSValueRef>(js_context.CreateBoolean(true)) == static_cast<JSValueRef>(js_context.CreateBoolean(true)));
+  XCTAssertTrue(static_cast<JSValueRef>(js_context.CreateBoolean(false)) == static_cast<JSValueRef>(js_context.CreateBoolean(false)));
+  XCTAssertTrue(static_cast<bool>(js_context.CreateBoolean(true)));
+  XCTAssertFalse(static_cast<bool>(js_context.CreateBoolean(false)));
+  
+  const auto js_value_ref = static_cast<JSValueRef>(js_context.CreateNumber(42));
+  XCTAssertTrue(js_value_ref == static_cast<JSValueRef>(js_context.CreateNumber(42.0)));
+  XCTAssertTrue(js_value_ref == static_cast<JSValueRef>(js_context.CreateNumber(42u)));
+  XCTAssertEqual(42, static_cast<int32_t>(js_context.CreateNumber(42.0)));
+  XCTAssertEqual(-1, static_cast<int32_t>(js_context.CreateNumber(-1)));
+  XCTAssertEqual(1.5, static_cast<double>(js_context.CreateNumber(1.5)));
+  XCTAssertTrue(std::signbit(static_cast<double>(js_context.CreateNumber(-0.0))));
+  XCTAssertTrue(std::isnan(static_cast<double>(js_context.CreateNumber(std::nan("")))));
+  XCTAssertEqual(4294967295u, static_cast<uint32_t>(js_context.CreateNumber(4294967295u)));
+  
+  JSNumber js_assigned = js_context.CreateNumber(1);
+  js_assigned = 2;
+  XCTAssertEqual(2, static_cast<int32_t>(js_assigned));
+  
+  // A cached primitive outlives the JSContext it came from.
+  XCTAssertEqual(7, static_cast<int32_t>(js_number));
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_value_refs_retained = detail::JSPerformanceCounter<JSValue>::get_refs_retained();
+  const auto js_value_refs_released = detail::JSPerformanceCounter<JSValue>::get_refs_released();
+#endif
+  
+  {
+    std::vector<JSValue> js_values(100, js_context.CreateUndefined());
+    js_values.push_back(js_context.CreateNull());
+    js_values.push_back(js_context.CreateBoolean(true));
+    js_values.push_back(js_context.CreateNumber(3));
+  }
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(js_value_refs_retained, detail::JSPerformanceCounter<JSValue>::get_refs_retained());
+  XCTAssertEqual(js_value_refs_released, detail::JSPerformanceCounter<JSValue>::get_refs_released());
+#endif
+}
+
+TEST_F(JSValueTests, DeferredNumber) {
+  JSContext js_context = js_context_group.CreateContext();
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_value_refs_retained = detail::JSPerformanceCounter<JSValue>::get_refs_retained();
+#endif
+  
+  // Numbers are converted natively until JavaScriptCore needs them.
+  JSValue js_number = js_context.CreateNumber(1e6);
+  JSValue js_copy   = js_number;
+  XCTAssertTrue(js_copy.IsNumber());
+  XCTAssertEqual(1e6, static_cast<double>(js_copy));
+  XCTAssertEqual(1000000, static_cast<int32_t>(js_copy));
+  XCTAssertTrue(static_cast<bool>(js_copy));
+  XCTAssertFalse(static_cast<bool>(js_context.CreateNumber(std::nan(""))));
+  XCTAssertEqual("1000000", static_cast<std::string>(js_copy));
+  XCTAssertTrue(js_number == js_copy);
+  XCTAssertTrue(js_context.CreateNumber(std::nan("")) != js_context.CreateNumber(std::nan("")));
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  XCTAssertEqual(js_value_refs_retained, detail::JSPerformanceCounter<JSValue>::get_refs_retained());
+#endif
+  
+  // Crossing into JavaScriptCore makes the JSValueRef.
+  JSObject js_object = js_context.CreateObject();
+  js_object.SetProperty("number", js_number);
+  XCTAssertTrue(js_object.GetProperty("number") == js_number);
+  XCTAssertEqual(1e6, static_cast<double>(js_context.JSEvaluateScript("this.number", js_object)));
+  XCTAssertEqual("3.25", static_cast<std::string>(js_context.CreateNumber(3.25)));
+  
+  JSValue js_string = js_context.CreateString("foo");
+  js_string.swap(js_copy);
+  XCTAssertEqual("foo", static_cast<std::string>(js_copy));
+  XCTAssertEqual(1e6, static_cast<double>(js_string));
+  XCTAssertTrue(js_string == js_number);
+}
+
+TEST_F(JSValueTests, DeferredNumberSharedBetweenThreads) {
+  JSContext js_context = js_context_group.CreateContext();
+  const JSValue js_number = js_context.CreateNumber(1e6);
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  const auto js_value_refs_retained = detail::JSPerformanceCounter<JSValue>::get_refs_retained();
+#endif
+  
+  // Every thread makes the shared number's JSValueRef at the same time
+  // while the others read it as a number.
+  std::vector<JSObject> js_objects;
+  for (int i = 0; i < 4; ++i) {
+    js_objects.push_back(js_context.CreateObject());
+  }
+  
+  std::vector<std::thread> threads;
+  for (auto& js_object : js_objects) {
+    threads.emplace_back([&js_object, &js_number] {
+      js_object.SetProperty("number", js_number);
+      static_cast<void>(static_cast<double>(js_number));
+      static_cast<void>(static_cast<std::string>(js_number));
+    });
+  }
+  
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  
+#ifdef HAL_PERFORMANCE_COUNTER_ENABLE
+  // Only one thread's JSValueRef was kept.
+  XCTAssertEqual(js_value_refs_retained + 1, detail::JSPerformanceCounter<JSValue>::get_refs_retained());
+#endif
+  
+  for (const auto& js_object : js_objects) {
+    XCTAssertTrue(js_object.GetProperty("number") == js_number);
+  }
+}